@@ -0,0 +1,319 @@
+#include "MatchingEngine.h"
+#include "OrderBook.h"
+#include "OrderMessage.h"
+#include "TradeSink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Matching engine micro-benchmark. Each scenario builds a seeded workload up
+// front, optionally preloads the book, then times every instruction through
+// MatchingEngine::processMessage. Results are printed as a table and can be
+// written as JSON for comparison between commits.
+
+namespace {
+
+struct Workload {
+    std::vector<OrderMessage> preload;   // Applied before timing starts
+    std::vector<OrderMessage> measured;  // Timed one by one
+};
+
+struct Result {
+    std::string name;
+    size_t orders;
+    uint64_t trades;
+    double seconds;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+Price randomPrice(std::mt19937_64& rng, double low, double high) {
+    std::uniform_int_distribution<int64_t> ticks(std::llround(low * 100), std::llround(high * 100));
+    return Price::fromRaw(ticks(rng) * 100);
+}
+
+uint64_t randomQuantity(std::mt19937_64& rng, uint64_t low, uint64_t high) {
+    return std::uniform_int_distribution<uint64_t>(low, high)(rng);
+}
+
+// Non-crossing limit orders on both sides of 100.00
+Workload passiveAdd(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Workload workload;
+    for (uint64_t id = 1; id <= count; ++id) {
+        bool buy = id % 2 == 0;
+        Price price = buy ? randomPrice(rng, 90.00, 99.99) : randomPrice(rng, 100.01, 110.00);
+        workload.measured.push_back(OrderMessage::newOrder(
+            Order(id, buy ? OrderSide::Buy : OrderSide::Sell, price, randomQuantity(rng, 1, 100))));
+    }
+    return workload;
+}
+
+// Rounds of a few resting asks followed by one buy that sweeps them all
+Workload aggressiveSweep(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Workload workload;
+    uint64_t id = 1;
+    while (workload.measured.size() < count) {
+        uint64_t total = 0;
+        for (int i = 0; i < 8; ++i) {
+            uint64_t quantity = randomQuantity(rng, 1, 100);
+            total += quantity;
+            workload.measured.push_back(OrderMessage::newOrder(
+                Order(id++, OrderSide::Sell, randomPrice(rng, 100.00, 100.20), quantity)));
+        }
+        workload.measured.push_back(OrderMessage::newOrder(
+            Order(id++, OrderSide::Buy, Price::fromDouble(100.20), total)));
+    }
+    workload.measured.erase(workload.measured.begin() + count, workload.measured.end());
+    return workload;
+}
+
+// Long FIFO queues on a handful of levels, hit by small aggressive orders
+// that are replenished at the back
+Workload deepBook(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Workload workload;
+    uint64_t id = 1;
+    for (int level = 0; level < 10; ++level) {
+        for (int i = 0; i < 10000; ++i) {
+            workload.preload.push_back(OrderMessage::newOrder(
+                Order(id++, OrderSide::Sell, Price::fromDouble(100.00 + level * 0.01), 10)));
+            workload.preload.push_back(OrderMessage::newOrder(
+                Order(id++, OrderSide::Buy, Price::fromDouble(99.99 - level * 0.01), 10)));
+        }
+    }
+    while (workload.measured.size() < count) {
+        bool buy = rng() % 2 == 0;
+        uint64_t quantity = randomQuantity(rng, 1, 30);
+        Price top = buy ? Price::fromDouble(100.00) : Price::fromDouble(99.99);
+        workload.measured.push_back(OrderMessage::newOrder(
+            Order(id++, buy ? OrderSide::Buy : OrderSide::Sell, top, quantity)));
+        workload.measured.push_back(OrderMessage::newOrder(
+            Order(id++, buy ? OrderSide::Sell : OrderSide::Buy, top, quantity)));
+    }
+    workload.measured.erase(workload.measured.begin() + count, workload.measured.end());
+    return workload;
+}
+
+// Adds interleaved with cancels of random live orders, as market makers do
+Workload cancelHeavy(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Workload workload;
+    std::vector<uint64_t> live;
+    uint64_t id = 1;
+    while (workload.measured.size() < count) {
+        if (live.size() < 1000 || rng() % 10 == 0) {
+            bool buy = rng() % 2 == 0;
+            Price price = buy ? randomPrice(rng, 99.50, 99.99) : randomPrice(rng, 100.01, 100.50);
+            workload.measured.push_back(OrderMessage::newOrder(
+                Order(id, buy ? OrderSide::Buy : OrderSide::Sell, price, randomQuantity(rng, 1, 100))));
+            live.push_back(id++);
+        } else {
+            size_t pick = rng() % live.size();
+            workload.measured.push_back(OrderMessage::cancel(live[pick]));
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+    return workload;
+}
+
+// Sparse orders scattered across the whole price band, so best-price
+// discovery has to skip runs of empty levels whenever a level empties
+Workload manyLevels(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Workload workload;
+    uint64_t id = 1;
+    for (int i = 0; i < 5000; ++i) {
+        workload.preload.push_back(OrderMessage::newOrder(
+            Order(id++, OrderSide::Sell, randomPrice(rng, 500.01, 1000.00), randomQuantity(rng, 1, 100))));
+        workload.preload.push_back(OrderMessage::newOrder(
+            Order(id++, OrderSide::Buy, randomPrice(rng, 0.01, 500.00), randomQuantity(rng, 1, 100))));
+    }
+    while (workload.measured.size() < count) {
+        bool buy = rng() % 2 == 0;
+        if (rng() % 4 == 0) {
+            // Aggressive order that empties the top few levels
+            workload.measured.push_back(OrderMessage::newOrder(
+                Order(id++, buy ? OrderSide::Buy : OrderSide::Sell,
+                      buy ? Price::fromDouble(1000.00) : Price::fromDouble(0.01), 100)));
+        } else {
+            Price price = buy ? randomPrice(rng, 0.01, 500.00) : randomPrice(rng, 500.01, 1000.00);
+            workload.measured.push_back(OrderMessage::newOrder(
+                Order(id++, buy ? OrderSide::Buy : OrderSide::Sell, price, randomQuantity(rng, 1, 100))));
+        }
+    }
+    return workload;
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+Result run(const std::string& name, const Workload& workload) {
+    size_t capacity = workload.preload.size() + workload.measured.size();
+    OrderBook book(TickConfig(), std::max<size_t>(capacity, 1024));
+    MatchingEngine engine(book);
+    CountingTradeSink sink;    // Final, so the engine calls it directly
+
+    engine.processBatch(workload.preload.data(), workload.preload.size(), sink);
+    uint64_t preloadTrades = sink.getCount();
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(workload.measured.size());
+
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& message : workload.measured) {
+        auto start = std::chrono::steady_clock::now();
+        engine.processMessage(message, sink);
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    std::sort(latencies.begin(), latencies.end());
+
+    Result result;
+    result.name = name;
+    result.orders = workload.measured.size();
+    result.trades = sink.getCount() - preloadTrades;
+    result.seconds = std::chrono::duration<double>(finish - begin).count();
+    result.p50 = percentile(latencies, 0.50);
+    result.p99 = percentile(latencies, 0.99);
+    result.p999 = percentile(latencies, 0.999);
+    result.max = latencies.empty() ? 0 : latencies.back();
+    return result;
+}
+
+double ordersPerSecond(const Result& result) {
+    return result.seconds > 0 ? static_cast<double>(result.orders) / result.seconds : 0.0;
+}
+
+std::string toJson(const std::vector<Result>& results, size_t orders, uint64_t seed) {
+    std::ostringstream out;
+    out << "{\n  \"benchmark\": \"bench_matching\",\n"
+        << "  \"orders\": " << orders << ",\n"
+        << "  \"seed\": " << seed << ",\n"
+        << "  \"scenarios\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"orders\": " << r.orders
+            << ", \"trades\": " << r.trades
+            << ", \"seconds\": " << std::fixed << std::setprecision(6) << r.seconds
+            << ", \"orders_per_sec\": " << std::setprecision(0) << ordersPerSecond(r)
+            << ", \"latency_ns\": {\"p50\": " << r.p50
+            << ", \"p99\": " << r.p99
+            << ", \"p999\": " << r.p999
+            << ", \"max\": " << r.max << "}}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName
+              << " [--orders=<n>] [--seed=<n>] [--scenario=<name>] [--json=<file|->]" << std::endl;
+    std::cout << "Scenarios: passive_add, aggressive_sweep, deep_book, cancel_heavy, many_levels"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t orders = 200000;
+    uint64_t seed = 42;
+    std::string only;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.substr(0, 9) == "--orders=") {
+                orders = std::stoul(arg.substr(9));
+            } else if (arg.substr(0, 7) == "--seed=") {
+                seed = std::stoull(arg.substr(7));
+            } else if (arg.substr(0, 11) == "--scenario=") {
+                only = arg.substr(11);
+            } else if (arg.substr(0, 7) == "--json=") {
+                jsonPath = arg.substr(7);
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<std::pair<std::string, std::function<Workload(size_t, uint64_t)>>> scenarios = {
+        {"passive_add", passiveAdd},
+        {"aggressive_sweep", aggressiveSweep},
+        {"deep_book", deepBook},
+        {"cancel_heavy", cancelHeavy},
+        {"many_levels", manyLevels},
+    };
+
+    std::vector<Result> results;
+    for (const auto& scenario : scenarios) {
+        if (!only.empty() && scenario.first != only) {
+            continue;
+        }
+        results.push_back(run(scenario.first, scenario.second(orders, seed)));
+    }
+    if (results.empty()) {
+        std::cerr << "Unknown scenario: " << only << std::endl;
+        return 1;
+    }
+
+    if (jsonPath != "-") {
+        std::cout << std::left << std::setw(18) << "scenario" << std::right
+                  << std::setw(14) << "orders/sec" << std::setw(10) << "p50 ns"
+                  << std::setw(10) << "p99 ns" << std::setw(10) << "p99.9 ns"
+                  << std::setw(12) << "max ns" << std::endl;
+        for (const auto& r : results) {
+            std::cout << std::left << std::setw(18) << r.name << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(0) << ordersPerSecond(r)
+                      << std::setw(10) << r.p50 << std::setw(10) << r.p99
+                      << std::setw(10) << r.p999 << std::setw(12) << r.max << std::endl;
+        }
+    }
+
+    if (!jsonPath.empty()) {
+        std::string json = toJson(results, orders, seed);
+        if (jsonPath == "-") {
+            std::cout << json;
+        } else {
+            std::ofstream file(jsonPath);
+            if (!file) {
+                std::cerr << "Cannot write " << jsonPath << std::endl;
+                return 1;
+            }
+            file << json;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "BookDifferential.h"
+#include "MapOrderBook.h"
+#include "OrderBook.h"
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Differential check and speed comparison of book backends. Replays one
+// seeded instruction stream through the production OrderBook and the
+// std::map reference book, fails on the first event where their trades or
+// published depth differ, then times the same stream through each.
+
+namespace {
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [--orders=<n>] [--seed=<n>]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t orders = 200000;
+    uint64_t seed = 42;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.substr(0, 9) == "--orders=") {
+                orders = std::stoul(arg.substr(9));
+            } else if (arg.substr(0, 7) == "--seed=") {
+                seed = std::stoull(arg.substr(7));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<OrderMessage> events = generateDifferentialStream(orders, seed);
+    const size_t capacity = std::max<size_t>(orders, 1024);
+
+    {
+        OrderBook book(TickConfig(), capacity);
+        MapOrderBook reference;
+        DifferentialResult result = compareBooks(events, book, reference);
+        if (!result.matched) {
+            std::cerr << "MISMATCH at event " << result.mismatchEvent << ": " << result.mismatch
+                      << std::endl;
+            return 1;
+        }
+        std::cout << "Compared " << result.eventsCompared << " events and "
+                  << result.tradesCompared << " trades: books agree" << std::endl;
+    }
+
+    double fast;
+    double reference;
+    {
+        OrderBook book(TickConfig(), capacity);
+        fast = measureThroughput(events, book);
+    }
+    {
+        MapOrderBook book;
+        reference = measureThroughput(events, book);
+    }
+
+    std::cout << std::left << std::setw(16) << "backend" << std::right << std::setw(14)
+              << "orders/sec" << std::endl;
+    std::cout << std::left << std::setw(16) << "OrderBook" << std::right << std::setw(14)
+              << std::fixed << std::setprecision(0) << fast << std::endl;
+    std::cout << std::left << std::setw(16) << "MapOrderBook" << std::right << std::setw(14)
+              << reference << std::endl;
+    std::cout << "Speedup: " << std::setprecision(2) << (reference > 0 ? fast / reference : 0.0)
+              << "x" << std::endl;
+    return 0;
+}
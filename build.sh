@@ -6,14 +6,31 @@ echo "Building Limit Order Book Matching Engine..."
 echo ""
 
 # Compile main executable
-echo "[1/2] Building main executable..."
+echo "[1/3] Building main executable..."
 clang++ -std=c++17 -Iinclude -pthread \
   src/Order.cpp \
   src/OrderBook.cpp \
   src/MatchingEngine.cpp \
   src/OrderProducer.cpp \
   src/EngineWorker.cpp \
+  src/EngineShard.cpp \
+  src/OrderRouter.cpp \
+  src/SymbolDirectory.cpp \
+  src/OrderTextParser.cpp \
+  src/LineReader.cpp \
+  src/OrderGateway.cpp \
+  src/PreTradeRisk.cpp \
+  src/RiskStage.cpp \
+  src/OrderEventFile.cpp \
+  src/MappedFile.cpp \
+  src/Journal.cpp \
+  src/Recovery.cpp \
+  src/ThreadAffinity.cpp \
   src/ConsoleRenderer.cpp \
+  src/TradeTape.cpp \
+  src/LatencyHistogram.cpp \
+  src/MarketDataPublisher.cpp \
+  src/MarketDataSubscriber.cpp \
   main.cpp \
   -o limit_order_book
 
@@ -27,12 +44,33 @@ fi
 echo ""
 
 # Compile test executable
-echo "[2/2] Building test executable..."
+echo "[2/3] Building test executable..."
 clang++ -std=c++17 -Iinclude -pthread \
   tests/simple_tests.cpp \
+  src/OrderProducer.cpp \
   src/Order.cpp \
   src/OrderBook.cpp \
   src/MatchingEngine.cpp \
+  src/TradeTape.cpp \
+  src/LatencyHistogram.cpp \
+  src/MarketDataPublisher.cpp \
+  src/MarketDataSubscriber.cpp \
+  src/EngineWorker.cpp \
+  src/EngineShard.cpp \
+  src/OrderRouter.cpp \
+  src/SymbolDirectory.cpp \
+  src/OrderTextParser.cpp \
+  src/LineReader.cpp \
+  src/OrderGateway.cpp \
+  src/PreTradeRisk.cpp \
+  src/RiskStage.cpp \
+  src/OrderEventFile.cpp \
+  src/MappedFile.cpp \
+  src/Journal.cpp \
+  src/Recovery.cpp \
+  src/ThreadAffinity.cpp \
+  src/AllocationCounter.cpp \
+  src/BookDifferential.cpp \
   -o test_order_book
 
 if [ $? -eq 0 ]; then
@@ -42,6 +80,84 @@ else
     exit 1
 fi
 
+echo ""
+
+# Compile tools
+echo "[3/3] Building tools..."
+clang++ -std=c++17 -Iinclude -pthread \
+  tools/tape_decode.cpp \
+  src/TradeTape.cpp \
+  src/LatencyHistogram.cpp \
+  -o tape_decode
+
+if [ $? -eq 0 ]; then
+    echo "✓ Trade tape decoder built successfully: tape_decode"
+else
+    echo "✗ Failed to build trade tape decoder"
+    exit 1
+fi
+
+clang++ -std=c++17 -Iinclude \
+  tools/order_convert.cpp \
+  src/Order.cpp \
+  src/SymbolDirectory.cpp \
+  src/OrderTextParser.cpp \
+  src/LineReader.cpp \
+  src/OrderEventFile.cpp \
+  src/MappedFile.cpp \
+  -o order_convert
+
+if [ $? -eq 0 ]; then
+    echo "✓ Order event converter built successfully: order_convert"
+else
+    echo "✗ Failed to build order event converter"
+    exit 1
+fi
+
+clang++ -std=c++17 -O2 -Iinclude -pthread \
+  tools/gateway_client.cpp \
+  src/OrderGateway.cpp \
+  src/Order.cpp \
+  src/SymbolDirectory.cpp \
+  src/LatencyHistogram.cpp \
+  -o gateway_client
+
+if [ $? -eq 0 ]; then
+    echo "✓ Gateway load client built successfully: gateway_client"
+else
+    echo "✗ Failed to build gateway load client"
+    exit 1
+fi
+
+clang++ -std=c++17 -O2 -Iinclude -pthread \
+  bench/bench_matching.cpp \
+  src/Order.cpp \
+  src/OrderBook.cpp \
+  src/MatchingEngine.cpp \
+  -o bench_matching
+
+if [ $? -eq 0 ]; then
+    echo "✓ Matching benchmark built successfully: bench_matching"
+else
+    echo "✗ Failed to build matching benchmark"
+    exit 1
+fi
+
+clang++ -std=c++17 -O2 -Iinclude -pthread \
+  bench/book_diff.cpp \
+  src/BookDifferential.cpp \
+  src/Order.cpp \
+  src/OrderBook.cpp \
+  src/MatchingEngine.cpp \
+  -o book_diff
+
+if [ $? -eq 0 ]; then
+    echo "✓ Book differential harness built successfully: book_diff"
+else
+    echo "✗ Failed to build book differential harness"
+    exit 1
+fi
+
 echo ""
 echo "Build complete!"
 echo ""
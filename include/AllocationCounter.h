@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+// Debug instrumentation: when src/AllocationCounter.cpp is linked into a
+// binary it replaces the global operator new/delete and counts every heap
+// allocation, so tests and benchmarks can prove a code path allocates
+// nothing. Binaries that do not link it pay no cost.
+
+// Number of global operator new calls since process start
+uint64_t allocationCount();
+
+#endif // ALLOCATIONCOUNTER_H
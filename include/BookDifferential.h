@@ -0,0 +1,132 @@
+#ifndef BOOKDIFFERENTIAL_H
+#define BOOKDIFFERENTIAL_H
+
+#include "BookSnapshot.h"
+#include "MatchingEngine.h"
+#include "OrderMessage.h"
+#include "Trade.h"
+#include "TradeSink.h"
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Seeded random instruction stream for comparing book backends: GTC, IOC
+// and FOK limit orders and market orders clustered around 100.00 so most
+// of them cross, plus cancels and modifies (reduce, reprice, increase and
+// zero) of earlier ids, some already gone. A few orders carry off-tick
+// prices or reuse a live id, to exercise the rejection paths.
+std::vector<OrderMessage> generateDifferentialStream(size_t count, uint64_t seed);
+
+// Outcome of running one stream through two backends
+struct DifferentialResult {
+    size_t eventsCompared = 0;
+    uint64_t tradesCompared = 0;
+    bool matched = true;
+    size_t mismatchEvent = 0;    // Index of the first diverging event
+    std::string mismatch;        // What diverged, empty if matched
+};
+
+namespace detail {
+
+inline bool sameTrade(const Trade& a, const Trade& b) {
+    return a.buyOrderId == b.buyOrderId && a.sellOrderId == b.sellOrderId &&
+           a.price == b.price && a.quantity == b.quantity && a.symbol == b.symbol;
+}
+
+inline bool sameLevels(const LevelSummary* a, const LevelSummary* b, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (a[i].price != b[i].price || a[i].totalQuantity != b[i].totalQuantity ||
+            a[i].orderCount != b[i].orderCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Describe the first difference between two event outcomes, or return an
+// empty string if they agree
+inline std::string describeMismatch(const std::vector<Trade>& tradesA, const std::vector<Trade>& tradesB,
+                                    const BookSnapshot& a, const BookSnapshot& b) {
+    std::ostringstream out;
+    if (tradesA.size() != tradesB.size()) {
+        out << "trade count " << tradesA.size() << " vs " << tradesB.size();
+        return out.str();
+    }
+    for (size_t i = 0; i < tradesA.size(); ++i) {
+        if (!sameTrade(tradesA[i], tradesB[i])) {
+            out << "trade " << i << ": " << tradesA[i].buyOrderId << "/" << tradesA[i].sellOrderId
+                << " " << tradesA[i].quantity << "@" << tradesA[i].price << " vs "
+                << tradesB[i].buyOrderId << "/" << tradesB[i].sellOrderId << " "
+                << tradesB[i].quantity << "@" << tradesB[i].price;
+            return out.str();
+        }
+    }
+    if (a.restingOrders != b.restingOrders) {
+        out << "resting orders " << a.restingOrders << " vs " << b.restingOrders;
+        return out.str();
+    }
+    if (a.bidLevels != b.bidLevels || !sameLevels(a.bids, b.bids, a.bidLevels)) {
+        out << "bid depth differs";
+        return out.str();
+    }
+    if (a.askLevels != b.askLevels || !sameLevels(a.asks, b.asks, a.askLevels)) {
+        out << "ask depth differs";
+        return out.str();
+    }
+    return std::string();
+}
+
+} // namespace detail
+
+// Feed every instruction to an engine over each book and compare, after
+// each one, the trades it produced and the published top-of-book depth and
+// resting order count. Stops at the first divergence. Both books must start
+// empty.
+template<typename BookA, typename BookB>
+DifferentialResult compareBooks(const std::vector<OrderMessage>& events, BookA& bookA, BookB& bookB) {
+    BasicMatchingEngine<BookA> engineA(bookA);
+    BasicMatchingEngine<BookB> engineB(bookB);
+    std::vector<Trade> tradesA;
+    std::vector<Trade> tradesB;
+    TradeCollector collectorA(tradesA);
+    TradeCollector collectorB(tradesB);
+
+    DifferentialResult result;
+    for (size_t i = 0; i < events.size(); ++i) {
+        tradesA.clear();
+        tradesB.clear();
+        engineA.processMessage(events[i], collectorA);
+        engineB.processMessage(events[i], collectorB);
+
+        std::string mismatch = detail::describeMismatch(tradesA, tradesB, engineA.getSnapshot(),
+                                                        engineB.getSnapshot());
+        result.eventsCompared = i + 1;
+        result.tradesCompared += tradesA.size();
+        if (!mismatch.empty()) {
+            result.matched = false;
+            result.mismatchEvent = i;
+            result.mismatch = mismatch;
+            break;
+        }
+    }
+    return result;
+}
+
+// Run a stream through an engine over book, one instruction at a time as
+// the engine thread would, and return instructions per second
+template<typename Book>
+double measureThroughput(const std::vector<OrderMessage>& events, Book& book) {
+    BasicMatchingEngine<Book> engine(book);
+    CountingTradeSink sink;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& message : events) {
+        engine.processMessage(message, sink);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return seconds > 0 ? static_cast<double>(events.size()) / seconds : 0.0;
+}
+
+#endif // BOOKDIFFERENTIAL_H
@@ -0,0 +1,34 @@
+#ifndef BOOKSNAPSHOT_H
+#define BOOKSNAPSHOT_H
+
+#include "Price.h"
+#include <cstddef>
+#include <cstdint>
+
+// Aggregate view of one price level: no individual orders
+struct LevelSummary {
+    Price price;
+    uint64_t totalQuantity;
+    uint64_t orderCount;
+};
+
+// Market data view of one book published by the engine after each batch.
+// Plain data, so it can be copied through a SeqLock without locking.
+struct BookSnapshot {
+    static constexpr size_t kDepth = 10;
+
+    LevelSummary bids[kDepth];     // Best first
+    LevelSummary asks[kDepth];     // Best first
+    uint32_t bidLevels = 0;        // Valid entries in bids
+    uint32_t askLevels = 0;        // Valid entries in asks
+
+    bool hasLastTrade = false;
+    Price lastTradePrice;
+    uint64_t lastTradeQuantity = 0;
+
+    uint64_t tradeCount = 0;       // Fills executed since start
+    uint64_t messagesProcessed = 0; // Instructions handled since start
+    uint64_t restingOrders = 0;    // Orders currently in the book
+};
+
+#endif // BOOKSNAPSHOT_H
@@ -0,0 +1,78 @@
+#ifndef CONCURRENTQUEUE_H
+#define CONCURRENTQUEUE_H
+
+#include "WaitStrategy.h"
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// Write end of a pipeline stage: anything producers can push into, whether
+// a queue or a router that fans out to several queues.
+template<typename T>
+class QueueWriter {
+public:
+    virtual ~QueueWriter() = default;
+
+    // Push an item (blocks while a bounded queue is full)
+    virtual void push(const T& item) = 0;
+
+    // Push count items in order. Queues override this to publish the whole
+    // batch with one synchronisation step instead of one per item.
+    virtual void pushBatch(const T* items, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            push(items[i]);
+        }
+    }
+
+    // Push a prefix of count items in order without waiting and return its
+    // length. Bounded queues stop at the first item that does not fit; the
+    // default, for writers that never fill up, pushes everything.
+    virtual size_t tryPushBatch(const T* items, size_t count) {
+        pushBatch(items, count);
+        return count;
+    }
+};
+
+// Common interface of the queues that connect pipeline threads, so the
+// producer, engine and renderer do not depend on a particular implementation.
+template<typename T>
+class ConcurrentQueue : public QueueWriter<T> {
+public:
+    // Pop an item from the queue (blocking). Must not be called once the
+    // queue is closed and drained.
+    virtual T pop() = 0;
+
+    // Try to pop an item (non-blocking)
+    virtual std::optional<T> tryPop() = 0;
+
+    // Wait until at least one item is available, then append up to
+    // maxItems queued items to out. Returns the number appended, which is 0
+    // only once the queue is closed and drained.
+    virtual size_t popBatch(std::vector<T>& out, size_t maxItems) = 0;
+
+    // popBatch() that gives up after timeout, returning 0 if nothing
+    // arrived, so a consumer can do other work while its input is idle
+    virtual size_t popBatchFor(std::vector<T>& out, size_t maxItems,
+                               std::chrono::nanoseconds timeout) = 0;
+
+    // How the consumer waits while the queue is empty. Set before the
+    // consumer starts.
+    virtual void setWaitStrategy(WaitStrategy strategy) = 0;
+    virtual WaitStrategy getWaitStrategy() const = 0;
+
+    // End of input: producers have stopped pushing. Wakes a waiting
+    // consumer, whose popBatch() returns 0 once the queued items are gone.
+    virtual void close() = 0;
+
+    // Whether close() has been called
+    virtual bool isClosed() const = 0;
+
+    // Get the current size of the queue
+    virtual size_t size() const = 0;
+
+    // Check if the queue is empty
+    virtual bool empty() const = 0;
+};
+
+#endif // CONCURRENTQUEUE_H
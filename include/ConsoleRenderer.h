@@ -1,16 +1,20 @@
 #ifndef CONSOLERENDERER_H
 #define CONSOLERENDERER_H
 
-#include "OrderBook.h"
+#include "BookSnapshot.h"
 #include "MatchingEngine.h"
-#include "ThreadSafeQueue.h"
+#include "OrderRouter.h"
 #include "Order.h"
+#include "OrderMessage.h"
 #include <atomic>
+#include <string>
 
 class ConsoleRenderer {
 public:
-    ConsoleRenderer(OrderBook& orderBook, MatchingEngine& engine,
-                   ThreadSafeQueue<Order>& queue);
+    // Displays one symbol's book from the engine's published snapshot, so
+    // rendering never takes the book lock. The pending count covers all shards.
+    ConsoleRenderer(const MatchingEngine& engine, const OrderRouter& router,
+                   const std::string& symbolName);
 
     // Run the renderer thread
     void run();
@@ -19,9 +23,9 @@ public:
     void stop();
 
 private:
-    OrderBook& orderBook_;
-    MatchingEngine& engine_;
-    ThreadSafeQueue<Order>& queue_;
+    const MatchingEngine& engine_;
+    const OrderRouter& router_;
+    std::string symbolName_;
     std::atomic<bool> running_;
 
     // Clear the console screen
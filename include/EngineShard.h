@@ -0,0 +1,85 @@
+#ifndef ENGINESHARD_H
+#define ENGINESHARD_H
+
+#include "ConcurrentQueue.h"
+#include "EngineWorker.h"
+#include "MarketData.h"
+#include "MatchingEngine.h"
+#include "OrderBook.h"
+#include "OrderMessage.h"
+#include "Recovery.h"
+#include "SymbolDirectory.h"
+#include "TradeSink.h"
+#include "WaitStrategy.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+enum class QueueKind {
+    Mutex,
+    Spsc
+};
+
+// One engine thread together with the books it exclusively owns and its own
+// inbound queue. Shards share nothing, so instruments on different shards
+// never contend on a lock.
+class EngineShard {
+public:
+    EngineShard(const SymbolDirectory& directory, const std::vector<SymbolId>& symbols,
+                QueueKind queueKind, TradeSink& tradeSink,
+                size_t maxBatchSize = EngineWorker::kDefaultMaxBatchSize);
+    ~EngineShard();
+
+    EngineShard(const EngineShard&) = delete;
+    EngineShard& operator=(const EngineShard&) = delete;
+
+    // Inbound queue; the router is its only producer
+    ConcurrentQueue<OrderMessage>& getQueue() { return *queue_; }
+
+    // Book and engine of an owned symbol, or nullptr
+    OrderBook* getBook(SymbolId symbol) const;
+    MatchingEngine* getEngine(SymbolId symbol) const;
+
+    const std::vector<SymbolId>& getSymbols() const { return symbols_; }
+
+    // Send level changes and trades of every owned book to a market data
+    // sink. Call before start(); the sink sees a single producer thread.
+    void setMarketDataSink(MarketDataSink* sink);
+
+    // Record per-stage latency of this shard's engine thread. Call before start().
+    void setLatency(PipelineLatency* latency) { worker_->setLatency(latency); }
+
+    // Journal accepted instructions and snapshot the books every
+    // snapshotInterval instructions (snapshotter may be nullptr). Call
+    // before start().
+    void setPersistence(Journal* journal, Snapshotter* snapshotter, uint64_t snapshotInterval) {
+        worker_->setPersistence(journal, snapshotter, snapshotInterval);
+    }
+
+    // Rebuild the owned books from a snapshot plus journal tail and let the
+    // engine thread continue from there. Call before start().
+    RecoveryResult recover(const std::string& snapshotPath, const std::string& journalPath);
+
+    // How the engine thread waits on an empty queue. Call before start().
+    void setWaitStrategy(WaitStrategy strategy) { queue_->setWaitStrategy(strategy); }
+
+    // Launch the engine thread, pinned to the given core when core >= 0
+    void start(int core = -1);
+
+    // Close the queue, let the engine thread match what is left in it, and
+    // join it. Producers must have stopped pushing.
+    void stop();
+
+private:
+    std::vector<SymbolId> symbols_;
+    std::unique_ptr<ConcurrentQueue<OrderMessage>> queue_;
+
+    // Indexed by SymbolId; null for symbols owned by other shards
+    std::vector<std::unique_ptr<OrderBook>> books_;
+    std::vector<std::unique_ptr<MatchingEngine>> engines_;
+
+    std::unique_ptr<EngineWorker> worker_;
+    std::thread thread_;
+};
+
+#endif // ENGINESHARD_H
@@ -1,25 +1,71 @@
 #ifndef ENGINEWORKER_H
 #define ENGINEWORKER_H
 
-#include "ThreadSafeQueue.h"
+#include "ConcurrentQueue.h"
+#include "Journal.h"
+#include "LatencyHistogram.h"
 #include "Order.h"
+#include "OrderMessage.h"
 #include "MatchingEngine.h"
-#include <atomic>
+#include "Recovery.h"
+#include "TradeSink.h"
+#include <vector>
 
 class EngineWorker {
 public:
-    EngineWorker(ThreadSafeQueue<Order>& queue, MatchingEngine& engine);
+    static constexpr size_t kDefaultMaxBatchSize = 256;
 
-    // Run the engine worker thread
+    // enginesBySymbol maps each SymbolId to the engine that owns its book, or
+    // nullptr for symbols this worker does not own (such messages are dropped).
+    // Executed trades are reported to tradeSink on the engine thread.
+    // maxBatchSize caps how many queued instructions are drained and matched
+    // per wakeup: larger batches favour throughput, smaller ones latency.
+    EngineWorker(ConcurrentQueue<OrderMessage>& queue,
+                 const std::vector<MatchingEngine*>& enginesBySymbol,
+                 TradeSink& tradeSink, size_t maxBatchSize = kDefaultMaxBatchSize);
+
+    // Run the engine worker thread until the queue is closed and drained
     void run();
 
-    // Stop the worker
+    // Close the queue so run() returns once it has matched what is queued.
+    // Producers must have stopped pushing.
     void stop();
 
+    // Record queue wait and matching latency of every message (nullptr
+    // disables). Set before run().
+    void setLatency(PipelineLatency* latency) { latency_ = latency; }
+
+    // Journal every instruction before it is matched and, once at least
+    // snapshotInterval instructions have been journaled since the last
+    // snapshot, hand a capture of the books to the snapshotter (nullptr
+    // disables snapshots). Set before run().
+    void setPersistence(Journal* journal, Snapshotter* snapshotter, uint64_t snapshotInterval);
+
+    // Continue from recovered state: the journal position of the loaded
+    // snapshot and the first unused order id. Call before run().
+    void resumeFrom(uint64_t snapshotSequence, uint64_t nextOrderId);
+
 private:
-    ThreadSafeQueue<Order>& queue_;
-    MatchingEngine& engine_;
-    std::atomic<bool> running_;
+    ConcurrentQueue<OrderMessage>& queue_;
+    std::vector<MatchingEngine*> engines_;
+    TradeSink& tradeSink_;
+    size_t maxBatchSize_;
+    PipelineLatency* latency_;
+    Journal* journal_;
+    Snapshotter* snapshotter_;
+    uint64_t snapshotInterval_;
+    uint64_t lastSnapshotSequence_;
+    uint64_t nextOrderId_;
+
+    // Reused across batches so steady-state draining does not allocate
+    std::vector<OrderMessage> batch_;
+
+    MatchingEngine* engineFor(SymbolId symbol) const {
+        return symbol < engines_.size() ? engines_[symbol] : nullptr;
+    }
+
+    // Capture every owned book and submit it to the snapshotter
+    void takeSnapshot();
 };
 
 #endif // ENGINEWORKER_H
@@ -0,0 +1,145 @@
+#ifndef GATEWAYPROTOCOL_H
+#define GATEWAYPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Binary order-entry protocol spoken on the gateway's Unix domain socket.
+// Every message is a packed little-endian struct that starts with a
+// WireHeader whose length covers the whole message, so a stream can be cut
+// into messages without looking at the body. Clients send NewOrder, Cancel
+// and Modify; the gateway answers each with an Ack or a Reject and reports
+// executions of the client's orders as Fills. With pre-trade risk enabled
+// the answer is sent once risk has decided, and always before the order's
+// first Fill.
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Wire structs are used as-is and assume a little-endian host");
+
+enum class WireType : uint8_t {
+    NewOrder = 1,
+    Cancel = 2,
+    Modify = 3,
+    Ack = 101,
+    Fill = 102,
+    Reject = 103
+};
+
+enum class RejectReason : uint8_t {
+    Malformed = 1,      // Unknown type or wrong length; the connection is closed
+    UnknownSymbol = 2,
+    InvalidPrice = 3,   // Off the tick grid or outside the price band
+    InvalidQuantity = 4, // Zero, or above Order::kMaxQuantity
+    InvalidType = 5,    // Bad side, order type or time in force
+    UnknownOrder = 6,   // Not a live order id of this connection
+    RiskLimit = 7       // Refused by pre-trade risk; WireReject::riskReason says why
+};
+
+#pragma pack(push, 1)
+
+struct WireHeader {
+    uint16_t length;        // Bytes in the whole message
+    uint8_t type;           // WireType
+    uint8_t reserved;
+};
+
+// Client -> gateway
+struct WireNewOrder {
+    WireHeader header;
+    uint64_t clientOrderId; // Echoed in the Ack or Reject
+    int64_t priceRaw;       // Price::raw(); ignored for market orders
+    uint64_t quantity;
+    uint32_t symbol;        // SymbolId, in the order the engine registered them
+    uint8_t side;           // OrderSide
+    uint8_t orderType;      // OrderType
+    uint8_t timeInForce;    // TimeInForce
+    uint8_t reserved;
+};
+
+struct WireCancel {
+    WireHeader header;
+    uint64_t clientOrderId;
+    uint64_t orderId;       // Engine id from the order's Ack
+    uint32_t symbol;
+};
+
+struct WireModify {
+    WireHeader header;
+    uint64_t clientOrderId;
+    uint64_t orderId;       // Engine id from the order's Ack
+    int64_t priceRaw;
+    uint64_t quantity;      // Zero cancels
+    uint32_t symbol;
+};
+
+// Gateway -> client
+struct WireAck {
+    WireHeader header;
+    uint64_t clientOrderId;
+    uint64_t orderId;       // Engine id, used by Cancel, Modify and Fill
+};
+
+struct WireFill {
+    WireHeader header;
+    uint64_t orderId;
+    int64_t priceRaw;
+    uint64_t quantity;
+    uint32_t symbol;
+    uint8_t side;           // Side of the reported order
+    uint8_t reserved[3];
+};
+
+struct WireReject {
+    WireHeader header;
+    uint64_t clientOrderId;
+    uint8_t reason;         // RejectReason
+    uint8_t riskReason;     // RiskReject for RejectReason::RiskLimit, otherwise 0
+    uint8_t reserved[2];
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(WireHeader) == 4, "WireHeader layout is part of the protocol");
+static_assert(sizeof(WireNewOrder) == 36, "WireNewOrder layout is part of the protocol");
+static_assert(sizeof(WireCancel) == 24, "WireCancel layout is part of the protocol");
+static_assert(sizeof(WireModify) == 40, "WireModify layout is part of the protocol");
+static_assert(sizeof(WireAck) == 20, "WireAck layout is part of the protocol");
+static_assert(sizeof(WireFill) == 36, "WireFill layout is part of the protocol");
+static_assert(sizeof(WireReject) == 16, "WireReject layout is part of the protocol");
+
+// Zeroed message of the given type with its header filled in
+template<typename T>
+T makeWireMessage(WireType type) {
+    static_assert(std::is_trivially_copyable<T>::value, "wire messages are copied raw");
+    T message;
+    std::memset(&message, 0, sizeof(message));
+    message.header.length = sizeof(T);
+    message.header.type = static_cast<uint8_t>(type);
+    return message;
+}
+
+// View the message starting at data, which must hold at least sizeof(T)
+// bytes. The load compiles to plain unaligned reads of the receive buffer.
+template<typename T>
+T readWireMessage(const char* data) {
+    T message;
+    std::memcpy(&message, data, sizeof(T));
+    return message;
+}
+
+// Expected length of a message type, or 0 if the type is unknown
+inline size_t wireLength(WireType type) {
+    switch (type) {
+    case WireType::NewOrder: return sizeof(WireNewOrder);
+    case WireType::Cancel: return sizeof(WireCancel);
+    case WireType::Modify: return sizeof(WireModify);
+    case WireType::Ack: return sizeof(WireAck);
+    case WireType::Fill: return sizeof(WireFill);
+    case WireType::Reject: return sizeof(WireReject);
+    }
+    return 0;
+}
+
+#endif // GATEWAYPROTOCOL_H
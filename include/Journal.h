@@ -0,0 +1,95 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "OrderEventFile.h"
+#include "OrderMessage.h"
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// One journaled input event. Every record carries its sequence; sequences
+// start at 1 and increase by one from record to record, which readers check
+// rather than assume.
+struct JournalRecord {
+    uint64_t sequence;
+    OrderEventRecord event;
+};
+
+static_assert(std::is_trivially_copyable<JournalRecord>::value, "JournalRecord is written raw");
+static_assert(sizeof(JournalRecord) == 48, "JournalRecord layout is part of the journal format");
+
+// Sequenced write-ahead journal of every instruction an engine thread
+// accepts. append() only pushes to a lock-free ring; a writer thread
+// group-commits whatever has accumulated with one write and one fdatasync,
+// so the matching thread never waits for the disk. A crash can lose at most
+// the group that was not yet synced. If a write or sync fails the journal
+// stops writing for good: the durable sequence stays at the last committed
+// group and hasFailed() turns true.
+class Journal {
+public:
+    // Opens path for appending. An existing journal is continued after the
+    // sequence of its last complete record (a torn trailing record is
+    // discarded).
+    explicit Journal(const std::string& path, size_t ringCapacity = 1 << 16);
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Whether the journal file was opened and validated (and, for a new
+    // file, its header written)
+    bool isOpen() const { return file_ != nullptr; }
+
+    // Start the writer thread
+    void start();
+
+    // Commit remaining records and join the writer thread
+    void stop();
+
+    // Assign the next sequence to an instruction and queue it (engine thread)
+    uint64_t append(const OrderMessage& message);
+
+    // Sequence of the last appended instruction (engine thread)
+    uint64_t getSequence() const { return sequence_; }
+
+    // Sequence of the last record known to be on disk
+    uint64_t getDurableSequence() const { return durable_.load(std::memory_order_acquire); }
+
+    // Whether a write or sync has failed; nothing after the durable
+    // sequence will ever be stored
+    bool hasFailed() const { return failed_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t kWriteBufferSize = 1 << 20;
+
+    std::FILE* file_;
+    SpscRingBuffer<JournalRecord> ring_;
+    std::vector<char> buffer_;
+    std::thread writer_;
+    std::atomic<bool> running_;
+    uint64_t sequence_;
+    std::atomic<uint64_t> durable_;
+    std::atomic<bool> failed_;
+
+    // Writer thread body
+    void writeLoop();
+
+    // Write and sync one group of records. Returns the number taken off the
+    // ring, committed or not.
+    size_t commitGroup();
+};
+
+// Map a journal file and report every record with a sequence greater than
+// afterSequence, and the sequence of its last record in lastSequence (0 for
+// an empty journal) if given. Returns false if the file exists but is not a
+// journal or its sequences are not contiguous; a missing file is an empty
+// journal.
+bool readJournal(const std::string& path, uint64_t afterSequence,
+                 std::vector<JournalRecord>& records, uint64_t* lastSequence = nullptr);
+
+#endif // JOURNAL_H
@@ -0,0 +1,93 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Fixed-bucket log-linear latency histogram in nanoseconds. Every power of
+// two is split into 16 linear sub-buckets, so any recorded value is known
+// to within about 6% across the whole uint64_t range, with no allocation
+// and no configuration. record() is lock-free and safe from any number of
+// threads; readers see a slightly stale but consistent-enough view.
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Record one sample
+    void record(uint64_t nanos) {
+        buckets_[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(nanos, std::memory_order_relaxed);
+
+        uint64_t currentMax = max_.load(std::memory_order_relaxed);
+        while (nanos > currentMax &&
+               !max_.compare_exchange_weak(currentMax, nanos, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Record the time elapsed between two steady_clock points (0 if negative)
+    void record(std::chrono::steady_clock::time_point from,
+                std::chrono::steady_clock::time_point to) {
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+        record(nanos > 0 ? static_cast<uint64_t>(nanos) : 0);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    double mean() const;
+
+    // Smallest bucket bound at or below which the given fraction (0..1) of
+    // samples fall. Never exceeds max().
+    uint64_t percentile(double fraction) const;
+
+    // Clear all samples. Not atomic with respect to concurrent record().
+    void reset();
+
+    // Print count, mean, p50/p90/p99/p99.9 and max on one line
+    void dump(std::ostream& out, const std::string& name) const;
+
+    // Bucket holding a value
+    static size_t bucketFor(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        size_t msb = 63 - static_cast<size_t>(__builtin_clzll(value));
+        size_t shift = msb - kSubBucketBits;
+        return (shift + 1) * kSubBuckets + static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+    }
+
+    // Largest value that falls into a bucket
+    static uint64_t bucketUpperBound(size_t bucket);
+
+private:
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+// Latency of each hop of the order pipeline. Histograms are shared by all
+// engine threads and trade tapes that report into them.
+struct PipelineLatency {
+    LatencyHistogram queueWait;     // Ingest stamp -> engine dequeue
+    LatencyHistogram matching;      // Engine dequeue -> batch match complete
+    LatencyHistogram tradePublish;  // Trade execution -> taken by the tape writer
+
+    // Print every stage
+    void dump(std::ostream& out) const;
+};
+
+#endif // LATENCYHISTOGRAM_H
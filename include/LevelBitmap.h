@@ -0,0 +1,152 @@
+#ifndef LEVELBITMAP_H
+#define LEVELBITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical occupancy bitmap over price level indices. Layer 0 has one
+// bit per level; each bit of layer k+1 says whether the matching 64-bit
+// word of layer k has any bit set. Layers are added until the top one fits
+// in a single word, so a 100k-level band needs three and 16M levels need
+// four. set(), clear(), findNext() and findPrev() touch at most one word
+// per layer and use count-trailing/leading-zeros, so their cost does not
+// depend on how far apart the occupied levels are.
+class LevelBitmap {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    explicit LevelBitmap(size_t size) : size_(size) {
+        size_t bits = size > 0 ? size : 1;
+        do {
+            size_t words = (bits + 63) / 64;
+            layers_.emplace_back(words, 0);
+            bits = words;
+        } while (bits > 1);
+    }
+
+    size_t size() const { return size_; }
+
+    bool test(size_t index) const {
+        return (layers_[0][index >> 6] >> (index & 63)) & 1;
+    }
+
+    void set(size_t index) {
+        for (auto& layer : layers_) {
+            uint64_t& word = layer[index >> 6];
+            bool wasEmpty = word == 0;
+            word |= uint64_t(1) << (index & 63);
+            if (!wasEmpty) {
+                return;
+            }
+            index >>= 6;
+        }
+    }
+
+    void clear(size_t index) {
+        for (auto& layer : layers_) {
+            uint64_t& word = layer[index >> 6];
+            word &= ~(uint64_t(1) << (index & 63));
+            if (word != 0) {
+                return;
+            }
+            index >>= 6;
+        }
+    }
+
+    // Lowest set index >= from, or npos
+    size_t findNext(size_t from) const {
+        if (from >= size_) {
+            return npos;
+        }
+
+        // Climb until a word has a set bit at or after the position
+        size_t layer = 0;
+        size_t index = from;
+        uint64_t bits;
+        while (true) {
+            const auto& words = layers_[layer];
+            bits = words[index >> 6] & (~uint64_t(0) << (index & 63));
+            if (bits != 0) {
+                break;
+            }
+            size_t nextWord = (index >> 6) + 1;
+            if (nextWord >= words.size()) {
+                return npos;
+            }
+            index = nextWord;
+            layer++;
+        }
+
+        // Descend along the lowest set bits
+        index = (index & ~size_t(63)) | lowestBit(bits);
+        while (layer > 0) {
+            layer--;
+            index = (index << 6) | lowestBit(layers_[layer][index]);
+        }
+        return index;
+    }
+
+    // Highest set index <= from, or npos
+    size_t findPrev(size_t from) const {
+        if (from == npos || size_ == 0) {
+            return npos;
+        }
+        if (from >= size_) {
+            from = size_ - 1;
+        }
+
+        size_t layer = 0;
+        size_t index = from;
+        uint64_t bits;
+        while (true) {
+            const auto& words = layers_[layer];
+            bits = words[index >> 6] & (~uint64_t(0) >> (63 - (index & 63)));
+            if (bits != 0) {
+                break;
+            }
+            if ((index >> 6) == 0 || layer + 1 == layers_.size()) {
+                return npos;
+            }
+            index = (index >> 6) - 1;
+            layer++;
+        }
+
+        index = (index & ~size_t(63)) | highestBit(bits);
+        while (layer > 0) {
+            layer--;
+            index = (index << 6) | highestBit(layers_[layer][index]);
+        }
+        return index;
+    }
+
+private:
+    size_t size_;
+    std::vector<std::vector<uint64_t>> layers_;   // layers_[0] is one bit per level
+
+    static unsigned lowestBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+        unsigned bit = 0;
+        while (!((bits >> bit) & 1)) {
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    static unsigned highestBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(bits));
+#else
+        unsigned bit = 63;
+        while (!((bits >> bit) & 1)) {
+            bit--;
+        }
+        return bit;
+#endif
+    }
+};
+
+#endif // LEVELBITMAP_H
@@ -0,0 +1,48 @@
+#ifndef LINEREADER_H
+#define LINEREADER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Splits a file or pipe into lines without copying them. Input is read in
+// large blocks with read(2) and lines are handed out as views into the
+// block; only a line that straddles two blocks is moved, to the front of
+// the buffer. The buffer grows only for lines longer than a block.
+class LineReader {
+public:
+    static constexpr size_t kDefaultBlockSize = 1 << 20;
+
+    // Read from an already open descriptor (not closed by the reader)
+    explicit LineReader(int fd, size_t blockSize = kDefaultBlockSize);
+
+    // Open a file; "-" reads standard input
+    explicit LineReader(const std::string& path, size_t blockSize = kDefaultBlockSize);
+    ~LineReader();
+
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    // Whether the input could be opened
+    bool isOpen() const { return fd_ >= 0; }
+
+    // Next line without its terminator ("\n" or "\r\n"). The view stays
+    // valid until the following call. Returns false at end of input.
+    bool next(std::string_view& line);
+
+private:
+    int fd_;
+    bool ownsFd_;
+    bool eof_;
+    size_t blockSize_;
+    std::vector<char> buffer_;
+    size_t begin_;      // Start of the unconsumed bytes
+    size_t end_;        // End of the bytes read so far
+
+    // Read another block after the unconsumed bytes. Returns false at end
+    // of input.
+    bool fill();
+};
+
+#endif // LINEREADER_H
@@ -0,0 +1,235 @@
+#ifndef MAPORDERBOOK_H
+#define MAPORDERBOOK_H
+
+#include "BookSnapshot.h"
+#include "Order.h"
+#include "Price.h"
+#include "PriceLadder.h"
+#include "Trade.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+// Reference book backend: one std::map of price levels per side, each
+// level a std::list FIFO, and an unordered_map from id to list position.
+// It favours obviously-correct code over speed and is the baseline the
+// production OrderBook is checked against (see BookDifferential.h). It
+// implements the BasicMatchingEngine book interface with OrderBook's
+// semantics but takes no lock, so it is for single-threaded use.
+class MapOrderBook {
+public:
+    explicit MapOrderBook(const TickConfig& config = TickConfig()) : config_(config), nextSequence_(0) {}
+
+    MapOrderBook(const MapOrderBook&) = delete;
+    MapOrderBook& operator=(const MapOrderBook&) = delete;
+
+    bool addOrder(const Order& order) {
+        if (!config_.isValid(order.getFixedPrice()) || index_.count(order.getId()) != 0) {
+            return false;
+        }
+        rest(order);
+        return true;
+    }
+
+    template<typename Sink>
+    bool match(Order& order, Sink& sink) {
+        if (order.getSide() == OrderSide::Buy) {
+            return matchSide<OrderSide::Buy>(order, sink);
+        }
+        return matchSide<OrderSide::Sell>(order, sink);
+    }
+
+    bool cancelOrder(uint64_t id) {
+        auto found = index_.find(id);
+        if (found == index_.end()) {
+            return false;
+        }
+        erase(found->second);
+        return true;
+    }
+
+    bool modifyOrder(uint64_t id, uint64_t newQuantity, Price newPrice) {
+        if (newQuantity == 0 || newQuantity > Order::kMaxQuantity || !config_.isValid(newPrice)) {
+            return false;
+        }
+        auto found = index_.find(id);
+        if (found == index_.end()) {
+            return false;
+        }
+
+        Order& order = *found->second;
+        if (newPrice == order.getFixedPrice() && newQuantity <= order.getQuantity()) {
+            // Quantity reduction keeps queue priority
+            levelOf(order).totalQuantity -= order.getQuantity() - newQuantity;
+            order.setQuantity(newQuantity);
+            return true;
+        }
+
+        // Price change or size increase loses priority
+        Order amended(order.getId(), order.getSide(), newPrice, newQuantity, order.getSymbol());
+        erase(found->second);
+        rest(amended);
+        return true;
+    }
+
+    std::optional<Order> getOrder(uint64_t id) const {
+        auto found = index_.find(id);
+        if (found == index_.end()) {
+            return std::nullopt;
+        }
+        return *found->second;
+    }
+
+    size_t getOrderCount() const { return index_.size(); }
+
+    bool isValidPrice(Price price) const { return config_.isValid(price); }
+
+    bool crossesSpread(OrderSide side, Price price) const {
+        if (side == OrderSide::Buy) {
+            return !asks_.empty() && AskLadder::reaches(Price::fromRaw(asks_.begin()->first), price);
+        }
+        return !bids_.empty() && BidLadder::reaches(Price::fromRaw(bids_.begin()->first), price);
+    }
+
+    std::optional<Order> getBestBid() const {
+        return bids_.empty() ? std::nullopt : std::optional<Order>(bids_.begin()->second.orders.front());
+    }
+
+    std::optional<Order> getBestAsk() const {
+        return asks_.empty() ? std::nullopt : std::optional<Order>(asks_.begin()->second.orders.front());
+    }
+
+    void fillSnapshot(BookSnapshot& snapshot) const {
+        snapshot.bidLevels = summarize(bids_, snapshot.bids);
+        snapshot.askLevels = summarize(asks_, snapshot.asks);
+        snapshot.restingOrders = index_.size();
+    }
+
+private:
+    struct Level {
+        uint64_t totalQuantity = 0;
+        std::list<Order> orders;   // Oldest first
+    };
+
+    // Keyed by raw price, best level first
+    std::map<int64_t, Level, std::greater<int64_t>> bids_;
+    std::map<int64_t, Level, std::less<int64_t>> asks_;
+    std::unordered_map<uint64_t, std::list<Order>::iterator> index_;
+    TickConfig config_;
+    uint32_t nextSequence_;
+
+    template<OrderSide Side>
+    auto& levels() {
+        if constexpr (Side == OrderSide::Buy) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    template<OrderSide Side, typename Sink>
+    bool matchSide(Order& order, Sink& sink) {
+        auto& opposite = levels<SideTraits<Side>::kOpposite>();
+        using Opposite = PriceLadder<SideTraits<Side>::kOpposite>;
+        const Price limit = order.getType() == OrderType::Market
+            ? SideTraits<Side>::kMostAggressive
+            : order.getFixedPrice();
+        uint64_t remaining = order.getQuantity();
+
+        if (index_.count(order.getId()) != 0) {
+            return false;
+        }
+
+        if (order.getTimeInForce() == TimeInForce::FillOrKill) {
+            uint64_t available = 0;
+            for (auto it = opposite.begin(); it != opposite.end() && available < remaining; ++it) {
+                if (!Opposite::reaches(Price::fromRaw(it->first), limit)) {
+                    break;
+                }
+                available += it->second.totalQuantity;
+            }
+            if (available < remaining) {
+                return false;
+            }
+        }
+
+        while (remaining > 0 && !opposite.empty()) {
+            auto best = opposite.begin();
+            const Price levelPrice = Price::fromRaw(best->first);
+            if (!Opposite::reaches(levelPrice, limit)) {
+                break;
+            }
+
+            Order& resting = best->second.orders.front();
+            uint64_t quantity = std::min(remaining, resting.getQuantity());
+            uint64_t buyId = Side == OrderSide::Buy ? order.getId() : resting.getId();
+            uint64_t sellId = Side == OrderSide::Buy ? resting.getId() : order.getId();
+            sink.onTrade(Trade(buyId, sellId, levelPrice.toDouble(), quantity, order.getSymbol()));
+
+            if (quantity == resting.getQuantity()) {
+                erase(index_.at(resting.getId()));
+            } else {
+                resting.setQuantity(resting.getQuantity() - quantity);
+                best->second.totalQuantity -= quantity;
+            }
+            remaining -= quantity;
+        }
+
+        order.setQuantity(remaining);
+        if (remaining == 0 || !order.canRest() || !config_.isValid(limit)) {
+            return false;
+        }
+        rest(order);
+        return true;
+    }
+
+    void rest(const Order& order) {
+        Level& level = order.getSide() == OrderSide::Buy ? bids_[order.getFixedPrice().raw()]
+                                                         : asks_[order.getFixedPrice().raw()];
+        level.orders.push_back(order);
+        level.orders.back().setSequence(nextSequence_++);
+        level.totalQuantity += order.getQuantity();
+        index_[order.getId()] = std::prev(level.orders.end());
+    }
+
+    Level& levelOf(const Order& order) {
+        return order.getSide() == OrderSide::Buy ? bids_.at(order.getFixedPrice().raw())
+                                                 : asks_.at(order.getFixedPrice().raw());
+    }
+
+    void erase(std::list<Order>::iterator position) {
+        const Order order = *position;
+        index_.erase(order.getId());
+        if (order.getSide() == OrderSide::Buy) {
+            eraseFrom(bids_, order, position);
+        } else {
+            eraseFrom(asks_, order, position);
+        }
+    }
+
+    template<typename Levels>
+    static void eraseFrom(Levels& levels, const Order& order, std::list<Order>::iterator position) {
+        auto level = levels.find(order.getFixedPrice().raw());
+        level->second.totalQuantity -= order.getQuantity();
+        level->second.orders.erase(position);
+        if (level->second.orders.empty()) {
+            levels.erase(level);
+        }
+    }
+
+    template<typename Levels>
+    static uint32_t summarize(const Levels& levels, LevelSummary* out) {
+        uint32_t count = 0;
+        for (auto it = levels.begin(); it != levels.end() && count < BookSnapshot::kDepth; ++it) {
+            out[count++] = LevelSummary{Price::fromRaw(it->first), it->second.totalQuantity,
+                                        it->second.orders.size()};
+        }
+        return count;
+    }
+};
+
+#endif // MAPORDERBOOK_H
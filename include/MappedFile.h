@@ -0,0 +1,31 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map a file for a single front-to-back pass. Returns false if it cannot
+    // be opened or is empty.
+    bool open(const std::string& path);
+
+    void close();
+
+    const char* data() const { return static_cast<const char*>(mapping_); }
+
+    size_t size() const { return size_; }
+
+private:
+    void* mapping_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,52 @@
+#ifndef MARKETDATA_H
+#define MARKETDATA_H
+
+#include "Order.h"
+#include "Price.h"
+#include <cstdint>
+#include <vector>
+
+enum class MarketDataType : uint8_t {
+    LevelAdd,      // A price level became non-empty
+    LevelUpdate,   // A level's aggregate quantity or order count changed
+    LevelDelete,   // A price level became empty
+    Trade          // A fill at price for quantity
+};
+
+// One incremental L2 event. Level events carry the level's new aggregates;
+// trade events carry the fill. Applying level events in sequence order to an
+// empty book rebuilds its depth.
+struct MarketDataEvent {
+    uint64_t sequence;        // Assigned by the publisher; gaps mean conflation
+    MarketDataType type;
+    OrderSide side;           // Level side; aggressor side for trades
+    SymbolId symbol;
+    Price price;
+    uint64_t quantity;        // Level total quantity, or trade quantity
+    uint64_t orderCount;      // Orders at the level (0 for trades)
+    uint64_t buyOrderId;      // Trades only
+    uint64_t sellOrderId;     // Trades only
+};
+
+// Receives level changes and trades as the book applies them. Called with
+// the book lock held on the matching thread, so implementations must be
+// quick and must not call back into the OrderBook.
+class MarketDataSink {
+public:
+    virtual ~MarketDataSink() = default;
+
+    virtual void onEvent(const MarketDataEvent& event) = 0;
+};
+
+// Sink that appends every event to a vector
+class MarketDataCollector : public MarketDataSink {
+public:
+    explicit MarketDataCollector(std::vector<MarketDataEvent>& events) : events_(events) {}
+
+    void onEvent(const MarketDataEvent& event) override { events_.push_back(event); }
+
+private:
+    std::vector<MarketDataEvent>& events_;
+};
+
+#endif // MARKETDATA_H
@@ -0,0 +1,53 @@
+#ifndef MARKETDATAPUBLISHER_H
+#define MARKETDATAPUBLISHER_H
+
+#include "MarketData.h"
+#include "MarketDataSubscriber.h"
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Market data fan-out stage. The matching thread only appends events to a
+// lock-free ring; a publisher thread stamps sequence numbers and delivers
+// each event to every subscriber. Subscribers conflate when they fall
+// behind, so a slow consumer never stalls the engine. Single producer: use
+// one publisher per engine thread.
+class MarketDataPublisher : public MarketDataSink {
+public:
+    explicit MarketDataPublisher(size_t ringCapacity = 1 << 16);
+    ~MarketDataPublisher() override;
+
+    MarketDataPublisher(const MarketDataPublisher&) = delete;
+    MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+    // Register a subscriber. Must be called before start().
+    void subscribe(MarketDataSubscriber& subscriber);
+
+    // Start the publisher thread
+    void start();
+
+    // Deliver remaining events and join the publisher thread
+    void stop();
+
+    // Append an event (matching thread). Spins only if the ring is full.
+    void onEvent(const MarketDataEvent& event) override;
+
+    // Events delivered to subscribers so far
+    uint64_t getPublishedCount() const { return published_.load(std::memory_order_relaxed); }
+
+private:
+    SpscRingBuffer<MarketDataEvent> ring_;
+    std::vector<MarketDataSubscriber*> subscribers_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> published_;
+
+    // Publisher thread body
+    void publishLoop();
+
+    // Fan out queued events. Returns the number delivered.
+    size_t drain();
+};
+
+#endif // MARKETDATAPUBLISHER_H
@@ -0,0 +1,81 @@
+#ifndef MARKETDATASUBSCRIBER_H
+#define MARKETDATASUBSCRIBER_H
+
+#include "MarketData.h"
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Bounded mailbox of market data events for one downstream consumer.
+// While the consumer keeps up, every event is delivered in order. Once the
+// mailbox is full the subscriber switches to conflation: each price level
+// keeps only its latest state and trades are dropped (and counted), so a
+// slow consumer costs bounded memory and never backs up the publisher.
+// After the backlog is drained the conflated level states are delivered
+// and normal delivery resumes. Consumers should treat LevelAdd and
+// LevelUpdate alike as upserts.
+class MarketDataSubscriber {
+public:
+    explicit MarketDataSubscriber(size_t capacity = 4096);
+
+    MarketDataSubscriber(const MarketDataSubscriber&) = delete;
+    MarketDataSubscriber& operator=(const MarketDataSubscriber&) = delete;
+
+    // Hand over one event (publisher thread). Never waits for the consumer.
+    void deliver(const MarketDataEvent& event);
+
+    // Move up to maxEvents pending events into out (consumer thread).
+    // Returns the number of events appended.
+    size_t poll(std::vector<MarketDataEvent>& out,
+                size_t maxEvents = std::numeric_limits<size_t>::max());
+
+    // Whether the subscriber is currently behind and conflating
+    bool isConflating() const;
+
+    // Level events merged into a newer state of the same level
+    uint64_t getConflatedCount() const { return conflated_.load(std::memory_order_relaxed); }
+
+    // Trades dropped while conflating
+    uint64_t getDroppedTradeCount() const { return droppedTrades_.load(std::memory_order_relaxed); }
+
+private:
+    struct LevelKey {
+        SymbolId symbol;
+        OrderSide side;
+        int64_t priceRaw;
+
+        bool operator==(const LevelKey& other) const {
+            return symbol == other.symbol && side == other.side && priceRaw == other.priceRaw;
+        }
+    };
+
+    struct LevelKeyHash {
+        size_t operator()(const LevelKey& key) const {
+            uint64_t h = static_cast<uint64_t>(key.priceRaw) * 0x9E3779B97F4A7C15ull;
+            h ^= (static_cast<uint64_t>(key.symbol) << 1 | (key.side == OrderSide::Buy ? 1 : 0)) +
+                 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+            return static_cast<size_t>(h);
+        }
+    };
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::deque<MarketDataEvent> queue_;
+
+    // Latest state of each level changed while conflating, in first-change order
+    bool conflating_;
+    std::vector<MarketDataEvent> pending_;
+    std::unordered_map<LevelKey, size_t, LevelKeyHash> pendingIndex_;
+
+    std::atomic<uint64_t> conflated_;
+    std::atomic<uint64_t> droppedTrades_;
+
+    // Record a level event in the conflation buffer
+    void conflate(const MarketDataEvent& event);
+};
+
+#endif // MARKETDATASUBSCRIBER_H
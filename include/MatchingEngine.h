@@ -1,32 +1,223 @@
 #ifndef MATCHINGENGINE_H
 #define MATCHINGENGINE_H
 
+#include "BookSnapshot.h"
 #include "Order.h"
 #include "OrderBook.h"
+#include "OrderMessage.h"
+#include "SeqLock.h"
 #include "Trade.h"
+#include "TradeSink.h"
 #include <vector>
 #include <optional>
 
-class MatchingEngine {
+// Matching engine over any book backend. Book must provide, with the
+// semantics documented on OrderBook:
+//   template<typename Sink> bool match(Order&, Sink&)
+//   bool cancelOrder(uint64_t id)
+//   bool modifyOrder(uint64_t id, uint64_t newQuantity, Price newPrice)
+//   std::optional<Order> getOrder(uint64_t id) const
+//   bool isValidPrice(Price) const
+//   bool crossesSpread(OrderSide, Price) const
+//   void fillSnapshot(BookSnapshot&) const
+// The engine binds to these at compile time, so backends pay no virtual
+// dispatch. MatchingEngine is the engine over the production OrderBook.
+template<typename Book>
+class BasicMatchingEngine {
 public:
-    MatchingEngine(OrderBook& orderBook);
+    explicit BasicMatchingEngine(Book& orderBook)
+        : orderBook_(orderBook), tradeCount_(0), messagesProcessed_(0) {}
 
-    // Process an incoming order and return executed trades
-    std::vector<Trade> processOrder(Order order);
+    // Process an incoming order and return executed trades. Convenience
+    // wrapper that allocates; hot paths should pass a sink instead.
+    std::vector<Trade> processOrder(Order order) {
+        std::vector<Trade> trades;
+        TradeCollector collector(trades);
+        processOrder(order, collector);
+        return trades;
+    }
 
-    // Get the last executed trade
-    std::optional<Trade> getLastTrade() const;
+    // Process an incoming order, reporting executed trades to a sink as they
+    // happen. Sink is a TradeSink (virtual) or any type with
+    // onTrade(const Trade&), which is then called directly.
+    template<typename Sink>
+    void processOrder(Order order, Sink& sink);
+
+    // Process a new, cancel or modify instruction and return executed trades.
+    // A modify whose new price crosses the spread is treated as a cancel
+    // followed by a new aggressive order.
+    std::vector<Trade> processMessage(const OrderMessage& message) {
+        std::vector<Trade> trades;
+        TradeCollector collector(trades);
+        processMessage(message, collector);
+        return trades;
+    }
+
+    // Process a new, cancel or modify instruction, reporting trades to a sink
+    template<typename Sink>
+    void processMessage(const OrderMessage& message, Sink& sink) {
+        processBatch(&message, 1, sink);
+    }
+
+    // Process a contiguous batch of instructions in order, then publish a
+    // fresh snapshot once for the whole batch.
+    template<typename Sink>
+    void processBatch(const OrderMessage* messages, size_t count, Sink& sink);
+
+    // Get the last executed trade. Engine thread only; other threads should
+    // read getSnapshot().
+    std::optional<Trade> getLastTrade() const { return lastTrade_; }
+
+    // Copy the book's current depth, last trade and counters into the
+    // snapshot. Called by processBatch() and processOrder().
+    void publishSnapshot() {
+        BookSnapshot snapshot{};
+        orderBook_.fillSnapshot(snapshot);
+        if (lastTrade_.has_value()) {
+            snapshot.hasLastTrade = true;
+            snapshot.lastTradePrice = Price::fromDouble(lastTrade_->price);
+            snapshot.lastTradeQuantity = lastTrade_->quantity;
+        }
+        snapshot.tradeCount = tradeCount_;
+        snapshot.messagesProcessed = messagesProcessed_;
+        snapshot_.write(snapshot);
+    }
+
+    Book& getOrderBook() { return orderBook_; }
+
+    // Latest published snapshot. Safe from any thread and never takes the
+    // book lock.
+    BookSnapshot getSnapshot() const { return snapshot_.read(); }
 
 private:
-    OrderBook& orderBook_;
+    Book& orderBook_;
     std::optional<Trade> lastTrade_;
-    mutable std::mutex mutex_;
+    uint64_t tradeCount_;
+    uint64_t messagesProcessed_;
+    SeqLock<BookSnapshot> snapshot_;
+
+    // Forwards fills to the caller's sink, counting them and remembering
+    // the most recent one for the snapshot
+    template<typename Sink>
+    class LastTradeTracker {
+    public:
+        explicit LastTradeTracker(Sink& inner) : inner_(inner), last_(0, 0, 0.0, 0), count_(0) {}
+
+        void onTrade(const Trade& trade) {
+            inner_.onTrade(trade);
+            last_ = trade;
+            count_++;
+        }
+
+        // Record the results in the engine
+        void commit(BasicMatchingEngine& engine) const {
+            if (count_ > 0) {
+                engine.lastTrade_ = last_;
+            }
+            engine.tradeCount_ += count_;
+        }
+
+    private:
+        Sink& inner_;
+        Trade last_;
+        uint64_t count_;
+    };
+
+    // Dispatch one instruction without touching lastTrade_
+    template<typename Sink>
+    void execute(const OrderMessage& message, Sink& sink);
 
-    // Check if a buy order can match with best ask
-    bool canMatchBuy(const Order& buyOrder, const Order& askOrder) const;
+    // Match an order and rest any remainder
+    template<typename Sink>
+    void executeOrder(Order& order, Sink& sink);
 
-    // Check if a sell order can match with best bid
-    bool canMatchSell(const Order& sellOrder, const Order& bidOrder) const;
+    // Apply a modify instruction to a resting order
+    template<typename Sink>
+    void executeModify(const Order& amendment, Sink& sink);
 };
 
+template<typename Book>
+template<typename Sink>
+void BasicMatchingEngine<Book>::processOrder(Order order, Sink& sink) {
+    LastTradeTracker<Sink> tracker(sink);
+    executeOrder(order, tracker);
+    tracker.commit(*this);
+    messagesProcessed_++;
+    publishSnapshot();
+}
+
+template<typename Book>
+template<typename Sink>
+void BasicMatchingEngine<Book>::processBatch(const OrderMessage* messages, size_t count, Sink& sink) {
+    LastTradeTracker<Sink> tracker(sink);
+    for (size_t i = 0; i < count; ++i) {
+        execute(messages[i], tracker);
+    }
+    tracker.commit(*this);
+    messagesProcessed_ += count;
+    publishSnapshot();
+}
+
+template<typename Book>
+template<typename Sink>
+void BasicMatchingEngine<Book>::execute(const OrderMessage& message, Sink& sink) {
+    switch (message.type) {
+    case MessageType::New: {
+        Order order = message.order;
+        executeOrder(order, sink);
+        break;
+    }
+    case MessageType::Cancel:
+        orderBook_.cancelOrder(message.order.getId());
+        break;
+    case MessageType::Modify:
+        executeModify(message.order, sink);
+        break;
+    }
+}
+
+template<typename Book>
+template<typename Sink>
+void BasicMatchingEngine<Book>::executeOrder(Order& order, Sink& sink) {
+    // Limit orders off the tick grid or outside the price band are dropped
+    if (order.getType() == OrderType::Limit && !orderBook_.isValidPrice(order.getFixedPrice())) {
+        return;
+    }
+
+    // Match and rest the remainder in one pass over the book
+    orderBook_.match(order, sink);
+}
+
+template<typename Book>
+template<typename Sink>
+void BasicMatchingEngine<Book>::executeModify(const Order& amendment, Sink& sink) {
+    auto resting = orderBook_.getOrder(amendment.getId());
+    if (!resting.has_value()) {
+        return;
+    }
+
+    // Modify to zero is a cancel
+    if (amendment.getQuantity() == 0) {
+        orderBook_.cancelOrder(amendment.getId());
+        return;
+    }
+
+    Order amended(amendment.getId(), resting->getSide(),
+                  amendment.getFixedPrice(), amendment.getQuantity(), resting->getSymbol());
+
+    if (orderBook_.isValidPrice(amended.getFixedPrice()) &&
+        orderBook_.crossesSpread(amended.getSide(), amended.getFixedPrice())) {
+        orderBook_.cancelOrder(amended.getId());
+        executeOrder(amended, sink);
+        return;
+    }
+
+    orderBook_.modifyOrder(amended.getId(), amended.getQuantity(), amended.getFixedPrice());
+}
+
+using MatchingEngine = BasicMatchingEngine<OrderBook>;
+
+// Compiled once in MatchingEngine.cpp
+extern template class BasicMatchingEngine<OrderBook>;
+
 #endif // MATCHINGENGINE_H
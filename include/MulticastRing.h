@@ -0,0 +1,224 @@
+#ifndef MULTICASTRING_H
+#define MULTICASTRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+// Preallocated ring of sequenced events with one writer and several
+// independent readers, in the style of the LMAX Disruptor. Every event is
+// stored once; each reader keeps its own cursor and consumes at its own
+// pace, so N consumers cost one copy into the ring instead of one queue per
+// consumer.
+//
+// Readers are either gating or not. The writer only waits for the slowest
+// gating reader, which therefore sees every event. A non-gating reader (a
+// stats sampler, a monitor) never slows the writer: if it falls a whole
+// ring behind it is lapped, skips ahead and counts the events it missed.
+// Slots carry their sequence and payloads are copied as relaxed atomic
+// words, as in SeqLock, so a lapped read is detected rather than torn.
+//
+// Readers are added before the writer starts and must each be polled by
+// one thread. A reader that stops consuming calls detach() so it no longer
+// holds the writer back.
+template<typename T>
+class MulticastRing {
+    static_assert(std::is_trivially_copyable<T>::value, "MulticastRing payload is copied word by word");
+
+public:
+    using ReaderId = size_t;
+
+    static constexpr size_t kMaxReaders = 8;
+
+    // Capacity is rounded up to a power of two
+    explicit MulticastRing(size_t capacity = 65536)
+        : readerCount_(0), published_(0), next_(0), cachedGate_(0) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        capacity_ = rounded;
+        mask_ = rounded - 1;
+        slots_.reset(new Slot[rounded]);
+        for (size_t i = 0; i < rounded; ++i) {
+            slots_[i].sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    MulticastRing(const MulticastRing&) = delete;
+    MulticastRing& operator=(const MulticastRing&) = delete;
+
+    // Register a reader that starts at the next published event. Returns
+    // kMaxReaders if the ring has no free reader slot.
+    ReaderId addReader(bool gating = true) {
+        const size_t id = readerCount_.load(std::memory_order_relaxed);
+        if (id == kMaxReaders) {
+            return kMaxReaders;
+        }
+        Cursor& cursor = readers_[id];
+        cursor.next.store(published_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        cursor.gating.store(gating, std::memory_order_relaxed);
+        cursor.dropped = 0;
+        readerCount_.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Stop a reader from holding back the writer. Called by the reader's
+    // own thread when it stops polling.
+    void detach(ReaderId reader) {
+        readers_[reader].gating.store(false, std::memory_order_release);
+    }
+
+    // Append an event unless that would overwrite one a gating reader has
+    // not consumed yet (writer thread)
+    bool tryPublish(const T& item) {
+        const uint64_t sequence = next_;
+        if (sequence - cachedGate_ >= capacity_) {
+            cachedGate_ = slowestGatingReader(sequence);
+            if (sequence - cachedGate_ >= capacity_) {
+                return false;
+            }
+        }
+
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &item, sizeof(T));
+
+        Slot& slot = slots_[sequence & mask_];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            slot.words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 1, std::memory_order_release);
+
+        next_ = sequence + 1;
+        published_.store(next_, std::memory_order_release);
+        return true;
+    }
+
+    // Append an event, spinning while the slowest gating reader is a whole
+    // ring behind (writer thread)
+    void publish(const T& item) {
+        while (!tryPublish(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Hand up to maxItems unread events to handler(const T&) in order, then
+    // advance the reader's cursor once for the whole run. Returns the
+    // number handled.
+    template<typename Handler>
+    size_t poll(ReaderId reader, Handler&& handler, size_t maxItems = SIZE_MAX) {
+        Cursor& cursor = readers_[reader];
+        uint64_t sequence = cursor.next.load(std::memory_order_relaxed);
+        const bool gating = cursor.gating.load(std::memory_order_relaxed);
+        size_t handled = 0;
+
+        while (handled < maxItems) {
+            const uint64_t available = published_.load(std::memory_order_acquire);
+            if (sequence == available) {
+                break;
+            }
+            if (available - sequence > capacity_) {
+                // Lapped: the oldest events still in the ring start here
+                cursor.dropped += available - capacity_ - sequence;
+                sequence = available - capacity_;
+            }
+
+            alignas(T) unsigned char value[sizeof(T)];
+            if (!read(sequence, value)) {
+                continue;   // Overwritten while copying; recheck the lap
+            }
+            handler(*std::launder(reinterpret_cast<const T*>(value)));
+            sequence++;
+            handled++;
+            if (gating && (handled & 63) == 0) {
+                // Long runs release slots to the writer as they go
+                cursor.next.store(sequence, std::memory_order_release);
+            }
+        }
+
+        cursor.next.store(sequence, std::memory_order_release);
+        return handled;
+    }
+
+    // Events published so far
+    uint64_t getPublished() const { return published_.load(std::memory_order_acquire); }
+
+    // Events a reader has not consumed yet
+    uint64_t getLag(ReaderId reader) const {
+        return getPublished() - readers_[reader].next.load(std::memory_order_acquire);
+    }
+
+    // Events a non-gating reader skipped because it was lapped (reader thread)
+    uint64_t getDropped(ReaderId reader) const { return readers_[reader].dropped; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;     // Event sequence + 1, or 0 while being written
+        std::atomic<uint64_t> words[kWords];
+    };
+
+    struct alignas(kCacheLineSize) Cursor {
+        std::atomic<uint64_t> next{0};      // Sequence of the next event to read
+        std::atomic<bool> gating{false};
+        uint64_t dropped = 0;
+    };
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    Cursor readers_[kMaxReaders];
+    std::atomic<size_t> readerCount_;
+
+    // Writer side
+    alignas(kCacheLineSize) std::atomic<uint64_t> published_;
+    uint64_t next_;
+    uint64_t cachedGate_;
+
+    // Lowest cursor among gating readers, or sequence if there are none
+    uint64_t slowestGatingReader(uint64_t sequence) const {
+        uint64_t slowest = sequence;
+        const size_t count = readerCount_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            if (readers_[i].gating.load(std::memory_order_acquire)) {
+                uint64_t next = readers_[i].next.load(std::memory_order_acquire);
+                if (next < slowest) {
+                    slowest = next;
+                }
+            }
+        }
+        return slowest;
+    }
+
+    // Copy the event at sequence into out. Returns false if the slot no
+    // longer holds it.
+    bool read(uint64_t sequence, unsigned char* out) const {
+        const Slot& slot = slots_[sequence & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != sequence + 1) {
+            return false;
+        }
+        uint64_t buffer[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence + 1) {
+            return false;
+        }
+        std::memcpy(out, buffer, sizeof(T));
+        return true;
+    }
+};
+
+#endif // MULTICASTRING_H
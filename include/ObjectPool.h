@@ -0,0 +1,81 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Free-list pool of fixed-size objects. Storage is preallocated in chunks,
+// so create()/destroy() never touch the heap once the pool is warm. If the
+// pool runs dry it grows by another chunk rather than failing.
+// Not thread-safe: each pool belongs to the thread that owns its book.
+template<typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t initialCapacity = 1024, size_t chunkSize = 0)
+        : freeList_(nullptr), capacity_(0), inUse_(0),
+          chunkSize_(chunkSize > 0 ? chunkSize : (initialCapacity > 0 ? initialCapacity : 1024)) {
+        chunks_.reserve(16);
+        if (initialCapacity > 0) {
+            grow(initialCapacity);
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Construct an object in a free slot
+    template<typename... Args>
+    T* create(Args&&... args) {
+        if (freeList_ == nullptr) {
+            grow(chunkSize_);
+        }
+        Slot* slot = freeList_;
+        freeList_ = slot->next;
+        inUse_++;
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    // Destroy an object and return its slot to the free list
+    void destroy(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList_;
+        freeList_ = slot;
+        inUse_--;
+    }
+
+    // Total slots owned by the pool
+    size_t capacity() const { return capacity_; }
+
+    // Slots currently holding live objects
+    size_t inUse() const { return inUse_; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    Slot* freeList_;
+    size_t capacity_;
+    size_t inUse_;
+    size_t chunkSize_;
+
+    void grow(size_t count) {
+        chunks_.emplace_back(new Slot[count]);
+        Slot* chunk = chunks_.back().get();
+
+        // Thread in reverse so slots are handed out in address order
+        for (size_t i = count; i > 0; --i) {
+            chunk[i - 1].next = freeList_;
+            freeList_ = &chunk[i - 1];
+        }
+        capacity_ += count;
+    }
+};
+
+#endif // OBJECTPOOL_H
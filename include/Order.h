@@ -1,34 +1,95 @@
 #ifndef ORDER_H
 #define ORDER_H
 
+#include "Price.h"
+#include <cassert>
 #include <cstdint>
-#include <chrono>
+#include <type_traits>
 
-enum class OrderSide {
+// Instrument identifier assigned by the SymbolDirectory
+using SymbolId = uint32_t;
+
+enum class OrderSide : uint8_t {
     Buy,
     Sell
 };
 
+enum class OrderType : uint8_t {
+    Limit,
+    Market      // No price limit; never rests
+};
+
+enum class TimeInForce : uint8_t {
+    GoodTillCancel,     // Remainder rests in the book
+    ImmediateOrCancel,  // Remainder is cancelled
+    FillOrKill          // Fills completely right away or not at all
+};
+
+// Compact, trivially copyable order record: 32 bytes, so two resting
+// orders share a cache line and queue copies are plain memcpys. Time
+// priority comes from a sequence number the book assigns when the order
+// rests; wall-clock arrival time travels on OrderMessage instead.
 class Order {
 public:
-    Order(uint64_t id, OrderSide side, double price, uint64_t quantity);
+    // Largest quantity an order can carry. Quantities are stored in 32 bits,
+    // so passing a larger one to a constructor or setQuantity() breaks the
+    // contract (asserted in debug builds): every ingest path range-checks a
+    // quantity before it builds an Order or OrderMessage.
+    static constexpr uint64_t kMaxQuantity = UINT32_MAX;
+
+    Order(uint64_t id, OrderSide side, double price, uint64_t quantity, SymbolId symbol = 0);
+    Order(uint64_t id, OrderSide side, Price price, uint64_t quantity, SymbolId symbol = 0);
+    Order(uint64_t id, OrderSide side, Price price, uint64_t quantity, SymbolId symbol,
+          OrderType type, TimeInForce timeInForce);
+
+    // Market order; the price is ignored
+    static Order market(uint64_t id, OrderSide side, uint64_t quantity, SymbolId symbol = 0,
+                        TimeInForce timeInForce = TimeInForce::ImmediateOrCancel) {
+        return Order(id, side, Price(), quantity, symbol, OrderType::Market, timeInForce);
+    }
 
     uint64_t getId() const { return id_; }
     OrderSide getSide() const { return side_; }
-    double getPrice() const { return price_; }
+    double getPrice() const { return price_.toDouble(); }
+    Price getFixedPrice() const { return price_; }
     uint64_t getQuantity() const { return quantity_; }
-    std::chrono::steady_clock::time_point getTimestamp() const { return timestamp_; }
+    SymbolId getSymbol() const { return symbol_; }
+    OrderType getType() const { return type_; }
+    TimeInForce getTimeInForce() const { return timeInForce_; }
+
+    // Whether an unfilled remainder may rest in the book
+    bool canRest() const {
+        return type_ == OrderType::Limit && timeInForce_ == TimeInForce::GoodTillCancel;
+    }
 
-    void setQuantity(uint64_t quantity) { quantity_ = quantity; }
+    // Book-assigned time priority; lower is older
+    uint32_t getSequence() const { return sequence_; }
 
-    bool operator<(const Order& other) const;
+    void setQuantity(uint64_t quantity) {
+        assert(quantity <= kMaxQuantity);
+        quantity_ = static_cast<uint32_t>(quantity);
+    }
+    void setSequence(uint32_t sequence) { sequence_ = sequence; }
+
+    // Time priority: true if this order rested before other. The sequence
+    // wraps, so this holds while the orders are less than 2^31 apart.
+    bool operator<(const Order& other) const {
+        return static_cast<int32_t>(sequence_ - other.sequence_) < 0;
+    }
 
 private:
     uint64_t id_;
+    Price price_;
+    uint32_t quantity_;
+    SymbolId symbol_;
+    uint32_t sequence_;
     OrderSide side_;
-    double price_;
-    uint64_t quantity_;
-    std::chrono::steady_clock::time_point timestamp_;
+    OrderType type_;
+    TimeInForce timeInForce_;
+    uint8_t reserved_;
 };
 
+static_assert(std::is_trivially_copyable<Order>::value, "Order is copied raw through queues");
+static_assert(sizeof(Order) == 32, "Order should stay half a cache line");
+
 #endif // ORDER_H
@@ -1,56 +1,344 @@
 #ifndef ORDERBOOK_H
 #define ORDERBOOK_H
 
+#include "BookSnapshot.h"
+#include "MarketData.h"
 #include "Order.h"
-#include <map>
-#include <queue>
+#include "Price.h"
+#include "PriceLadder.h"
+#include "OrderIndex.h"
+#include "ObjectPool.h"
+#include "TradeSink.h"
+#include <algorithm>
+#include <limits>
 #include <vector>
 #include <mutex>
-
-struct PriceLevel {
-    double price;
-    uint64_t totalQuantity;
-    std::queue<Order> orders;
-
-    PriceLevel(double p = 0.0) : price(p), totalQuantity(0) {}
-};
+#include <optional>
+#include <utility>
 
 class OrderBook {
 public:
-    OrderBook() = default;
+    static constexpr size_t kDefaultOrderCapacity = 1 << 16;
+
+    // orderCapacity presizes the order node pool and id index so that a book
+    // holding up to that many resting orders matches without heap allocation.
+    explicit OrderBook(const TickConfig& config = TickConfig(),
+                       size_t orderCapacity = kDefaultOrderCapacity);
+    ~OrderBook();
+
+    OrderBook(const OrderBook&) = delete;
+    OrderBook& operator=(const OrderBook&) = delete;
+
+    // Add an order to the book. Returns false if the price is outside the
+    // band, not on a tick boundary, or the id is already resting.
+    bool addOrder(const Order& order);
+
+    // Match an incoming order against the opposite side under a single lock
+    // acquisition. Fills are reported to the sink in execution order and
+    // order's quantity is reduced to what is left; the remainder of a GTC
+    // limit order rests in the book within the same critical section, that
+    // of IOC and market orders is dropped. A fill-or-kill order that the
+    // opposite side cannot fill completely, or any order reusing the id of a
+    // resting one, is rejected without trading and keeps its full quantity.
+    // Returns true if the order rested.
+    //
+    // Sink is any type with onTrade(const Trade&): a TradeSink reference
+    // dispatches virtually, a concrete or final sink is called directly and
+    // can be inlined into the matching loop.
+    template<typename Sink>
+    bool match(Order& order, Sink& sink);
+
+    // Cancel a resting order. Returns false if the id is not in the book.
+    bool cancelOrder(uint64_t id);
 
-    // Add an order to the book
-    void addOrder(const Order& order);
+    // Amend a resting order. A quantity reduction at the same price keeps
+    // queue priority; a price change or quantity increase moves the order to
+    // the back of its (new) level. Returns false if the id is unknown, the
+    // new price is invalid or the quantity is zero or above
+    // Order::kMaxQuantity; use cancelOrder() to remove an order.
+    bool modifyOrder(uint64_t id, uint64_t newQuantity, Price newPrice);
+
+    // Look up a resting order by id
+    std::optional<Order> getOrder(uint64_t id) const;
+
+    // Number of resting orders on both sides
+    size_t getOrderCount() const;
+
+    // Check whether a price can rest in this book
+    bool isValidPrice(Price price) const { return config_.isValid(price); }
+
+    const TickConfig& getTickConfig() const { return config_; }
+
+    // Whether an order on side limited at price would trade immediately
+    // against the opposite side
+    bool crossesSpread(OrderSide side, Price price) const;
+
+    // Oldest order at the best level of a side
+    template<OrderSide Side>
+    std::optional<Order> getBest() const;
 
     // Get best bid (highest buy price)
-    std::optional<Order> getBestBid();
+    std::optional<Order> getBestBid() const { return getBest<OrderSide::Buy>(); }
 
     // Get best ask (lowest sell price)
-    std::optional<Order> getBestAsk();
+    std::optional<Order> getBestAsk() const { return getBest<OrderSide::Sell>(); }
+
+    // Remove quantity from the front order of a side's best level
+    template<OrderSide Side>
+    void removeBestQuantity(uint64_t quantity);
 
     // Remove quantity from best bid
-    void removeBidQuantity(uint64_t quantity);
+    void removeBidQuantity(uint64_t quantity) { removeBestQuantity<OrderSide::Buy>(quantity); }
 
     // Remove quantity from best ask
-    void removeAskQuantity(uint64_t quantity);
+    void removeAskQuantity(uint64_t quantity) { removeBestQuantity<OrderSide::Sell>(quantity); }
+
+    // Get the top N levels of a side, best first
+    template<OrderSide Side>
+    std::vector<PriceLevel> getTopLevels(size_t n) const;
 
     // Get top N bid levels for display
-    std::vector<PriceLevel> getTopBids(size_t n) const;
+    std::vector<PriceLevel> getTopBids(size_t n) const { return getTopLevels<OrderSide::Buy>(n); }
 
     // Get top N ask levels for display
-    std::vector<PriceLevel> getTopAsks(size_t n) const;
+    std::vector<PriceLevel> getTopAsks(size_t n) const { return getTopLevels<OrderSide::Sell>(n); }
+
+    // Visit every resting order under the book lock: bids then asks, best
+    // price first, in time priority within a level. Adding the visited
+    // orders to an empty book in this order reproduces the queues exactly.
+    template<typename Func>
+    void forEachOrder(Func&& func) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bids_.forEachOrder(func);
+        asks_.forEachOrder(func);
+    }
+
+    // Fill the depth levels and resting order count of a snapshot
+    void fillSnapshot(BookSnapshot& snapshot) const;
+
+    // Report level changes and trades to a market data sink as they are
+    // applied (nullptr disables). Set before the book starts trading.
+    void setMarketDataSink(MarketDataSink* sink) { marketData_ = sink; }
 
     // Thread-safe access
     std::mutex& getMutex() { return mutex_; }
 
 private:
-    // Bids: higher price is better (descending order)
-    std::map<double, PriceLevel, std::greater<double>> bids_;
+    TickConfig config_;
+
+    // Bids: best level is the highest price
+    BidLadder bids_;
+
+    // Asks: best level is the lowest price
+    AskLadder asks_;
+
+    // Resting orders by id
+    OrderIndex index_;
 
-    // Asks: lower price is better (ascending order)
-    std::map<double, PriceLevel, std::less<double>> asks_;
+    // Storage for resting order nodes
+    ObjectPool<OrderNode> nodePool_;
+
+    MarketDataSink* marketData_;
+
+    // Time priority handed to the next order that rests
+    uint32_t nextSequence_;
 
     mutable std::mutex mutex_;
+
+    template<OrderSide Side>
+    PriceLadder<Side>& ladder() {
+        if constexpr (Side == OrderSide::Buy) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    template<OrderSide Side>
+    const PriceLadder<Side>& ladder() const {
+        if constexpr (Side == OrderSide::Buy) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    // Matching loop for an incoming order of a known side
+    template<OrderSide Side, typename Sink>
+    bool matchSide(Order& order, Sink& sink);
+
+    // Apply a modify to a resting order of a known side
+    template<OrderSide Side>
+    void modifyNode(OrderNode* node, uint64_t newQuantity, Price newPrice);
+
+    // Allocate, index and link a resting order, stamping its sequence
+    template<OrderSide Side>
+    void insertNode(const Order& order);
+
+    // Unlink, unindex and free a resting order
+    template<OrderSide Side>
+    void eraseNode(OrderNode* node);
+
+    // Reduce a resting order in place, keeping its queue position
+    template<OrderSide Side>
+    void reduceNode(OrderNode* node, uint64_t quantity);
+
+    // Emit the current state of a level to the market data sink
+    template<OrderSide Side>
+    void publishLevel(Price price, SymbolId symbol, bool added);
 };
 
+template<typename Sink>
+bool OrderBook::match(Order& order, Sink& sink) {
+    // The only side branch: everything below is instantiated per side
+    if (order.getSide() == OrderSide::Buy) {
+        return matchSide<OrderSide::Buy>(order, sink);
+    }
+    return matchSide<OrderSide::Sell>(order, sink);
+}
+
+template<OrderSide Side, typename Sink>
+bool OrderBook::matchSide(Order& order, Sink& sink) {
+    using Opposite = PriceLadder<SideTraits<Side>::kOpposite>;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Opposite& opposite = ladder<SideTraits<Side>::kOpposite>();
+    const Price limit = order.getType() == OrderType::Market
+        ? SideTraits<Side>::kMostAggressive
+        : order.getFixedPrice();
+    uint64_t remainingQuantity = order.getQuantity();
+
+    // A live id would be traded under and then refused from resting
+    if (index_.find(order.getId()) != nullptr) {
+        return false;
+    }
+
+    // Fill-or-kill is decided from level totals before anything is touched
+    if (order.getTimeInForce() == TimeInForce::FillOrKill &&
+        opposite.availableQuantity(limit, remainingQuantity) < remainingQuantity) {
+        return false;
+    }
+
+    while (remainingQuantity > 0) {
+        PriceLevel* level = opposite.best();
+        if (level == nullptr || !Opposite::reaches(level->price, limit)) {
+            break;
+        }
+
+        // Fill the oldest order at the best level in place
+        OrderNode* resting = level->head;
+        uint64_t matchQuantity = std::min(remainingQuantity, resting->order.getQuantity());
+        double tradePrice = level->price.toDouble(); // Passive order price
+
+        uint64_t buyId = order.getId();
+        uint64_t sellId = resting->order.getId();
+        if constexpr (Side == OrderSide::Sell) {
+            std::swap(buyId, sellId);
+        }
+        const Trade trade(buyId, sellId, tradePrice, matchQuantity, order.getSymbol());
+        sink.onTrade(trade);
+
+        if (marketData_ != nullptr) {
+            marketData_->onEvent(MarketDataEvent{0, MarketDataType::Trade, Side,
+                                                 order.getSymbol(), level->price, matchQuantity, 0,
+                                                 buyId, sellId});
+        }
+
+        if (matchQuantity == resting->order.getQuantity()) {
+            eraseNode<SideTraits<Side>::kOpposite>(resting);
+        } else {
+            reduceNode<SideTraits<Side>::kOpposite>(resting, matchQuantity);
+        }
+        remainingQuantity -= matchQuantity;
+    }
+
+    order.setQuantity(remainingQuantity);
+
+    if (remainingQuantity == 0 || !order.canRest() || !config_.isValid(limit)) {
+        return false;
+    }
+
+    insertNode<Side>(order);
+    return true;
+}
+
+template<OrderSide Side>
+std::optional<Order> OrderBook::getBest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const PriceLevel* level = ladder<Side>().best();
+    if (level == nullptr) {
+        return std::nullopt;
+    }
+    return level->head->order;
+}
+
+template<OrderSide Side>
+void OrderBook::removeBestQuantity(uint64_t quantity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    PriceLevel* level = ladder<Side>().best();
+    if (level == nullptr) return;
+
+    OrderNode* node = level->head;
+    if (node->order.getQuantity() <= quantity) {
+        eraseNode<Side>(node);
+    } else {
+        reduceNode<Side>(node, quantity);
+    }
+}
+
+template<OrderSide Side>
+std::vector<PriceLevel> OrderBook::getTopLevels(size_t n) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ladder<Side>().top(n);
+}
+
+template<OrderSide Side>
+void OrderBook::insertNode(const Order& order) {
+    OrderNode* node = nodePool_.create(order);
+    node->order.setSequence(nextSequence_++);
+    index_.insert(order.getId(), node);
+    ladder<Side>().add(node);
+    if (marketData_ != nullptr) {
+        publishLevel<Side>(order.getFixedPrice(), order.getSymbol(), true);
+    }
+}
+
+template<OrderSide Side>
+void OrderBook::eraseNode(OrderNode* node) {
+    const Order& order = node->order;
+    ladder<Side>().remove(node);
+    if (marketData_ != nullptr) {
+        publishLevel<Side>(order.getFixedPrice(), order.getSymbol(), false);
+    }
+    index_.erase(order.getId());
+    nodePool_.destroy(node);
+}
+
+template<OrderSide Side>
+void OrderBook::reduceNode(OrderNode* node, uint64_t quantity) {
+    const Order& order = node->order;
+    ladder<Side>().reduce(node, quantity);
+    if (marketData_ != nullptr) {
+        publishLevel<Side>(order.getFixedPrice(), order.getSymbol(), false);
+    }
+}
+
+template<OrderSide Side>
+void OrderBook::publishLevel(Price price, SymbolId symbol, bool added) {
+    const PriceLevel& level = ladder<Side>().levelAt(price);
+
+    MarketDataType type = MarketDataType::LevelUpdate;
+    if (level.empty()) {
+        type = MarketDataType::LevelDelete;
+    } else if (added && level.orderCount == 1) {
+        type = MarketDataType::LevelAdd;
+    }
+
+    marketData_->onEvent(MarketDataEvent{0, type, Side, symbol, price, level.totalQuantity,
+                                         level.orderCount, 0, 0});
+}
+
 #endif // ORDERBOOK_H
@@ -0,0 +1,67 @@
+#ifndef ORDEREVENTFILE_H
+#define ORDEREVENTFILE_H
+
+#include "MappedFile.h"
+#include "OrderMessage.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size binary order event as stored in a replay file
+struct OrderEventRecord {
+    int64_t timestampNs;    // Original arrival time; only differences matter
+    uint64_t orderId;
+    int64_t priceRaw;       // Price::raw(); unused for cancels
+    uint64_t quantity;      // Unused for cancels
+    uint32_t symbol;
+    uint8_t type;           // MessageType
+    uint8_t side;           // OrderSide; unused for cancels and modifies
+    uint8_t orderType;      // OrderType; zero (Limit) for cancels and modifies
+    uint8_t timeInForce;    // TimeInForce; zero (GoodTillCancel) for cancels and modifies
+};
+
+static_assert(std::is_trivially_copyable<OrderEventRecord>::value, "OrderEventRecord is mapped raw");
+static_assert(sizeof(OrderEventRecord) == 40, "OrderEventRecord layout is part of the file format");
+
+// File header preceding the records of an event file
+struct OrderEventHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+// Encode an instruction with its arrival time
+OrderEventRecord toOrderEventRecord(const OrderMessage& message, int64_t timestampNs);
+
+// Decode a record back into an instruction. Returns false, leaving message
+// untouched, if the record holds an unknown message type, side, order type
+// or time in force, or a quantity outside 1..Order::kMaxQuantity (0 is
+// allowed for a modify, which cancels).
+bool toOrderMessage(const OrderEventRecord& record, OrderMessage& message);
+
+// Write a complete event file. Returns false on I/O failure.
+bool writeOrderEventFile(const std::string& path, const std::vector<OrderEventRecord>& records);
+
+// Read-only memory mapping of an event file. Records are used in place, so
+// replay does no parsing and no per-event I/O.
+class MappedOrderEventFile {
+public:
+    // Map a file. Returns false if it cannot be opened or its header does
+    // not match this build's format.
+    bool open(const std::string& path);
+
+    void close();
+
+    const OrderEventRecord* records() const { return records_; }
+
+    size_t size() const { return count_; }
+
+private:
+    MappedFile file_;
+    const OrderEventRecord* records_ = nullptr;
+    size_t count_ = 0;
+};
+
+#endif // ORDEREVENTFILE_H
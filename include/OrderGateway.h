@@ -0,0 +1,198 @@
+#ifndef ORDERGATEWAY_H
+#define ORDERGATEWAY_H
+
+#include "ConcurrentQueue.h"
+#include "GatewayProtocol.h"
+#include "MulticastRing.h"
+#include "OrderMessage.h"
+#include "PreTradeRisk.h"
+#include "SymbolDirectory.h"
+#include "Trade.h"
+#include "TradeBus.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Order-entry gateway: one thread accepts client connections on a Unix
+// domain socket, multiplexes them with epoll, decodes the binary protocol
+// of GatewayProtocol.h straight from each connection's receive buffer and
+// pushes the resulting instructions to the engine queue in batches. It acks
+// or rejects every request and reports executions of each client's orders
+// back to that client.
+//
+// Fills reach the gateway as a reader of each engine thread's TradeBus (see
+// addFillSource()), so engine threads never touch a socket. Engine order ids
+// carry the owning connection's slot in their low bits, which lets a fill
+// be routed without any per-order lookup table. The slot is also the
+// account the connection's orders are booked to for pre-trade risk.
+//
+// Behind a risk stage (see setRiskDecisions()) a request is only answered
+// once risk has decided on it. The gateway is the stage's only producer, so
+// decisions come back in the order requests were forwarded and a FIFO of
+// pending answers pairs them up without any lookup.
+class OrderGateway {
+public:
+    static constexpr unsigned kConnectionBits = 10;
+    static constexpr size_t kMaxConnections = size_t(1) << kConnectionBits;
+
+    OrderGateway(const SymbolDirectory& symbols, const std::string& socketPath);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    // Create, bind and listen on the socket (replacing a stale socket file).
+    // Returns false and sets getError() on failure.
+    bool open();
+
+    const std::string& getError() const { return error_; }
+
+    // Relay the fills of one engine thread to the owning clients, as a
+    // gating reader of its bus. Call before the engines start. Returns false
+    // if the bus has no free reader slot.
+    bool addFillSource(TradeBus& bus);
+
+    // Answer forwarded requests by the decisions of the risk stage that
+    // queue feeds, read as a gating reader of its decision bus: an Ack if
+    // risk passed the request, a RiskLimit Reject if it refused it. Call
+    // before run(). Returns false if the bus has no free reader slot.
+    bool setRiskDecisions(MulticastRing<RiskDecision>& decisions);
+
+    // First engine order id to hand out (e.g. after crash recovery). Call
+    // before run().
+    void setNextOrderId(uint64_t id);
+
+    // Serve clients until stop(). queue receives every accepted
+    // instruction; this thread must be its only producer.
+    void run(QueueWriter<OrderMessage>& queue);
+
+    void stop() { running_ = false; }
+
+    // Requests forwarded to the engine (or risk stage), and requests rejected
+    uint64_t getAcceptedCount() const { return accepted_.load(std::memory_order_relaxed); }
+    uint64_t getRejectedCount() const { return rejected_.load(std::memory_order_relaxed); }
+
+    // Currently connected clients
+    size_t getConnectionCount() const { return connected_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kReceiveBufferSize = 1 << 16;
+    static constexpr size_t kMaxPendingOutput = 8 << 20;
+    static constexpr size_t kMaxBatchSize = 256;
+
+    // Clients are not read while this many requests await a risk decision:
+    // their sockets leave the epoll set until relayed decisions make room.
+    // One read adds at most a receive buffer of the smallest request, so the
+    // pending FIFO, the risk queue and the decision bus stay below their
+    // capacities and neither thread can end up waiting on the other.
+    static constexpr size_t kMaxPendingAnswers = 1 << 14;
+    static constexpr size_t kPendingAnswerCapacity = 1 << 15;
+    static_assert(kMaxPendingAnswers + kReceiveBufferSize / sizeof(WireCancel) <= kPendingAnswerCapacity,
+                  "one read must fit in the pending FIFO");
+
+    struct Connection {
+        int fd = -1;
+        uint64_t firstOrderId = 0;  // Ids below this belong to earlier occupants of the slot
+        std::vector<char> input;
+        size_t inputSize = 0;
+        std::vector<char> output;
+        size_t outputOffset = 0;    // Bytes of output already written
+        bool waitingWritable = false;
+        bool dirty = false;         // Listed in dirty_
+        bool paused = false;        // Out of the epoll set and listed in paused_
+    };
+
+    const SymbolDirectory& symbols_;
+    std::string socketPath_;
+    std::string error_;
+    int listenFd_;
+    int epollFd_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> rejected_;
+    std::atomic<size_t> connected_;
+
+    // Request forwarded to risk and not answered yet
+    struct PendingAnswer {
+        size_t slot;
+        uint64_t clientOrderId;
+        uint64_t orderId;
+    };
+
+    std::vector<TradeBusReader> fillReaders_;
+    MulticastRing<RiskDecision>* decisions_;    // Null if requests are acked on forwarding
+    MulticastRing<RiskDecision>::ReaderId decisionReader_;
+    std::vector<PendingAnswer> pending_;        // FIFO ring of kPendingAnswerCapacity
+    uint64_t pendingHead_;                      // Oldest unanswered entry
+    uint64_t pendingTail_;                      // Next entry to fill
+    std::vector<Connection> connections_;
+    std::vector<size_t> freeSlots_;
+    std::vector<size_t> dirty_;         // Connections with unwritten output
+    std::vector<size_t> paused_;        // Connections not read until the FIFO has room
+    QueueWriter<OrderMessage>* queue_;  // Set by run()
+    std::vector<OrderMessage> batch_;   // Decoded instructions not yet pushed
+    uint64_t nextSequence_;             // Engine id = sequence << kConnectionBits | slot
+    int64_t receivedNs_;                // Ingest stamp of the bytes being decoded
+
+    void acceptClients();
+
+    // Read everything available and decode complete messages. Returns
+    // false if the connection was closed.
+    bool readClient(size_t slot);
+
+    // Stop polling a client while the pending FIFO is full
+    void pauseClient(size_t slot);
+
+    // Poll paused clients again once the pending FIFO has room
+    void resumeClients();
+
+    // Register or update the epoll events a client waits for. Returns
+    // false if epoll refused.
+    bool watchClient(size_t slot, int operation);
+
+    // Decode one request. Returns false for a malformed message.
+    bool handleMessage(size_t slot, const char* data, size_t length);
+
+    // Add an instruction to the batch, pushing the batch once it is full
+    void enqueue(const OrderMessage& message);
+
+    void pushBatch();
+
+    void handleNewOrder(size_t slot, const WireNewOrder& request);
+    void handleCancel(size_t slot, const WireCancel& request);
+    void handleModify(size_t slot, const WireModify& request);
+
+    // Ack a forwarded request now, or once risk has decided on it
+    void answer(size_t slot, uint64_t clientOrderId, uint64_t orderId);
+
+    // Answer every request risk has decided on so far
+    void relayDecisions();
+
+    void relayFills();
+
+    // Whether orderId was issued to the client in slot
+    bool owns(size_t slot, uint64_t orderId) const;
+
+    void sendAck(size_t slot, uint64_t clientOrderId, uint64_t orderId);
+    void sendReject(size_t slot, uint64_t clientOrderId, RejectReason reason,
+                    RiskReject riskReason = RiskReject::None);
+
+    template<typename T>
+    void send(size_t slot, const T& message);
+
+    // Write pending output of every dirty connection
+    void flushClients();
+
+    // Returns false if the connection had to be closed
+    bool flushClient(size_t slot);
+
+    void closeClient(size_t slot);
+};
+
+// Connect to a gateway socket. Returns the connected descriptor or -1.
+int connectToGateway(const std::string& socketPath);
+
+#endif // ORDERGATEWAY_H
@@ -0,0 +1,110 @@
+#ifndef ORDERINDEX_H
+#define ORDERINDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct OrderNode;
+
+// Open-addressing hash map from order id to resting order node.
+// Linear probing with backward-shift deletion, so there are no tombstones
+// and lookups stay short under heavy cancel traffic.
+class OrderIndex {
+public:
+    explicit OrderIndex(size_t initialCapacity = 1024) : size_(0) {
+        size_t capacity = 16;
+        while (capacity < initialCapacity * 2) {
+            capacity <<= 1;
+        }
+        slots_.resize(capacity);
+        mask_ = capacity - 1;
+    }
+
+    // Find the node for an id, or nullptr
+    OrderNode* find(uint64_t id) const {
+        for (size_t i = slotFor(id);; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (slot.node == nullptr) return nullptr;
+            if (slot.id == id) return slot.node;
+        }
+    }
+
+    // Insert an id that is not already present
+    void insert(uint64_t id, OrderNode* node) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        size_t i = slotFor(id);
+        while (slots_[i].node != nullptr) {
+            i = (i + 1) & mask_;
+        }
+        slots_[i] = Slot{id, node};
+        size_++;
+    }
+
+    // Remove an id. Returns false if it was not present.
+    bool erase(uint64_t id) {
+        size_t i = slotFor(id);
+        while (true) {
+            if (slots_[i].node == nullptr) return false;
+            if (slots_[i].id == id) break;
+            i = (i + 1) & mask_;
+        }
+
+        // Shift later entries of the probe chain back into the hole
+        size_t hole = i;
+        for (size_t j = (i + 1) & mask_; slots_[j].node != nullptr; j = (j + 1) & mask_) {
+            size_t home = slotFor(slots_[j].id);
+            if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+        }
+        slots_[hole] = Slot{};
+        size_--;
+        return true;
+    }
+
+    size_t size() const { return size_; }
+
+    // Visit every stored node
+    template<typename Func>
+    void forEach(Func&& func) const {
+        for (const auto& slot : slots_) {
+            if (slot.node != nullptr) {
+                func(slot.node);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint64_t id = 0;
+        OrderNode* node = nullptr;
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    size_t size_;
+
+    size_t slotFor(uint64_t id) const {
+        // Fibonacci hashing spreads sequential ids across the table
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.resize(old.size() * 2);
+        mask_ = slots_.size() - 1;
+        size_ = 0;
+        for (const auto& slot : old) {
+            if (slot.node != nullptr) {
+                insert(slot.id, slot.node);
+            }
+        }
+    }
+};
+
+#endif // ORDERINDEX_H
@@ -0,0 +1,58 @@
+#ifndef ORDERMESSAGE_H
+#define ORDERMESSAGE_H
+
+#include "Order.h"
+#include "Price.h"
+#include <chrono>
+#include <cstdint>
+
+// Trading account an order is booked to, for pre-trade risk limits.
+// Accounts are small dense integers, like SymbolId.
+using AccountId = uint32_t;
+
+enum class MessageType : uint8_t {
+    New,
+    Cancel,
+    Modify
+};
+
+// Instruction carried from producers to the engine. For Cancel only the
+// order id and symbol are meaningful; for Modify the id, symbol, new price
+// and new quantity. The symbol is what the router uses to pick a shard.
+// ingestNs is the steady-clock time at which the instruction entered the
+// process, stamped once by the producer or gateway (0 if never stamped).
+// account is only read for New; the risk stage remembers it per order.
+// Quantities must already be range-checked (see Order::kMaxQuantity): the
+// engine, and the book's own modify guard, only ever see the narrowed value.
+struct OrderMessage {
+    Order order;
+    int64_t ingestNs;
+    MessageType type;
+    AccountId account;
+
+    OrderMessage(MessageType t, const Order& o) : order(o), ingestNs(0), type(t), account(0) {}
+
+    static OrderMessage newOrder(const Order& order, AccountId account = 0) {
+        OrderMessage message(MessageType::New, order);
+        message.account = account;
+        return message;
+    }
+
+    static OrderMessage cancel(uint64_t id, SymbolId symbol = 0) {
+        return OrderMessage(MessageType::Cancel, Order(id, OrderSide::Buy, Price(), 0, symbol));
+    }
+
+    static OrderMessage modify(uint64_t id, Price newPrice, uint64_t newQuantity,
+                               SymbolId symbol = 0) {
+        return OrderMessage(MessageType::Modify,
+                            Order(id, OrderSide::Buy, newPrice, newQuantity, symbol));
+    }
+};
+
+// Current steady-clock time in nanoseconds, the unit of OrderMessage::ingestNs
+inline int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // ORDERMESSAGE_H
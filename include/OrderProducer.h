@@ -2,18 +2,31 @@
 #define ORDERPRODUCER_H
 
 #include "Order.h"
-#include "ThreadSafeQueue.h"
+#include "OrderMessage.h"
+#include "ConcurrentQueue.h"
+#include "SymbolDirectory.h"
+#include "OrderTextParser.h"
 #include <atomic>
 #include <memory>
+#include <string>
 
 enum class ProducerMode {
     Random,
-    Stdin
+    Stdin,
+    Replay,
+    Stream      // Bulk text ingestion from a file or pipe
+};
+
+// Source and pacing of replay and stream mode
+struct ReplayConfig {
+    std::string path;         // Binary event file (replay) or text orders (stream; "-" is stdin)
+    bool recordedPace = false; // Honour recorded inter-arrival times instead of full speed
 };
 
 class OrderProducer {
 public:
-    OrderProducer(ThreadSafeQueue<Order>& queue, ProducerMode mode);
+    OrderProducer(QueueWriter<OrderMessage>& queue, ProducerMode mode,
+                  const SymbolDirectory& symbols, const ReplayConfig& replay = ReplayConfig());
 
     // Run the producer thread
     void run();
@@ -21,17 +34,57 @@ public:
     // Stop the producer
     void stop();
 
+    // Continue order numbering from id so recovered orders keep unique ids.
+    // Call before run().
+    void setNextOrderId(uint64_t id) {
+        nextOrderId_ = id;
+        textParser_.setNextOrderId(id);
+    }
+
+    // Events pushed by replay or stream mode so far
+    uint64_t getReplayedCount() const { return replayed_.load(std::memory_order_relaxed); }
+
+    // Replay records or stream lines skipped because they do not decode to a
+    // valid instruction
+    uint64_t getSkippedCount() const { return skipped_.load(std::memory_order_relaxed); }
+
 private:
-    ThreadSafeQueue<Order>& queue_;
+    QueueWriter<OrderMessage>& queue_;
     ProducerMode mode_;
+    const SymbolDirectory& symbols_;
     std::atomic<bool> running_;
     std::atomic<uint64_t> nextOrderId_;
+    ReplayConfig replay_;
+    std::atomic<uint64_t> replayed_;
+    std::atomic<uint64_t> skipped_;
 
     // Generate a random order
     Order generateRandomOrder();
 
-    // Read an order from stdin
-    bool readOrderFromStdin(Order& order);
+    // Generate a random new order or, occasionally, a cancel of an earlier one
+    OrderMessage generateRandomMessage();
+
+    // Read a new/cancel/modify instruction from stdin
+    bool readMessageFromStdin(OrderMessage& message);
+
+    // Push every event of the replay file, then return
+    void runReplay();
+
+    // Parse the text input block by block and push it in batches, then return
+    void runStream();
+
+    // Parses text lines and tracks each order's symbol for CANCEL/MODIFY
+    OrderTextParser textParser_;
+
+    // Random mode spreads orders over symbols by id so cancels can be routed
+    SymbolId randomSymbolFor(uint64_t orderId) const {
+        return static_cast<SymbolId>(orderId % symbols_.size());
+    }
+
+    static constexpr size_t kStreamBatchSize = 256;
+
+    // Random orders are spread over this many accounts
+    static constexpr AccountId kRandomAccounts = 8;
 };
 
 #endif // ORDERPRODUCER_H
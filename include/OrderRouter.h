@@ -0,0 +1,45 @@
+#ifndef ORDERROUTER_H
+#define ORDERROUTER_H
+
+#include "ConcurrentQueue.h"
+#include "OrderMessage.h"
+#include "SymbolDirectory.h"
+#include <atomic>
+#include <vector>
+
+// Dispatches instructions to the inbound queue of the shard that owns the
+// message's symbol. Symbols are assigned to shards round-robin by id.
+// Call push() from a single producer thread so each shard queue keeps a
+// single writer.
+class OrderRouter : public QueueWriter<OrderMessage> {
+public:
+    OrderRouter(const SymbolDirectory& directory,
+                const std::vector<ConcurrentQueue<OrderMessage>*>& shardQueues);
+
+    // Shard that owns a symbol for a given shard count
+    static size_t shardFor(SymbolId symbol, size_t shardCount) { return symbol % shardCount; }
+
+    // Route one instruction. Messages for unknown symbols are counted and dropped.
+    void push(const OrderMessage& message) override;
+
+    // Route instructions in order, handing each run that goes to the same
+    // shard to its queue as one batch
+    void pushBatch(const OrderMessage* messages, size_t count) override;
+
+    // pushBatch() that stops, without waiting, at the first instruction
+    // whose shard queue is full. Returns the number routed or dropped.
+    size_t tryPushBatch(const OrderMessage* messages, size_t count) override;
+
+    // Total instructions waiting in all shard queues
+    size_t pendingCount() const;
+
+    // Messages dropped because their symbol is not in the directory
+    uint64_t getRejectedCount() const { return rejected_.load(std::memory_order_relaxed); }
+
+private:
+    const SymbolDirectory& directory_;
+    std::vector<ConcurrentQueue<OrderMessage>*> shardQueues_;
+    std::atomic<uint64_t> rejected_;
+};
+
+#endif // ORDERROUTER_H
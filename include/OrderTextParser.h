@@ -0,0 +1,82 @@
+#ifndef ORDERTEXTPARSER_H
+#define ORDERTEXTPARSER_H
+
+#include "OrderMessage.h"
+#include "SymbolDirectory.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class ParseStatus {
+    Message,   // A new/cancel/modify instruction was parsed
+    Blank,     // Nothing on the line
+    Quit,      // "quit" or "exit"
+    Error      // Malformed line; see getError()
+};
+
+// Parser for the text order format shared by stdin mode, stream mode and
+// the event file converter:
+//   [timestamp_ns] <BUY|SELL> <price|MARKET> <quantity> [id] [symbol] [GTC|IOC|FOK]
+//   [timestamp_ns] CANCEL <id>
+//   [timestamp_ns] MODIFY <id> <price> <quantity>
+// Columns are separated by spaces, tabs or commas, so CSV dumps parse as
+// is, and keywords are case-insensitive. New orders get sequential ids
+// unless a numeric id column is given. The parser remembers each order's
+// symbol so that CANCEL and MODIFY are routed to the right book.
+//
+// Lines are tokenized in place and numbers are parsed by hand, prices
+// straight to fixed point (digits beyond the fourth decimal round half
+// up), so parsing a valid line does not allocate.
+class OrderTextParser {
+public:
+    explicit OrderTextParser(const SymbolDirectory& symbols, uint64_t firstOrderId = 1);
+
+    // Parse one line into message. timestampNs is set when the line starts
+    // with a timestamp and left untouched otherwise.
+    ParseStatus parse(std::string_view line, OrderMessage& message, int64_t& timestampNs);
+
+    ParseStatus parse(std::string_view line, OrderMessage& message) {
+        int64_t ignored = 0;
+        return parse(line, message, ignored);
+    }
+
+    // Description of the last Error result
+    const std::string& getError() const { return error_; }
+
+    // Id the next new order will receive
+    uint64_t getNextOrderId() const { return nextOrderId_; }
+
+    // Continue numbering from id (e.g. after crash recovery)
+    void setNextOrderId(uint64_t id) { nextOrderId_ = id; }
+
+private:
+    const SymbolDirectory& symbols_;
+    uint64_t nextOrderId_;
+    std::string error_;
+
+    // Symbol of each order id, kept only when there is more than one
+    // symbol. Ids below kDenseIdLimit live in a flat vector that grows
+    // geometrically; larger explicit ids fall back to a hash map.
+    static constexpr uint64_t kDenseIdLimit = 1 << 24;
+    std::vector<SymbolId> denseSymbols_;
+    std::unordered_map<uint64_t, SymbolId> sparseSymbols_;
+
+    ParseStatus fail(const std::string& error) {
+        error_ = error;
+        return ParseStatus::Error;
+    }
+
+    SymbolId symbolOf(uint64_t id) const {
+        if (id < denseSymbols_.size()) {
+            return denseSymbols_[id];
+        }
+        auto known = sparseSymbols_.find(id);
+        return known != sparseSymbols_.end() ? known->second : 0;
+    }
+
+    void rememberSymbol(uint64_t id, SymbolId symbol);
+};
+
+#endif // ORDERTEXTPARSER_H
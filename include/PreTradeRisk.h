@@ -0,0 +1,120 @@
+#ifndef PRETRADERISK_H
+#define PRETRADERISK_H
+
+#include "OrderMessage.h"
+#include "Price.h"
+#include "SymbolDirectory.h"
+#include "Trade.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+enum class RiskReject : uint8_t {
+    None = 0,
+    UnknownAccount,     // Account id at or above RiskLimits::accountCount
+    UnknownSymbol,      // Symbol id not in the directory
+    OrderTooLarge,      // Quantity above RiskLimits::maxOrderQuantity
+    InvalidPrice,       // Limit price off the symbol's tick grid or outside its band
+    PriceOutsideCollar, // Limit price too far from the symbol's last trade
+    OpenQuantityLimit,  // Account's open quantity would exceed its limit
+    NotionalLimit,      // Account's open notional would exceed its limit
+    DuplicateOrderId    // Id of an order that is still open
+};
+
+constexpr size_t kRiskRejectCount = 9;
+
+// Short name of a reject reason, for logs and reports
+const char* toString(RiskReject reason);
+
+// Outcome of the risk check of one instruction, published in input order
+// for the stage's producer (the gateway acks or rejects its clients by it)
+struct RiskDecision {
+    uint64_t orderId;
+    RiskReject reason;  // None if the instruction was forwarded
+};
+
+struct RiskLimits {
+    size_t accountCount = 1024;         // Valid accounts are 0 .. accountCount-1
+    uint64_t maxOrderQuantity = 100000;
+    double priceCollar = 0.10;          // Max distance from last trade as a fraction; 0 disables
+    uint64_t maxOpenQuantity = 10000000;
+    double maxOpenNotional = 1e9;       // Sum of price * quantity
+};
+
+// Open exposure of one account
+struct AccountExposure {
+    uint64_t openQuantity = 0;
+    uint64_t openNotional = 0;          // Price::raw() * quantity
+};
+
+// Pre-trade risk checks and the per-account exposure they are made
+// against. Single-threaded: the risk stage thread owns it and feeds it both
+// the instructions it checks and the fills that come back from the engines.
+//
+// Instructions the engines would drop (unknown symbol, limit price the
+// book's TickConfig rejects) are rejected here before they reach exposure.
+// Exposure counts resting (GTC limit) orders from acceptance until they are
+// filled, cancelled or modified to zero; non-resting orders are checked
+// against it but never added, since they cannot outlive their match. All
+// updates are O(1): one hash lookup for the order and a vector index for the
+// account. The view runs ahead of the engines by the instructions in flight
+// and behind them by the fills in flight. Orders the stage never saw, e.g.
+// restored from a snapshot, are not tracked; their cancels and modifies pass
+// through unchecked.
+class PreTradeRisk {
+public:
+    PreTradeRisk(const SymbolDirectory& directory, const RiskLimits& limits);
+
+    // Check an instruction and, if it passes, apply it to the exposure
+    RiskReject check(const OrderMessage& message);
+
+    // Release the filled quantity of both orders and move the symbol's
+    // collar to the trade price
+    void applyFill(const Trade& trade);
+
+    const AccountExposure& getExposure(AccountId account) const { return accounts_[account]; }
+
+    // Orders currently counted in some account's exposure
+    size_t getOpenOrderCount() const { return open_.size(); }
+
+private:
+    struct OpenOrder {
+        AccountId account;
+        int64_t priceRaw;
+        uint64_t quantity;
+    };
+
+    // Last trade of a symbol and the band of limit prices accepted around it
+    struct Collar {
+        bool active = false;            // False until the symbol first trades
+        int64_t lastRaw = 0;
+        int64_t low = 0;
+        int64_t high = 0;
+    };
+
+    RiskLimits limits_;
+    uint64_t maxOpenNotional_;          // limits_.maxOpenNotional in raw units
+    std::vector<AccountExposure> accounts_;
+    std::vector<TickConfig> ticks_;     // Indexed by SymbolId
+    std::vector<Collar> collars_;       // Indexed by SymbolId
+    std::unordered_map<uint64_t, OpenOrder> open_;
+
+    RiskReject checkNew(const OrderMessage& message);
+    RiskReject checkModify(const OrderMessage& message);
+
+    // Whether a limit price lies inside the symbol's collar; always true
+    // before the symbol's first trade
+    bool insideCollar(SymbolId symbol, Price price) const;
+
+    // Reject reason if adding quantity and notional would take the account
+    // over a limit, otherwise None
+    RiskReject checkHeadroom(const AccountExposure& exposure, uint64_t quantity,
+                             uint64_t notional) const;
+
+    // Remove quantity of an open order from its account, forgetting the
+    // order once nothing is left
+    void release(std::unordered_map<uint64_t, OpenOrder>::iterator order, uint64_t quantity);
+};
+
+#endif // PRETRADERISK_H
@@ -0,0 +1,68 @@
+#ifndef PRICE_H
+#define PRICE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+// Fixed-point price with four implied decimal places (1.0 == 10000 raw units).
+// All book keys and price comparisons use the raw integer, so prices such as
+// 100.1 and 100.10000001 map to the same value.
+class Price {
+public:
+    static constexpr int64_t kScale = 10000;
+
+    constexpr Price() : raw_(0) {}
+
+    static constexpr Price fromRaw(int64_t raw) { return Price(raw); }
+    static Price fromDouble(double value) { return Price(std::llround(value * kScale)); }
+
+    constexpr int64_t raw() const { return raw_; }
+    double toDouble() const { return static_cast<double>(raw_) / kScale; }
+
+    constexpr bool operator==(Price other) const { return raw_ == other.raw_; }
+    constexpr bool operator!=(Price other) const { return raw_ != other.raw_; }
+    constexpr bool operator<(Price other) const { return raw_ < other.raw_; }
+    constexpr bool operator<=(Price other) const { return raw_ <= other.raw_; }
+    constexpr bool operator>(Price other) const { return raw_ > other.raw_; }
+    constexpr bool operator>=(Price other) const { return raw_ >= other.raw_; }
+
+    constexpr Price operator+(Price other) const { return Price(raw_ + other.raw_); }
+    constexpr Price operator-(Price other) const { return Price(raw_ - other.raw_); }
+
+private:
+    explicit constexpr Price(int64_t raw) : raw_(raw) {}
+
+    int64_t raw_;
+};
+
+// Tick size and tradable price band of an instrument. Valid prices are
+// minPrice + k * tickSize for k in [0, levelCount()).
+struct TickConfig {
+    Price tickSize = Price::fromDouble(0.01);
+    Price minPrice = Price::fromDouble(0.01);
+    Price maxPrice = Price::fromDouble(1000.00);
+
+    // Number of price levels in the band
+    size_t levelCount() const {
+        return static_cast<size_t>((maxPrice.raw() - minPrice.raw()) / tickSize.raw()) + 1;
+    }
+
+    // Check that a price lies inside the band and on a tick boundary
+    bool isValid(Price price) const {
+        return price >= minPrice && price <= maxPrice &&
+               (price.raw() - minPrice.raw()) % tickSize.raw() == 0;
+    }
+
+    // Convert a valid price to its tick offset from minPrice
+    size_t toIndex(Price price) const {
+        return static_cast<size_t>((price.raw() - minPrice.raw()) / tickSize.raw());
+    }
+
+    // Convert a tick offset back to a price
+    Price toPrice(size_t index) const {
+        return Price::fromRaw(minPrice.raw() + static_cast<int64_t>(index) * tickSize.raw());
+    }
+};
+
+#endif // PRICE_H
@@ -0,0 +1,237 @@
+#ifndef PRICELADDER_H
+#define PRICELADDER_H
+
+#include "BookSnapshot.h"
+#include "LevelBitmap.h"
+#include "Order.h"
+#include "Price.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Resting order linked into its price level's FIFO queue
+struct OrderNode {
+    Order order;
+    OrderNode* prev;
+    OrderNode* next;
+
+    explicit OrderNode(const Order& o) : order(o), prev(nullptr), next(nullptr) {}
+};
+
+struct PriceLevel {
+    Price price;
+    uint64_t totalQuantity;
+    size_t orderCount;
+    OrderNode* head;   // Oldest order (first to match)
+    OrderNode* tail;   // Newest order
+
+    PriceLevel(Price p = Price())
+        : price(p), totalQuantity(0), orderCount(0), head(nullptr), tail(nullptr) {}
+
+    bool empty() const { return head == nullptr; }
+};
+
+// Everything that differs between the two sides of a book, resolved at
+// compile time so matching and ladder walks carry no side branches.
+template<OrderSide Side>
+struct SideTraits;
+
+template<>
+struct SideTraits<OrderSide::Buy> {
+    static constexpr OrderSide kOpposite = OrderSide::Sell;
+
+    // Limit of a market order: trades at any ask
+    static constexpr Price kMostAggressive = Price::fromRaw(std::numeric_limits<int64_t>::max());
+
+    // Whether price a ranks ahead of b among resting bids
+    static constexpr bool isBetter(Price a, Price b) { return a > b; }
+};
+
+template<>
+struct SideTraits<OrderSide::Sell> {
+    static constexpr OrderSide kOpposite = OrderSide::Buy;
+
+    // Limit of a market order: trades at any bid
+    static constexpr Price kMostAggressive = Price::fromRaw(std::numeric_limits<int64_t>::min());
+
+    // Whether price a ranks ahead of b among resting asks
+    static constexpr bool isBetter(Price a, Price b) { return a < b; }
+};
+
+// One side of the book stored as a contiguous array of price levels indexed
+// by tick offset from the bottom of the price band. The index of the best
+// non-empty level is tracked so top-of-book access is O(1), and a
+// hierarchical occupancy bitmap finds the next non-empty level in a few
+// instructions however sparse the band is.
+//
+// The side is a template parameter: bids and asks are distinct types whose
+// comparisons and walk direction are constants, and the code for a side is
+// written once.
+template<OrderSide Side>
+class PriceLadder {
+public:
+    using Traits = SideTraits<Side>;
+
+    explicit PriceLadder(const TickConfig& config)
+        : config_(config), occupied_(config.levelCount()), best_(kNoLevel), activeLevels_(0) {
+        levels_.reserve(config_.levelCount());
+        for (size_t i = 0; i < config_.levelCount(); ++i) {
+            levels_.emplace_back(config_.toPrice(i));
+        }
+    }
+
+    // Link an order node at the back of its price level
+    void add(OrderNode* node) {
+        size_t index = config_.toIndex(node->order.getFixedPrice());
+        auto& level = levels_[index];
+
+        if (level.empty()) {
+            activeLevels_++;
+            occupied_.set(index);
+            if (best_ == kNoLevel || isBetter(index, best_)) {
+                best_ = index;
+            }
+            level.head = node;
+        } else {
+            level.tail->next = node;
+        }
+
+        node->prev = level.tail;
+        node->next = nullptr;
+        level.tail = node;
+        level.orderCount++;
+        level.totalQuantity += node->order.getQuantity();
+    }
+
+    // Unlink an order node from its price level
+    void remove(OrderNode* node) {
+        size_t index = config_.toIndex(node->order.getFixedPrice());
+        auto& level = levels_[index];
+
+        if (node->prev != nullptr) {
+            node->prev->next = node->next;
+        } else {
+            level.head = node->next;
+        }
+        if (node->next != nullptr) {
+            node->next->prev = node->prev;
+        } else {
+            level.tail = node->prev;
+        }
+        node->prev = nullptr;
+        node->next = nullptr;
+
+        level.orderCount--;
+        level.totalQuantity -= node->order.getQuantity();
+
+        if (level.empty()) {
+            activeLevels_--;
+            occupied_.clear(index);
+            if (index == best_) {
+                best_ = nextWorse(index);
+            }
+        }
+    }
+
+    // Reduce a resting order's quantity in place, keeping its queue position
+    void reduce(OrderNode* node, uint64_t quantity) {
+        auto& level = levels_[config_.toIndex(node->order.getFixedPrice())];
+        level.totalQuantity -= quantity;
+        node->order.setQuantity(node->order.getQuantity() - quantity);
+    }
+
+    // Best non-empty level, or nullptr if this side is empty
+    PriceLevel* best() { return best_ == kNoLevel ? nullptr : &levels_[best_]; }
+    const PriceLevel* best() const { return best_ == kNoLevel ? nullptr : &levels_[best_]; }
+
+    // Get the top N non-empty levels, best first
+    std::vector<PriceLevel> top(size_t n) const {
+        std::vector<PriceLevel> result;
+        result.reserve(n);
+        forEachLevel(n, [&result](const PriceLevel& level) { result.push_back(level); });
+        return result;
+    }
+
+    // Write aggregates of up to n non-empty levels, best first, without
+    // allocating. Returns the number written.
+    size_t topSummary(LevelSummary* out, size_t n) const {
+        size_t count = 0;
+        forEachLevel(n, [out, &count](const PriceLevel& level) {
+            out[count++] = LevelSummary{level.price, level.totalQuantity, level.orderCount};
+        });
+        return count;
+    }
+
+    bool empty() const { return activeLevels_ == 0; }
+
+    // Whether a resting price on this side is at or inside limit, i.e. an
+    // opposite order limited at limit may trade with it
+    static constexpr bool reaches(Price price, Price limit) {
+        return !Traits::isBetter(limit, price);
+    }
+
+    // Quantity resting at prices no worse than limit, summed from the
+    // level aggregates. Stops early once wanted is reached, so the cost is
+    // bounded by the number of levels needed to cover it.
+    uint64_t availableQuantity(Price limit, uint64_t wanted) const {
+        uint64_t available = 0;
+        for (size_t i = best_; i != kNoLevel && available < wanted; i = nextWorse(i)) {
+            const PriceLevel& level = levels_[i];
+            if (!reaches(level.price, limit)) {
+                break;
+            }
+            available += level.totalQuantity;
+        }
+        return available;
+    }
+
+    // Visit every resting order, best level first and in queue order
+    // within each level
+    template<typename Func>
+    void forEachOrder(Func&& func) const {
+        forEachLevel(activeLevels_, [&func](const PriceLevel& level) {
+            for (const OrderNode* node = level.head; node != nullptr; node = node->next) {
+                func(node->order);
+            }
+        });
+    }
+
+    // Level holding a valid price
+    const PriceLevel& levelAt(Price price) const { return levels_[config_.toIndex(price)]; }
+
+private:
+    static constexpr size_t kNoLevel = LevelBitmap::npos;
+
+    TickConfig config_;
+    std::vector<PriceLevel> levels_;
+    LevelBitmap occupied_;      // Bit set for every non-empty level
+    size_t best_;
+    size_t activeLevels_;
+
+    // Whether index a has a better price than index b for this side
+    static constexpr bool isBetter(size_t a, size_t b) {
+        return Side == OrderSide::Buy ? a > b : a < b;
+    }
+
+    // Next non-empty level away from the top of book, or kNoLevel
+    size_t nextWorse(size_t index) const {
+        if constexpr (Side == OrderSide::Buy) {
+            return index == 0 ? kNoLevel : occupied_.findPrev(index - 1);
+        } else {
+            return occupied_.findNext(index + 1);
+        }
+    }
+
+    // Visit up to n non-empty levels, best first
+    template<typename Func>
+    void forEachLevel(size_t n, Func&& func) const {
+        for (size_t i = best_; i != kNoLevel && n > 0; i = nextWorse(i), --n) {
+            func(levels_[i]);
+        }
+    }
+};
+
+using BidLadder = PriceLadder<OrderSide::Buy>;
+using AskLadder = PriceLadder<OrderSide::Sell>;
+
+#endif // PRICELADDER_H
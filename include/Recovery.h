@@ -0,0 +1,112 @@
+#ifndef RECOVERY_H
+#define RECOVERY_H
+
+#include "Journal.h"
+#include "MatchingEngine.h"
+#include "Order.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// One resting order in a snapshot file
+struct SnapshotOrderRecord {
+    uint64_t orderId;
+    int64_t priceRaw;
+    uint64_t quantity;
+    uint32_t symbol;
+    uint8_t side;           // OrderSide
+    uint8_t reserved[3];
+};
+
+static_assert(std::is_trivially_copyable<SnapshotOrderRecord>::value, "SnapshotOrderRecord is written raw");
+static_assert(sizeof(SnapshotOrderRecord) == 32, "SnapshotOrderRecord layout is part of the snapshot format");
+
+// Resting orders of an engine thread's books at one journal position.
+// Orders are listed per book in the order OrderBook::forEachOrder visits
+// them, so re-adding them restores time priority.
+struct SnapshotData {
+    uint64_t journalSequence = 0;   // Last journaled instruction reflected in the orders
+    uint64_t nextOrderId = 1;       // One past the highest order id seen
+    std::vector<SnapshotOrderRecord> orders;
+};
+
+// Write a snapshot atomically (temporary file, fsync, rename)
+bool writeSnapshot(const std::string& path, const SnapshotData& snapshot);
+
+// Read a snapshot. Returns false if the file cannot be read or is not a
+// snapshot of this build's format.
+bool readSnapshot(const std::string& path, SnapshotData& snapshot);
+
+// Background snapshot writer. The engine thread captures the books and
+// hands the data over; encoding and disk I/O happen on this thread. If a
+// snapshot is still being written the engine simply tries again later.
+//
+// Given the journal the snapshot positions refer to, a snapshot is written
+// only once the journal is durable up to its sequence, so a crash can never
+// leave a snapshot that claims records the journal lost.
+class Snapshotter {
+public:
+    explicit Snapshotter(const std::string& path, const Journal* journal = nullptr);
+    ~Snapshotter();
+
+    Snapshotter(const Snapshotter&) = delete;
+    Snapshotter& operator=(const Snapshotter&) = delete;
+
+    void start();
+
+    // Write any pending snapshot and join the writer thread
+    void stop();
+
+    // Whether a new snapshot can be submitted without waiting
+    bool isIdle() const { return !busy_.load(std::memory_order_acquire); }
+
+    // Hand over a captured snapshot. Ignored unless isIdle().
+    void submit(SnapshotData&& snapshot);
+
+    // Snapshots written successfully so far
+    uint64_t getWrittenCount() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    std::string path_;
+    const Journal* journal_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    SnapshotData pending_;
+    bool hasPending_;
+    bool running_;
+    std::atomic<bool> busy_;
+    std::atomic<uint64_t> written_;
+
+    void writeLoop();
+
+    // Wait until the journal is durable through sequence. Returns false if
+    // the journal fails, or stop() is called first and it still is not.
+    bool waitForJournal(uint64_t sequence);
+};
+
+struct RecoveryResult {
+    bool ok = true;
+    std::string error;
+    uint64_t snapshotSequence = 0;  // Journal position of the loaded snapshot
+    uint64_t journalSequence = 0;   // Last journal record applied
+    uint64_t nextOrderId = 1;       // First id safe to hand out
+    size_t restoredOrders = 0;      // Orders loaded from the snapshot
+    size_t replayedEvents = 0;      // Journal records replayed after it
+};
+
+// Rebuild books from the latest snapshot plus the journal tail after it.
+// enginesBySymbol maps each SymbolId to the engine that owns its book (or
+// nullptr). Missing files count as empty. Fails if the journal does not
+// reach the snapshot's sequence or its tail does not continue right after
+// it. Replayed fills are not reported anywhere; they were recorded before
+// the crash.
+RecoveryResult recoverEngines(const std::string& snapshotPath, const std::string& journalPath,
+                              const std::vector<MatchingEngine*>& enginesBySymbol);
+
+#endif // RECOVERY_H
@@ -0,0 +1,104 @@
+#ifndef RISKSTAGE_H
+#define RISKSTAGE_H
+
+#include "ConcurrentQueue.h"
+#include "EngineShard.h"
+#include "MulticastRing.h"
+#include "OrderMessage.h"
+#include "PreTradeRisk.h"
+#include "SymbolDirectory.h"
+#include "TradeBus.h"
+#include "WaitStrategy.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Pipeline thread between the producer and the engine shards that runs
+// pre-trade risk checks. Producers push into getQueue(); the stage checks
+// each instruction against PreTradeRisk and forwards the ones that pass, in
+// order and in batches, to the downstream writer given to start() (normally
+// the router), of which it must be the only producer. Rejected instructions are counted by
+// reason and dropped; a producer that answers its own clients (the gateway)
+// learns each outcome from the decision bus (see setDecisionBus()).
+//
+// Fills come back as a reader of each engine thread's TradeBus (see
+// addFillSource()) and are applied before each batch is checked, and at
+// least every kIdleFillPollInterval while no input arrives, so the engines
+// never wait on the risk state and risk adds a pipeline stage rather than
+// latency on the matching thread.
+class RiskStage {
+public:
+    // Longest the risk thread waits for input before draining fills
+    static constexpr std::chrono::microseconds kIdleFillPollInterval{100};
+
+    RiskStage(const SymbolDirectory& directory, const RiskLimits& limits, QueueKind queueKind,
+              size_t maxBatchSize = EngineWorker::kDefaultMaxBatchSize);
+    ~RiskStage();
+
+    RiskStage(const RiskStage&) = delete;
+    RiskStage& operator=(const RiskStage&) = delete;
+
+    // Inbound queue; the producer or gateway is its only writer
+    ConcurrentQueue<OrderMessage>& getQueue() { return *queue_; }
+
+    // Learn about the fills of one engine thread as a gating reader of its
+    // bus. Call before the engines start. Returns false if the bus has no
+    // free reader slot.
+    bool addFillSource(TradeBus& bus);
+
+    // Publish the decision on every instruction, in input order, to
+    // decisions. Call before start().
+    void setDecisionBus(MulticastRing<RiskDecision>& decisions) { decisions_ = &decisions; }
+
+    // How the risk thread waits on an empty queue. Call before start().
+    void setWaitStrategy(WaitStrategy strategy) { queue_->setWaitStrategy(strategy); }
+
+    // Launch the risk thread, forwarding accepted instructions to
+    // downstream, pinned to the given core when core >= 0
+    void start(QueueWriter<OrderMessage>& downstream, int core = -1);
+
+    // Close the queue, forward what is left in it, join the risk thread and
+    // detach from the fill buses. Producers must have stopped pushing.
+    void stop();
+
+    // Instructions forwarded downstream
+    uint64_t getAcceptedCount() const { return accepted_.load(std::memory_order_relaxed); }
+
+    // Instructions rejected for a reason, or for any reason
+    uint64_t getRejectedCount(RiskReject reason) const {
+        return rejected_[static_cast<size_t>(reason)].load(std::memory_order_relaxed);
+    }
+    uint64_t getRejectedCount() const;
+
+    // Risk state; only safe to read once the thread is stopped
+    const PreTradeRisk& getRisk() const { return risk_; }
+
+private:
+    PreTradeRisk risk_;
+    QueueWriter<OrderMessage>* downstream_;  // Set by start()
+    std::unique_ptr<ConcurrentQueue<OrderMessage>> queue_;
+    std::vector<TradeBusReader> fillReaders_;
+    MulticastRing<RiskDecision>* decisions_;   // Null unless setDecisionBus() was called
+    size_t maxBatchSize_;
+    std::atomic<uint64_t> accepted_;
+    std::array<std::atomic<uint64_t>, kRiskRejectCount> rejected_;
+    std::thread thread_;
+
+    // Reused across batches so steady-state checking does not allocate
+    std::vector<OrderMessage> batch_;
+    std::vector<OrderMessage> forward_;
+
+    // Risk thread body
+    void run();
+
+    // Hand forward_ downstream, draining fills while it is full
+    void forwardBatch();
+
+    // Apply every fill the engines have reported so far
+    void drainFills();
+};
+
+#endif // RISKSTAGE_H
@@ -0,0 +1,280 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include "ConcurrentQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Head and tail live on separate cache lines, and each side keeps a
+// cached copy of the other side's index so the shared counter is only
+// reloaded when the ring looks full (producer) or empty (consumer). The
+// object's size is rounded up to whole cache lines, so the producer line
+// never shares with neighbouring data.
+//
+// The consumer polls with yields by default. Under the strategies that park
+// (Block, SpinThenPark) it raises a flag before sleeping, and a producer
+// takes the park mutex to wake it only when it sees that flag, so pushes
+// stay lock-free while the consumer is awake.
+template<typename T>
+class SpscRingBuffer final : public ConcurrentQueue<T> {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRingBuffer(size_t capacity = 65536)
+        : wait_(WaitStrategy::Yield), closed_(false), head_(0), cachedTail_(0), parked_(false),
+          tail_(0), cachedHead_(0) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        capacity_ = rounded;
+        mask_ = rounded - 1;
+        slots_.reset(new Slot[rounded]);
+
+        // Fault the slots in now rather than on the first lap of the ring
+        std::memset(static_cast<void*>(slots_.get()), 0, rounded * sizeof(Slot));
+    }
+
+    ~SpscRingBuffer() override {
+        while (tryPop().has_value()) {
+        }
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Try to push an item (non-blocking). Returns false if the ring is full.
+    bool tryPush(const T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == capacity_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == capacity_) {
+                return false;
+            }
+        }
+        new (slots_[tail & mask_].storage) T(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        wakeConsumer();
+        return true;
+    }
+
+    // Push an item, spinning while the ring is full
+    void push(const T& item) override {
+        while (!tryPush(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Push items in order, publishing the tail once per contiguous run of
+    // free slots. Spins while the ring is full.
+    void pushBatch(const T* items, size_t count) override {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        while (count > 0) {
+            size_t free = capacity_ - (tail - cachedHead_);
+            if (free == 0) {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                free = capacity_ - (tail - cachedHead_);
+                if (free == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+            }
+
+            size_t run = count < free ? count : free;
+            for (size_t i = 0; i < run; ++i) {
+                new (slots_[(tail + i) & mask_].storage) T(items[i]);
+            }
+            tail += run;
+            tail_.store(tail, std::memory_order_release);
+            wakeConsumer();
+            items += run;
+            count -= run;
+        }
+    }
+
+    // Push as many items as there are free slots, publishing the tail once
+    size_t tryPushBatch(const T* items, size_t count) override {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free = capacity_ - (tail - cachedHead_);
+        if (free < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            free = capacity_ - (tail - cachedHead_);
+        }
+
+        const size_t run = count < free ? count : free;
+        if (run == 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < run; ++i) {
+            new (slots_[(tail + i) & mask_].storage) T(items[i]);
+        }
+        tail_.store(tail + run, std::memory_order_release);
+        wakeConsumer();
+        return run;
+    }
+
+    // Pop an item, waiting while the ring is empty
+    T pop() override {
+        while (true) {
+            if (auto item = tryPop()) {
+                return std::move(*item);
+            }
+            waitForItems(head_.load(std::memory_order_relaxed));
+        }
+    }
+
+    // Try to pop an item (non-blocking)
+    std::optional<T> tryPop() override {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return std::nullopt;
+            }
+        }
+        T* slot = slots_[head & mask_].get();
+        std::optional<T> item(std::move(*slot));
+        slot->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return item;
+    }
+
+    // Drain up to maxItems, publishing the new head once for the whole
+    // batch. Waits while the ring is empty and open.
+    size_t popBatch(std::vector<T>& out, size_t maxItems) override {
+        return popBatchUntil(out, maxItems, Clock::time_point::max());
+    }
+
+    size_t popBatchFor(std::vector<T>& out, size_t maxItems,
+                       std::chrono::nanoseconds timeout) override {
+        return popBatchUntil(out, maxItems, Clock::now() + timeout);
+    }
+
+    // Number of queued items; safe to call from any thread without locking
+    size_t size() const override {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const override { return size() == 0; }
+
+    size_t capacity() const { return capacity_; }
+
+    void setWaitStrategy(WaitStrategy strategy) override {
+        wait_ = strategy;
+        parks_ = strategy == WaitStrategy::Block || strategy == WaitStrategy::SpinThenPark;
+    }
+    WaitStrategy getWaitStrategy() const override { return wait_; }
+
+    void close() override {
+        closed_.store(true, std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        parkCv_.notify_all();
+    }
+
+    bool isClosed() const override { return closed_.load(std::memory_order_acquire); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kCacheLineSize = 64;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    WaitStrategy wait_;
+    bool parks_ = false;                // Whether wait_ can put the consumer to sleep
+    std::atomic<bool> closed_;
+    std::mutex parkMutex_;
+    std::condition_variable parkCv_;
+
+    // Consumer side
+    alignas(kCacheLineSize) std::atomic<size_t> head_;
+    size_t cachedTail_;
+    std::atomic<bool> parked_;          // Consumer is asleep or about to be
+
+    // Producer side
+    alignas(kCacheLineSize) std::atomic<size_t> tail_;
+    size_t cachedHead_;
+
+    size_t popBatchUntil(std::vector<T>& out, size_t maxItems, Clock::time_point deadline) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            waitForItems(head, deadline);
+            if (head == cachedTail_) {
+                return 0;   // Closed and drained, or timed out
+            }
+        }
+
+        size_t count = cachedTail_ - head;
+        if (count > maxItems) {
+            count = maxItems;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            T* slot = slots_[(head + i) & mask_].get();
+            out.push_back(std::move(*slot));
+            slot->~T();
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Return once the ring holds an item past head, is closed or the
+    // deadline has passed, leaving the latest tail in cachedTail_
+    // (consumer thread). time_point::max() waits without a deadline.
+    void waitForItems(size_t head, Clock::time_point deadline = Clock::time_point::max()) {
+        const bool timed = deadline != Clock::time_point::max();
+        auto ready = [this, head] {
+            // Read closed first: once it is set, this tail includes every push
+            const bool closed = closed_.load(std::memory_order_acquire);
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            return head != cachedTail_ || closed;
+        };
+        auto readyOrExpired = [&ready, timed, deadline] {
+            return ready() || (timed && Clock::now() >= deadline);
+        };
+        waitUntil(wait_, readyOrExpired, [this, &ready, timed, deadline] {
+            std::unique_lock<std::mutex> lock(parkMutex_);
+            parked_.store(true, std::memory_order_relaxed);
+            // Pairs with the fence in wakeConsumer(): either the producer
+            // sees the flag or this thread sees its tail
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (timed) {
+                parkCv_.wait_until(lock, deadline, ready);
+            } else {
+                parkCv_.wait(lock, ready);
+            }
+            parked_.store(false, std::memory_order_relaxed);
+        });
+    }
+
+    // Wake a parked consumer after publishing a new tail (producer thread)
+    void wakeConsumer() {
+        if (!parks_) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(parkMutex_);
+            parkCv_.notify_one();
+        }
+    }
+};
+
+#endif // SPSCRINGBUFFER_H
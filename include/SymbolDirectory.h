@@ -0,0 +1,47 @@
+#ifndef SYMBOLDIRECTORY_H
+#define SYMBOLDIRECTORY_H
+
+#include "Order.h"
+#include "Price.h"
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct SymbolInfo {
+    std::string name;
+    TickConfig tickConfig;
+    size_t orderCapacity;   // Presized resting orders for the symbol's book
+};
+
+// Registry of tradable instruments. Symbol ids are dense, starting at 0, so
+// per-symbol state can be kept in plain vectors indexed by SymbolId.
+class SymbolDirectory {
+public:
+    SymbolDirectory() = default;
+
+    // Register a symbol, or return the existing id if the name is known
+    SymbolId add(const std::string& name, const TickConfig& tickConfig = TickConfig(),
+                 size_t orderCapacity = 1 << 16);
+
+    // Look up a symbol id by name without allocating, e.g. straight from a
+    // parsed view of an input line
+    std::optional<SymbolId> find(std::string_view name) const;
+
+    // Get a registered symbol's details
+    const SymbolInfo& get(SymbolId id) const { return symbols_[id]; }
+
+    bool contains(SymbolId id) const { return id < symbols_.size(); }
+
+    size_t size() const { return symbols_.size(); }
+
+private:
+    // A deque never moves its elements, so the names can key byName_ as
+    // views (C++17 unordered_map has no heterogeneous lookup)
+    std::deque<SymbolInfo> symbols_;
+    std::unordered_map<std::string_view, SymbolId> byName_;
+};
+
+#endif // SYMBOLDIRECTORY_H
@@ -0,0 +1,14 @@
+#ifndef THREADAFFINITY_H
+#define THREADAFFINITY_H
+
+// Pin the calling thread to one CPU core. Returns false if the platform does
+// not support hard affinity (e.g. macOS) or the core does not exist.
+bool pinCurrentThreadToCore(int core);
+
+// Fault in and lock every page the process has mapped and will map, so the
+// pipeline threads never stall on a page fault or swap-in. Call once the
+// books and queues are allocated. Returns false if the platform has no
+// mlockall or the memory lock limit is too low (see ulimit -l).
+bool lockProcessMemory();
+
+#endif // THREADAFFINITY_H
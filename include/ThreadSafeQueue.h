@@ -1,26 +1,33 @@
 #ifndef THREADSAFEQUEUE_H
 #define THREADSAFEQUEUE_H
 
+#include "ConcurrentQueue.h"
+#include <atomic>
+#include <chrono>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <optional>
 
+// Unbounded queue guarded by a mutex. The consumer parks on a condition
+// variable (WaitStrategy::Block, the default); the polling strategies poll
+// an atomic item count instead, so they never take the lock while waiting.
 template<typename T>
-class ThreadSafeQueue {
+class ThreadSafeQueue final : public ConcurrentQueue<T> {
 public:
-    ThreadSafeQueue() = default;
-    ~ThreadSafeQueue() = default;
+    ThreadSafeQueue() : count_(0), closed_(false), wait_(WaitStrategy::Block) {}
+    ~ThreadSafeQueue() override = default;
 
     // Delete copy constructor and assignment operator
     ThreadSafeQueue(const ThreadSafeQueue&) = delete;
     ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
 
     // Push an item to the queue
-    void push(const T& item) {
+    void push(const T& item) override {
         {
             std::lock_guard<std::mutex> lock(mutex_);
             queue_.push(item);
+            count_.store(queue_.size(), std::memory_order_release);
         }
         cv_.notify_one();
     }
@@ -29,38 +36,80 @@ public:
         {
             std::lock_guard<std::mutex> lock(mutex_);
             queue_.push(std::move(item));
+            count_.store(queue_.size(), std::memory_order_release);
+        }
+        cv_.notify_one();
+    }
+
+    // Push items in order under a single lock acquisition
+    void pushBatch(const T* items, size_t count) override {
+        if (count == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < count; ++i) {
+                queue_.push(items[i]);
+            }
+            count_.store(queue_.size(), std::memory_order_release);
         }
         cv_.notify_one();
     }
 
     // Pop an item from the queue (blocking)
-    T pop() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this] { return !queue_.empty(); });
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
+    T pop() override {
+        while (true) {
+            waitForItems();
+            if (auto item = tryPop()) {
+                return std::move(*item);
+            }
+        }
     }
 
     // Try to pop an item (non-blocking)
-    std::optional<T> tryPop() {
+    std::optional<T> tryPop() override {
         std::lock_guard<std::mutex> lock(mutex_);
         if (queue_.empty()) {
             return std::nullopt;
         }
         T item = std::move(queue_.front());
         queue_.pop();
+        count_.store(queue_.size(), std::memory_order_relaxed);
         return item;
     }
 
+    // Drain up to maxItems under a single lock acquisition. Waits while the
+    // queue is empty and open.
+    size_t popBatch(std::vector<T>& out, size_t maxItems) override {
+        return popBatchUntil(out, maxItems, Clock::time_point::max());
+    }
+
+    size_t popBatchFor(std::vector<T>& out, size_t maxItems,
+                       std::chrono::nanoseconds timeout) override {
+        return popBatchUntil(out, maxItems, Clock::now() + timeout);
+    }
+
+    void setWaitStrategy(WaitStrategy strategy) override { wait_ = strategy; }
+    WaitStrategy getWaitStrategy() const override { return wait_; }
+
+    void close() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    bool isClosed() const override { return closed_.load(std::memory_order_acquire); }
+
     // Get the current size of the queue
-    size_t size() const {
+    size_t size() const override {
         std::lock_guard<std::mutex> lock(mutex_);
         return queue_.size();
     }
 
     // Check if the queue is empty
-    bool empty() const {
+    bool empty() const override {
         std::lock_guard<std::mutex> lock(mutex_);
         return queue_.empty();
     }
@@ -69,6 +118,54 @@ private:
     mutable std::mutex mutex_;
     std::condition_variable cv_;
     std::queue<T> queue_;
+    std::atomic<size_t> count_;     // queue_.size(), for lock-free polling
+    std::atomic<bool> closed_;
+    WaitStrategy wait_;
+
+    using Clock = std::chrono::steady_clock;
+
+    size_t popBatchUntil(std::vector<T>& out, size_t maxItems, Clock::time_point deadline) {
+        while (true) {
+            waitForItems(deadline);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty()) {
+                if (closed_ || (deadline != Clock::time_point::max() && Clock::now() >= deadline)) {
+                    return 0;
+                }
+                continue;
+            }
+            size_t count = 0;
+            while (count < maxItems && !queue_.empty()) {
+                out.push_back(std::move(queue_.front()));
+                queue_.pop();
+                count++;
+            }
+            count_.store(queue_.size(), std::memory_order_relaxed);
+            return count;
+        }
+    }
+
+    // Return once the queue holds an item, is closed or the deadline has
+    // passed; time_point::max() waits without a deadline
+    void waitForItems(Clock::time_point deadline = Clock::time_point::max()) {
+        const bool timed = deadline != Clock::time_point::max();
+        auto ready = [this] { return !queue_.empty() || closed_; };
+        waitUntil(
+            wait_,
+            [this, timed, deadline] {
+                return count_.load(std::memory_order_acquire) != 0 ||
+                       closed_.load(std::memory_order_acquire) ||
+                       (timed && Clock::now() >= deadline);
+            },
+            [this, timed, deadline, &ready] {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (timed) {
+                    cv_.wait_until(lock, deadline, ready);
+                } else {
+                    cv_.wait(lock, ready);
+                }
+            });
+    }
 };
 
 #endif // THREADSAFEQUEUE_H
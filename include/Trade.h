@@ -1,19 +1,20 @@
 #ifndef TRADE_H
 #define TRADE_H
 
+#include "Order.h"
 #include <cstdint>
-#include <chrono>
 
+// One execution. Trades are built on the matching path, so they carry no
+// clock reading; sinks that need one (the trade tape) stamp on receipt.
 struct Trade {
     uint64_t buyOrderId;
     uint64_t sellOrderId;
     double price;
     uint64_t quantity;
-    std::chrono::steady_clock::time_point timestamp;
+    SymbolId symbol;
 
-    Trade(uint64_t buyId, uint64_t sellId, double p, uint64_t qty)
-        : buyOrderId(buyId), sellOrderId(sellId), price(p), quantity(qty),
-          timestamp(std::chrono::steady_clock::now()) {}
+    Trade(uint64_t buyId, uint64_t sellId, double p, uint64_t qty, SymbolId sym = 0)
+        : buyOrderId(buyId), sellOrderId(sellId), price(p), quantity(qty), symbol(sym) {}
 };
 
 #endif // TRADE_H
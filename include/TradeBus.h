@@ -0,0 +1,36 @@
+#ifndef TRADEBUS_H
+#define TRADEBUS_H
+
+#include "MulticastRing.h"
+#include "Trade.h"
+#include "TradeSink.h"
+
+// Fills of one engine thread, written once into a multicast ring that
+// every downstream consumer (risk, gateway execution reports, monitors)
+// reads with its own cursor. Replaces a tee of one queue per consumer.
+//
+// The journal and the L2 feed are deliberately not readers. The journal
+// records input instructions before they are matched (write-ahead), so it
+// has nothing to read from a ring of outcomes. L2 events carry level state
+// the book computes under its lock, and the publisher conflates rather than
+// gating the engine, while every reader here must see every fill.
+class TradeBus final : public TradeSink {
+public:
+    explicit TradeBus(size_t capacity = 1 << 16) : ring_(capacity) {}
+
+    // Engine thread; waits only if a gating reader is a whole ring behind
+    void onTrade(const Trade& trade) override { ring_.publish(trade); }
+
+    MulticastRing<Trade>& ring() { return ring_; }
+
+private:
+    MulticastRing<Trade> ring_;
+};
+
+// One consumer's view of a TradeBus
+struct TradeBusReader {
+    MulticastRing<Trade>* ring;
+    MulticastRing<Trade>::ReaderId id;
+};
+
+#endif // TRADEBUS_H
@@ -0,0 +1,99 @@
+#ifndef TRADESINK_H
+#define TRADESINK_H
+
+#include "Trade.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Receives fills as the book executes them. Called with the book lock held,
+// so implementations must not call back into the OrderBook.
+//
+// The engine's matching entry points are templated on the sink type:
+// passing a TradeSink& keeps the call virtual, while passing one of the
+// final sinks below (or any type with onTrade(const Trade&)) lets the
+// compiler inline the callback into the matching loop.
+class TradeSink {
+public:
+    virtual ~TradeSink() = default;
+
+    virtual void onTrade(const Trade& trade) = 0;
+
+    // Called by the engine thread before each batch it matches with the
+    // steady-clock time in ns; fills until the next call executed then.
+    // Sinks that timestamp fills use it instead of reading the clock per fill.
+    virtual void onBatch(int64_t timestampNs) { (void)timestampNs; }
+};
+
+// Sink that appends every fill to a vector
+class TradeCollector final : public TradeSink {
+public:
+    explicit TradeCollector(std::vector<Trade>& trades) : trades_(trades) {}
+
+    void onTrade(const Trade& trade) override { trades_.push_back(trade); }
+
+private:
+    std::vector<Trade>& trades_;
+};
+
+// Sink that forwards every fill to two sinks, first then second
+class TeeTradeSink final : public TradeSink {
+public:
+    TeeTradeSink(TradeSink& first, TradeSink& second) : first_(first), second_(second) {}
+
+    void onTrade(const Trade& trade) override {
+        first_.onTrade(trade);
+        second_.onTrade(trade);
+    }
+
+    void onBatch(int64_t timestampNs) override {
+        first_.onBatch(timestampNs);
+        second_.onBatch(timestampNs);
+    }
+
+private:
+    TradeSink& first_;
+    TradeSink& second_;
+};
+
+// Sink that discards fills
+class NullTradeSink final : public TradeSink {
+public:
+    void onTrade(const Trade&) override {}
+};
+
+// Sink that counts fills and traded quantity without storing them
+class CountingTradeSink final : public TradeSink {
+public:
+    void onTrade(const Trade& trade) override {
+        count_++;
+        quantity_ += trade.quantity;
+    }
+
+    uint64_t getCount() const { return count_; }
+    uint64_t getQuantity() const { return quantity_; }
+
+private:
+    uint64_t count_ = 0;
+    uint64_t quantity_ = 0;
+};
+
+// Sink that hands every fill to a callable, e.g. an execution-report
+// writer. Create with makeTradeCallback().
+template<typename Callback>
+class CallbackTradeSink final : public TradeSink {
+public:
+    explicit CallbackTradeSink(Callback callback) : callback_(std::move(callback)) {}
+
+    void onTrade(const Trade& trade) override { callback_(trade); }
+
+private:
+    Callback callback_;
+};
+
+template<typename Callback>
+CallbackTradeSink<Callback> makeTradeCallback(Callback callback) {
+    return CallbackTradeSink<Callback>(std::move(callback));
+}
+
+#endif // TRADESINK_H
@@ -0,0 +1,121 @@
+#ifndef TRADETAPE_H
+#define TRADETAPE_H
+
+#include "LatencyHistogram.h"
+#include "Trade.h"
+#include "TradeSink.h"
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size binary trade record as stored on the tape
+struct TradeRecord {
+    uint64_t sequence;
+    uint64_t buyOrderId;
+    uint64_t sellOrderId;
+    int64_t priceRaw;       // Price::raw(), four implied decimals
+    uint64_t quantity;
+    int64_t timestampNs;    // steady_clock time of execution (start of the engine batch)
+    uint32_t symbol;
+    uint32_t reserved;
+};
+
+static_assert(std::is_trivially_copyable<TradeRecord>::value, "TradeRecord is written raw");
+static_assert(sizeof(TradeRecord) == 56, "TradeRecord layout is part of the tape format");
+
+// File header preceding the records of a binary tape
+struct TapeHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+enum class TapeFormat {
+    Binary,
+    Text
+};
+
+// Format one record as a human-readable line (with trailing newline) into
+// buffer. Returns the number of characters written.
+size_t formatTradeRecord(const TradeRecord& record, char* buffer, size_t size);
+
+// Read every record of a binary tape. Returns false if the file cannot be
+// opened or its header does not match this build's format.
+bool readTradeTape(const std::string& path, std::vector<TradeRecord>& records);
+
+// Trade log that keeps formatting and I/O off the matching thread. onTrade()
+// only appends a TradeRecord to a lock-free ring; a background writer thread
+// drains the ring into a large buffer and writes it out in big chunks.
+// A failed write (e.g. a full disk) is sticky: the tape stops writing, since a
+// short write leaves a partial record, and the affected trades are counted as
+// lost instead of being dropped silently.
+class TradeTape : public TradeSink {
+public:
+    TradeTape(const std::string& path, TapeFormat format = TapeFormat::Binary,
+              size_t ringCapacity = 1 << 16);
+    ~TradeTape() override;
+
+    TradeTape(const TradeTape&) = delete;
+    TradeTape& operator=(const TradeTape&) = delete;
+
+    // Whether the output file was opened successfully
+    bool isOpen() const { return file_ != nullptr; }
+
+    // Start the writer thread. Must be called before trades are appended.
+    void start();
+
+    // Drain remaining records, flush and join the writer thread
+    void stop();
+
+    // Append a trade (matching thread). Spins only if the ring is full.
+    void onTrade(const Trade& trade) override;
+
+    // Stamp the following trades with the batch time instead of reading the
+    // clock per trade (matching thread)
+    void onBatch(int64_t timestampNs) override { batchNs_ = timestampNs; }
+
+    // Record execution-to-writer latency of every trade (nullptr disables).
+    // Set before start().
+    void setLatency(LatencyHistogram* histogram) { latency_ = histogram; }
+
+    // Number of trades appended so far
+    uint64_t getRecordCount() const { return nextSequence_.load(std::memory_order_relaxed); }
+
+    // Whether a write to the tape file has failed
+    bool hasFailed() const { return failed_.load(std::memory_order_acquire); }
+
+    // Number of trades that did not reach the file because of a write failure
+    uint64_t getLostCount() const { return lost_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kWriteBufferSize = 1 << 20;
+
+    std::FILE* file_;
+    TapeFormat format_;
+    SpscRingBuffer<TradeRecord> ring_;
+    std::vector<char> buffer_;
+    size_t buffered_;       // Records currently held in buffer_
+    std::thread writer_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> nextSequence_;
+    std::atomic<bool> failed_;
+    std::atomic<uint64_t> lost_;
+    LatencyHistogram* latency_;
+    int64_t batchNs_;       // Last onBatch() time, 0 before the first
+
+    // Writer thread body
+    void writeLoop();
+
+    // Move queued records into the write buffer. Returns the number drained.
+    size_t drain();
+
+    // Write the buffer out, or count its records as lost once writes fail
+    void flushBuffer();
+};
+
+#endif // TRADETAPE_H
@@ -0,0 +1,100 @@
+#ifndef WAITSTRATEGY_H
+#define WAITSTRATEGY_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+
+// How a consumer thread waits on an empty queue. Each step down trades CPU
+// for wake-up latency: Block sleeps in the kernel until a producer signals,
+// Yield gives the core to other runnable threads between polls,
+// SpinThenPark polls briefly before sleeping like Block, and BusySpin polls
+// without ever giving up the core, which only makes sense for a thread
+// pinned to a core of its own.
+enum class WaitStrategy : uint8_t {
+    Block,
+    Yield,
+    SpinThenPark,
+    BusySpin
+};
+
+// Command-line name of a strategy
+inline const char* toString(WaitStrategy strategy) {
+    switch (strategy) {
+    case WaitStrategy::Block:
+        return "block";
+    case WaitStrategy::Yield:
+        return "yield";
+    case WaitStrategy::SpinThenPark:
+        return "spin-park";
+    case WaitStrategy::BusySpin:
+        return "spin";
+    }
+    return "unknown";
+}
+
+// Strategy for a command-line name, or nullopt if there is none
+inline std::optional<WaitStrategy> parseWaitStrategy(const std::string& name) {
+    for (WaitStrategy strategy : {WaitStrategy::Block, WaitStrategy::Yield,
+                                  WaitStrategy::SpinThenPark, WaitStrategy::BusySpin}) {
+        if (name == toString(strategy)) {
+            return strategy;
+        }
+    }
+    return std::nullopt;
+}
+
+// Tell the core this is a spin-wait loop, so it backs off the pipeline and
+// leaves resources to a sibling hyperthread
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Consumer-side wait shared by the queues: return once ready() is true,
+// polling it as the strategy says. park() must block until ready() may have
+// become true; the queue supplies it together with whatever its producers
+// do to wake a parked consumer.
+template<typename Ready, typename Park>
+void waitUntil(WaitStrategy strategy, Ready&& ready, Park&& park) {
+    constexpr int kSpinPolls = 4096;
+    constexpr int kYieldPolls = 64;
+
+    switch (strategy) {
+    case WaitStrategy::BusySpin:
+        while (!ready()) {
+            cpuRelax();
+        }
+        return;
+    case WaitStrategy::Yield:
+        while (!ready()) {
+            std::this_thread::yield();
+        }
+        return;
+    case WaitStrategy::SpinThenPark:
+        for (int i = 0; i < kSpinPolls; ++i) {
+            if (ready()) {
+                return;
+            }
+            cpuRelax();
+        }
+        for (int i = 0; i < kYieldPolls; ++i) {
+            if (ready()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        [[fallthrough]];
+    case WaitStrategy::Block:
+        while (!ready()) {
+            park();
+        }
+        return;
+    }
+}
+
+#endif // WAITSTRATEGY_H
@@ -1,15 +1,33 @@
 #include "Order.h"
+#include "OrderMessage.h"
 #include "OrderBook.h"
 #include "MatchingEngine.h"
-#include "ThreadSafeQueue.h"
 #include "OrderProducer.h"
 #include "EngineWorker.h"
+#include "EngineShard.h"
+#include "OrderRouter.h"
+#include "SymbolDirectory.h"
 #include "ConsoleRenderer.h"
+#include "TradeTape.h"
+#include "LatencyHistogram.h"
+#include "Journal.h"
+#include "Recovery.h"
+#include "OrderGateway.h"
+#include "RiskStage.h"
+#include "TradeBus.h"
+#include "MarketDataPublisher.h"
+#include "ThreadAffinity.h"
+#include "WaitStrategy.h"
 #include <iostream>
 #include <thread>
 #include <csignal>
 #include <atomic>
 #include <string>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
 
 // Global flag for graceful shutdown
 std::atomic<bool> g_shutdownRequested(false);
@@ -19,18 +37,119 @@ void signalHandler(int signum) {
     g_shutdownRequested = true;
 }
 
+// Set by SIGUSR1 to print the latency histograms without stopping
+std::atomic<bool> g_latencyDumpRequested(false);
+
+void latencyDumpHandler(int) {
+    g_latencyDumpRequested = true;
+}
+
+// Split a comma-separated option value
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::istringstream iss(value);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+constexpr uint64_t kDefaultSnapshotInterval = 1000000;
+constexpr size_t kDefaultMarketDataMailbox = 4096;
+
 void printUsage(const char* programName) {
-    std::cout << "Usage: " << programName << " [--mode=<random|stdin>]" << std::endl;
+    std::cout << "Usage: " << programName
+              << " [--mode=<random|stdin|replay|stream|gateway>] [--file=<path>] [--socket=<path>] [--pace=<max|recorded>]"
+              << " [--queue=<mutex|spsc>] [--batch=<n>]"
+              << " [--tape=<file>] [--tape-format=<binary|text>]"
+              << " [--symbols=<a,b,...>] [--shards=<n>] [--engine-cores=<c0,c1,...>]"
+              << " [--display=<symbol>] [--latency]"
+              << " [--journal=<prefix>] [--snapshot-every=<n>]"
+              << " [--risk] [--max-order-qty=<n>] [--price-collar=<f>] [--max-open-qty=<n>]"
+              << " [--max-notional=<v>]"
+              << " [--wait=<block|yield|spin-park|spin>] [--producer-core=<c>] [--risk-core=<c>]"
+              << " [--renderer-core=<c>] [--mlock] [--market-data[=<mailbox>]]" << std::endl;
     std::cout << "  --mode=random  : Generate random orders automatically (default)" << std::endl;
     std::cout << "  --mode=stdin   : Read orders from standard input" << std::endl;
+    std::cout << "  --mode=replay  : Replay a binary order event file given by --file"
+              << " (convert text with order_convert)" << std::endl;
+    std::cout << "  --mode=stream  : Bulk-load text orders from --file (default stdin) at full"
+              << " speed" << std::endl;
+    std::cout << "  --mode=gateway : Accept binary order entry from clients on the Unix socket"
+              << " given by --socket (load test with gateway_client)" << std::endl;
+    std::cout << "  --pace=max|recorded : Replay at full speed (default) or at recorded"
+              << " inter-arrival times" << std::endl;
+    std::cout << "  --queue=mutex  : Mutex/condition-variable order queue (default)" << std::endl;
+    std::cout << "  --queue=spsc   : Lock-free single-producer/single-consumer ring buffer" << std::endl;
+    std::cout << "  --batch=<n>    : Max orders matched per queue drain (default "
+              << EngineWorker::kDefaultMaxBatchSize << ")" << std::endl;
+    std::cout << "  --tape=<file>  : Record executed trades to a trade tape (off by default)" << std::endl;
+    std::cout << "  --tape-format=binary|text : Tape encoding (default binary, decode with tape_decode)"
+              << std::endl;
+    std::cout << "                   With several shards each writes <file>.<shard>" << std::endl;
+    std::cout << "  --symbols=<list> : Instruments to trade (default SIM)" << std::endl;
+    std::cout << "  --shards=<n>   : Engine threads; symbols are spread across them (default 1)" << std::endl;
+    std::cout << "  --engine-cores=<list> : Pin engine thread i to the i-th listed core" << std::endl;
+    std::cout << "  --display=<symbol> : Symbol shown by the renderer (default first symbol)" << std::endl;
+    std::cout << "  --latency      : Record per-stage latency histograms; printed at exit"
+              << " and on SIGUSR1" << std::endl;
+    std::cout << "  --journal=<prefix> : Journal accepted orders to <prefix>[.<shard>].journal and"
+              << " recover from it plus <prefix>[.<shard>].snapshot on startup" << std::endl;
+    std::cout << "  --snapshot-every=<n> : Journaled orders between book snapshots (default "
+              << kDefaultSnapshotInterval << ")" << std::endl;
+    std::cout << "  --risk         : Check orders on a pre-trade risk thread before matching"
+              << std::endl;
+    std::cout << "  --max-order-qty=<n> : Largest accepted order quantity (implies --risk)" << std::endl;
+    std::cout << "  --price-collar=<f> : Max fractional distance of a limit price from the last"
+              << " trade, 0 disables (implies --risk)" << std::endl;
+    std::cout << "  --max-open-qty=<n> : Open quantity limit per account (implies --risk)" << std::endl;
+    std::cout << "  --max-notional=<v> : Open notional limit per account (implies --risk)" << std::endl;
+    std::cout << "  --wait=<strategy> : How engine and risk threads wait on an empty queue: block,"
+              << " yield, spin-park (spin, then block) or spin (busy-spin; give the thread a"
+              << " core of its own). Default block for mutex queues, yield for spsc" << std::endl;
+    std::cout << "  --producer-core=<c> : Pin the producer (or gateway) thread to a core" << std::endl;
+    std::cout << "  --risk-core=<c> : Pin the risk thread to a core" << std::endl;
+    std::cout << "  --renderer-core=<c> : Pin the renderer thread to a core" << std::endl;
+    std::cout << "  --mlock        : Fault in and lock all memory before the pipeline starts"
+              << std::endl;
+    std::cout << "  --market-data[=<n>] : Publish incremental L2 events from every shard to a"
+              << " conflating subscriber with an n-event mailbox (default 4096); counts are"
+              << " printed at exit" << std::endl;
     std::cout << std::endl;
-    std::cout << "Stdin format: <BUY|SELL> <price> <quantity>" << std::endl;
+    std::cout << "Stdin format: <BUY|SELL> <price|MARKET> <quantity> [id] [symbol] [IOC|FOK]" << std::endl;
+    std::cout << "              CANCEL <id>" << std::endl;
+    std::cout << "              MODIFY <id> <price> <quantity>" << std::endl;
     std::cout << "Example: BUY 100.50 1000" << std::endl;
 }
 
 int main(int argc, char *argv[]) {
     // Parse command-line arguments
     ProducerMode mode = ProducerMode::Random;
+    ReplayConfig replay;
+    bool gatewayMode = false;
+    std::string socketPath;
+    QueueKind queueKind = QueueKind::Mutex;
+    size_t maxBatchSize = EngineWorker::kDefaultMaxBatchSize;
+    std::string tapePath;
+    TapeFormat tapeFormat = TapeFormat::Binary;
+    std::vector<std::string> symbolNames = {"SIM"};
+    size_t shardCount = 1;
+    std::vector<int> engineCores;
+    std::string displaySymbol;
+    bool recordLatency = false;
+    std::string journalPrefix;
+    uint64_t snapshotInterval = kDefaultSnapshotInterval;
+    bool riskEnabled = false;
+    RiskLimits riskLimits;
+    std::optional<WaitStrategy> waitStrategy;
+    int producerCore = -1;
+    int riskCore = -1;
+    int rendererCore = -1;
+    bool lockMemory = false;
+    size_t marketDataMailbox = 0;       // 0: no market data feed
 
     for (int i = 1; i < argc; ++i) {
         std::string arg(argv[i]);
@@ -43,11 +162,169 @@ int main(int argc, char *argv[]) {
                 mode = ProducerMode::Random;
             } else if (modeStr == "stdin") {
                 mode = ProducerMode::Stdin;
+            } else if (modeStr == "replay") {
+                mode = ProducerMode::Replay;
+            } else if (modeStr == "stream") {
+                mode = ProducerMode::Stream;
+            } else if (modeStr == "gateway") {
+                gatewayMode = true;
             } else {
                 std::cerr << "Invalid mode: " << modeStr << std::endl;
                 printUsage(argv[0]);
                 return 1;
             }
+        } else if (arg.substr(0, 7) == "--file=") {
+            replay.path = arg.substr(7);
+        } else if (arg.substr(0, 9) == "--socket=") {
+            socketPath = arg.substr(9);
+        } else if (arg.substr(0, 7) == "--pace=") {
+            std::string paceStr = arg.substr(7);
+            if (paceStr == "max") {
+                replay.recordedPace = false;
+            } else if (paceStr == "recorded") {
+                replay.recordedPace = true;
+            } else {
+                std::cerr << "Invalid pace: " << paceStr << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg.substr(0, 8) == "--queue=") {
+            std::string queueStr = arg.substr(8);
+            if (queueStr == "mutex") {
+                queueKind = QueueKind::Mutex;
+            } else if (queueStr == "spsc") {
+                queueKind = QueueKind::Spsc;
+            } else {
+                std::cerr << "Invalid queue: " << queueStr << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg.substr(0, 8) == "--batch=") {
+            try {
+                maxBatchSize = std::stoul(arg.substr(8));
+            } catch (const std::exception&) {
+                maxBatchSize = 0;
+            }
+            if (maxBatchSize == 0) {
+                std::cerr << "Invalid batch size: " << arg.substr(8) << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg.substr(0, 7) == "--tape=") {
+            tapePath = arg.substr(7);
+        } else if (arg.substr(0, 14) == "--tape-format=") {
+            std::string formatStr = arg.substr(14);
+            if (formatStr == "binary") {
+                tapeFormat = TapeFormat::Binary;
+            } else if (formatStr == "text") {
+                tapeFormat = TapeFormat::Text;
+            } else {
+                std::cerr << "Invalid tape format: " << formatStr << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg.substr(0, 10) == "--symbols=") {
+            symbolNames = splitList(arg.substr(10));
+            if (symbolNames.empty()) {
+                std::cerr << "At least one symbol is required" << std::endl;
+                return 1;
+            }
+        } else if (arg.substr(0, 9) == "--shards=") {
+            try {
+                shardCount = std::stoul(arg.substr(9));
+            } catch (const std::exception&) {
+                shardCount = 0;
+            }
+            if (shardCount == 0) {
+                std::cerr << "Invalid shard count: " << arg.substr(9) << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg.substr(0, 15) == "--engine-cores=") {
+            for (const auto& core : splitList(arg.substr(15))) {
+                try {
+                    engineCores.push_back(std::stoi(core));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid core: " << core << std::endl;
+                    return 1;
+                }
+            }
+        } else if (arg.substr(0, 10) == "--display=") {
+            displaySymbol = arg.substr(10);
+        } else if (arg == "--latency") {
+            recordLatency = true;
+        } else if (arg.substr(0, 10) == "--journal=") {
+            journalPrefix = arg.substr(10);
+        } else if (arg.substr(0, 17) == "--snapshot-every=") {
+            try {
+                snapshotInterval = std::stoull(arg.substr(17));
+            } catch (const std::exception&) {
+                snapshotInterval = 0;
+            }
+            if (snapshotInterval == 0) {
+                std::cerr << "Invalid snapshot interval: " << arg.substr(17) << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--risk") {
+            riskEnabled = true;
+        } else if (arg.substr(0, 16) == "--max-order-qty=" || arg.substr(0, 15) == "--price-collar=" ||
+                   arg.substr(0, 15) == "--max-open-qty=" || arg.substr(0, 15) == "--max-notional=") {
+            std::string value = arg.substr(arg.find('=') + 1);
+            try {
+                if (arg.substr(0, 16) == "--max-order-qty=") {
+                    riskLimits.maxOrderQuantity = std::stoull(value);
+                } else if (arg.substr(0, 15) == "--price-collar=") {
+                    riskLimits.priceCollar = std::stod(value);
+                } else if (arg.substr(0, 15) == "--max-open-qty=") {
+                    riskLimits.maxOpenQuantity = std::stoull(value);
+                } else {
+                    riskLimits.maxOpenNotional = std::stod(value);
+                }
+            } catch (const std::exception&) {
+                std::cerr << "Invalid risk limit: " << arg << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            riskEnabled = true;
+        } else if (arg.substr(0, 7) == "--wait=") {
+            waitStrategy = parseWaitStrategy(arg.substr(7));
+            if (!waitStrategy.has_value()) {
+                std::cerr << "Invalid wait strategy: " << arg.substr(7) << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg.substr(0, 16) == "--producer-core=" || arg.substr(0, 12) == "--risk-core=" ||
+                   arg.substr(0, 16) == "--renderer-core=") {
+            int core;
+            try {
+                core = std::stoi(arg.substr(arg.find('=') + 1));
+            } catch (const std::exception&) {
+                std::cerr << "Invalid core: " << arg << std::endl;
+                return 1;
+            }
+            if (arg.substr(0, 16) == "--producer-core=") {
+                producerCore = core;
+            } else if (arg.substr(0, 12) == "--risk-core=") {
+                riskCore = core;
+            } else {
+                rendererCore = core;
+            }
+        } else if (arg == "--mlock") {
+            lockMemory = true;
+        } else if (arg == "--market-data") {
+            marketDataMailbox = kDefaultMarketDataMailbox;
+        } else if (arg.substr(0, 14) == "--market-data=") {
+            try {
+                marketDataMailbox = std::stoul(arg.substr(14));
+            } catch (const std::exception&) {
+                marketDataMailbox = 0;
+            }
+            if (marketDataMailbox == 0) {
+                std::cerr << "Invalid market data mailbox: " << arg.substr(14) << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
         } else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             printUsage(argv[0]);
@@ -55,59 +332,345 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    if (mode == ProducerMode::Replay && replay.path.empty()) {
+        std::cerr << "Replay mode needs --file=<events>" << std::endl;
+        return 1;
+    }
+    if (gatewayMode && socketPath.empty()) {
+        std::cerr << "Gateway mode needs --socket=<path>" << std::endl;
+        return 1;
+    }
+
     // Set up signal handler for graceful shutdown (Ctrl+C)
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, latencyDumpHandler);
+#endif
+
+    // Register instruments; book memory is split across them
+    SymbolDirectory directory;
+    size_t orderCapacity = std::max<size_t>(OrderBook::kDefaultOrderCapacity / symbolNames.size(), 1024);
+    for (const auto& name : symbolNames) {
+        directory.add(name, TickConfig(), orderCapacity);
+    }
+    shardCount = std::min(shardCount, directory.size());
+
+    SymbolId displayId = 0;
+    if (!displaySymbol.empty()) {
+        auto found = directory.find(displaySymbol);
+        if (!found.has_value()) {
+            std::cerr << "Unknown display symbol: " << displaySymbol << std::endl;
+            return 1;
+        }
+        displayId = *found;
+    }
 
     std::cout << "Starting Limit Order Book Matching Engine..." << std::endl;
-    std::cout << "Mode: " << (mode == ProducerMode::Random ? "Random" : "Stdin") << std::endl;
+    std::cout << "Mode: " << (gatewayMode ? "Gateway"
+                              : mode == ProducerMode::Random ? "Random"
+                              : mode == ProducerMode::Stdin ? "Stdin"
+                              : mode == ProducerMode::Replay ? "Replay" : "Stream") << std::endl;
+    std::cout << "Queue: " << (queueKind == QueueKind::Mutex ? "Mutex" : "SPSC") << std::endl;
+    if (waitStrategy.has_value()) {
+        std::cout << "Wait: " << toString(*waitStrategy) << std::endl;
+    }
+    std::cout << "Symbols: " << directory.size() << " on " << shardCount << " engine thread(s)" << std::endl;
+    if (riskEnabled) {
+        std::cout << "Risk: max order " << riskLimits.maxOrderQuantity << ", collar "
+                  << riskLimits.priceCollar << ", max open " << riskLimits.maxOpenQuantity
+                  << ", max notional " << riskLimits.maxOpenNotional << " per account" << std::endl;
+    }
     std::cout << "Press Ctrl+C to exit" << std::endl;
     std::cout << std::endl;
 
     // Wait a moment before starting
     std::this_thread::sleep_for(std::chrono::seconds(2));
 
-    // Create core components
-    ThreadSafeQueue<Order> orderQueue;
-    OrderBook orderBook;
-    MatchingEngine matchingEngine(orderBook);
+    // Shared by all engine threads and tapes; recording is lock-free
+    PipelineLatency latency;
+
+    // Each shard gets its own trade sink: the tape ring has a single writer
+    std::vector<std::unique_ptr<TradeTape>> tradeTapes;
+    NullTradeSink noTradeLog;
+    for (size_t shard = 0; shard < shardCount && !tapePath.empty(); ++shard) {
+        std::string path = shardCount == 1 ? tapePath : tapePath + "." + std::to_string(shard);
+        tradeTapes.push_back(std::make_unique<TradeTape>(path, tapeFormat));
+        if (!tradeTapes.back()->isOpen()) {
+            std::cerr << "Cannot open trade tape: " << path << std::endl;
+            return 1;
+        }
+        if (recordLatency) {
+            tradeTapes.back()->setLatency(&latency.tradePublish);
+        }
+        tradeTapes.back()->start();
+    }
+
+    // Gateway clients get execution reports on their order entry connection
+    std::unique_ptr<OrderGateway> gateway;
+    if (gatewayMode) {
+        gateway = std::make_unique<OrderGateway>(directory, socketPath);
+        if (!gateway->open()) {
+            std::cerr << "Cannot start order gateway: " << gateway->getError() << std::endl;
+            return 1;
+        }
+    }
+
+    // Pre-trade risk runs on its own thread ahead of the router
+    std::unique_ptr<RiskStage> risk;
+    if (riskEnabled) {
+        risk = std::make_unique<RiskStage>(directory, riskLimits, queueKind, maxBatchSize);
+        if (waitStrategy.has_value()) {
+            risk->setWaitStrategy(*waitStrategy);
+        }
+    }
+
+    // Gateway clients are answered only once risk has decided on a request
+    std::unique_ptr<MulticastRing<RiskDecision>> riskDecisions;
+    if (gateway && risk) {
+        riskDecisions = std::make_unique<MulticastRing<RiskDecision>>();
+        risk->setDecisionBus(*riskDecisions);
+        gateway->setRiskDecisions(*riskDecisions);
+    }
 
-    // Create worker objects
-    OrderProducer producer(orderQueue, mode);
-    EngineWorker engineWorker(orderQueue, matchingEngine);
-    ConsoleRenderer renderer(orderBook, matchingEngine, orderQueue);
+    // Each shard writes its fills once to a bus that the gateway and the risk
+    // stage read independently. The tape stays a direct sink because it
+    // stamps execution time on the engine thread.
+    std::vector<std::unique_ptr<TradeBus>> tradeBuses;
+    std::vector<std::unique_ptr<TeeTradeSink>> tradeTees;
+
+    // Create engine shards, each owning a disjoint set of books
+    std::vector<std::vector<SymbolId>> shardSymbols(shardCount);
+    for (SymbolId symbol = 0; symbol < directory.size(); ++symbol) {
+        shardSymbols[OrderRouter::shardFor(symbol, shardCount)].push_back(symbol);
+    }
+
+    std::vector<std::unique_ptr<EngineShard>> shards;
+    std::vector<ConcurrentQueue<OrderMessage>*> shardQueues;
+    for (size_t shard = 0; shard < shardCount; ++shard) {
+        TradeSink* tradeSink = tradeTapes.empty() ? static_cast<TradeSink*>(&noTradeLog)
+                                                  : tradeTapes[shard].get();
+        if (gateway || risk) {
+            tradeBuses.push_back(std::make_unique<TradeBus>());
+            TradeBus& bus = *tradeBuses.back();
+            if (gateway) {
+                gateway->addFillSource(bus);
+            }
+            if (risk) {
+                risk->addFillSource(bus);
+            }
+            if (tradeTapes.empty()) {
+                tradeSink = &bus;
+            } else {
+                tradeTees.push_back(std::make_unique<TeeTradeSink>(*tradeTapes[shard], bus));
+                tradeSink = tradeTees.back().get();
+            }
+        }
+        shards.push_back(std::make_unique<EngineShard>(directory, shardSymbols[shard], queueKind,
+                                                       *tradeSink, maxBatchSize));
+        if (recordLatency) {
+            shards.back()->setLatency(&latency);
+        }
+        if (waitStrategy.has_value()) {
+            shards.back()->setWaitStrategy(*waitStrategy);
+        }
+        shardQueues.push_back(&shards.back()->getQueue());
+    }
+    OrderRouter router(directory, shardQueues);
+
+    // Rebuild each shard's books from its last snapshot and journal tail,
+    // then journal everything accepted from here on
+    std::vector<std::unique_ptr<Journal>> journals;
+    std::vector<std::unique_ptr<Snapshotter>> snapshotters;
+    uint64_t nextOrderId = 1;
+    for (size_t shard = 0; shard < shardCount && !journalPrefix.empty(); ++shard) {
+        std::string base = shardCount == 1 ? journalPrefix
+                                           : journalPrefix + "." + std::to_string(shard);
+        RecoveryResult recovered = shards[shard]->recover(base + ".snapshot", base + ".journal");
+        if (!recovered.ok) {
+            std::cerr << recovered.error << std::endl;
+            return 1;
+        }
+        if (recovered.journalSequence > 0) {
+            std::cout << "Recovered shard " << shard << ": " << recovered.restoredOrders
+                      << " orders from snapshot, " << recovered.replayedEvents
+                      << " journaled events replayed" << std::endl;
+        }
+        nextOrderId = std::max(nextOrderId, recovered.nextOrderId);
+
+        journals.push_back(std::make_unique<Journal>(base + ".journal"));
+        if (!journals.back()->isOpen()) {
+            std::cerr << "Cannot open journal: " << base << ".journal" << std::endl;
+            return 1;
+        }
+        snapshotters.push_back(std::make_unique<Snapshotter>(base + ".snapshot", journals.back().get()));
+        journals.back()->start();
+        snapshotters.back()->start();
+        shards[shard]->setPersistence(journals.back().get(), snapshotters.back().get(),
+                                      snapshotInterval);
+    }
+
+    // One L2 publisher per engine thread, each with a conflating subscriber
+    // that the main thread polls. Attached after recovery so replayed
+    // history is not published.
+    std::vector<std::unique_ptr<MarketDataPublisher>> marketDataPublishers;
+    std::vector<std::unique_ptr<MarketDataSubscriber>> marketDataSubscribers;
+    for (size_t shard = 0; shard < shardCount && marketDataMailbox > 0; ++shard) {
+        marketDataPublishers.push_back(std::make_unique<MarketDataPublisher>());
+        marketDataSubscribers.push_back(std::make_unique<MarketDataSubscriber>(marketDataMailbox));
+        marketDataPublishers.back()->subscribe(*marketDataSubscribers.back());
+        shards[shard]->setMarketDataSink(marketDataPublishers.back().get());
+        marketDataPublishers.back()->start();
+    }
+    std::vector<MarketDataEvent> marketDataEvents;
+    std::vector<uint64_t> marketDataReceived(marketDataSubscribers.size(), 0);
+    auto pollMarketData = [&]() {
+        for (size_t shard = 0; shard < marketDataSubscribers.size(); ++shard) {
+            marketDataEvents.clear();
+            marketDataReceived[shard] += marketDataSubscribers[shard]->poll(marketDataEvents);
+        }
+    };
+
+    EngineShard& displayShard = *shards[OrderRouter::shardFor(displayId, shardCount)];
+
+    // Create worker objects; with risk enabled the producer feeds the risk
+    // thread and only the risk thread writes to the router
+    QueueWriter<OrderMessage>& input = risk ? static_cast<QueueWriter<OrderMessage>&>(risk->getQueue())
+                                            : router;
+    OrderProducer producer(input, mode, directory, replay);
+    producer.setNextOrderId(nextOrderId);
+    if (gateway) {
+        gateway->setNextOrderId(nextOrderId);
+    }
+    ConsoleRenderer renderer(*displayShard.getEngine(displayId), router,
+                             directory.get(displayId).name);
+
+    // Everything the pipeline uses is allocated by now; fault it in and keep
+    // it resident so no thread takes a page fault on its first touch
+    if (lockMemory && !lockProcessMemory()) {
+        std::cerr << "Could not lock memory (check ulimit -l); continuing unlocked" << std::endl;
+    }
 
     // Launch threads
-    std::thread producerThread([&producer]() { producer.run(); });
-    std::thread engineThread([&engineWorker]() { engineWorker.run(); });
-    std::thread rendererThread([&renderer]() { renderer.run(); });
+    for (size_t shard = 0; shard < shardCount; ++shard) {
+        shards[shard]->start(shard < engineCores.size() ? engineCores[shard] : -1);
+    }
+    if (risk) {
+        risk->start(router, riskCore);
+    }
+    // The gateway takes the producer's place as the single writer to the input queue
+    std::thread producerThread([&producer, &gateway, &input, producerCore]() {
+        if (producerCore >= 0 && !pinCurrentThreadToCore(producerCore)) {
+            std::cerr << "Could not pin producer thread to core " << producerCore << std::endl;
+        }
+        if (gateway) {
+            gateway->run(input);
+        } else {
+            producer.run();
+        }
+    });
+    std::thread rendererThread([&renderer, rendererCore]() {
+        if (rendererCore >= 0 && !pinCurrentThreadToCore(rendererCore)) {
+            std::cerr << "Could not pin renderer thread to core " << rendererCore << std::endl;
+        }
+        renderer.run();
+    });
 
     // Wait for shutdown signal
     while (!g_shutdownRequested) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (g_latencyDumpRequested.exchange(false)) {
+            latency.dump(std::cerr);
+        }
+        pollMarketData();
+
+        // Without a working journal accepted input can no longer be recovered
+        for (size_t shard = 0; shard < journals.size(); ++shard) {
+            if (journals[shard]->hasFailed()) {
+                std::cerr << "Journal write failed for shard " << shard << " after sequence "
+                          << journals[shard]->getDurableSequence() << "; shutting down" << std::endl;
+                g_shutdownRequested = true;
+                break;
+            }
+        }
     }
 
     // Graceful shutdown
     std::cout << "Shutting down threads..." << std::endl;
     producer.stop();
-    engineWorker.stop();
+    if (gateway) {
+        gateway->stop();
+    }
     renderer.stop();
 
-    // Push a dummy order to unblock the engine thread
-    Order dummyOrder(0, OrderSide::Buy, 0.0, 0);
-    orderQueue.push(dummyOrder);
-
-    // Join threads
+    // Join the producer first, then let the risk stage forward what it has
+    // queued, so the SPSC rings never see two writers
     if (producerThread.joinable()) {
         producerThread.join();
     }
-    if (engineThread.joinable()) {
-        engineThread.join();
+    if (risk) {
+        risk->stop();
+    }
+    for (auto& shard : shards) {
+        shard->stop();
     }
     if (rendererThread.joinable()) {
         rendererThread.join();
     }
 
+    // Engines are stopped, so the publishers can deliver their last events
+    for (auto& publisher : marketDataPublishers) {
+        publisher->stop();
+    }
+    pollMarketData();
+    for (size_t shard = 0; shard < marketDataSubscribers.size(); ++shard) {
+        const MarketDataSubscriber& subscriber = *marketDataSubscribers[shard];
+        std::cout << "Market data shard " << shard << ": published "
+                  << marketDataPublishers[shard]->getPublishedCount() << ", received "
+                  << marketDataReceived[shard] << ", conflated " << subscriber.getConflatedCount()
+                  << ", trades dropped " << subscriber.getDroppedTradeCount() << std::endl;
+    }
+
+    if (gateway) {
+        std::cout << "Gateway requests accepted: " << gateway->getAcceptedCount()
+                  << ", rejected: " << gateway->getRejectedCount() << std::endl;
+    }
+
+    if (risk) {
+        std::cout << "Risk accepted: " << risk->getAcceptedCount()
+                  << ", rejected: " << risk->getRejectedCount() << std::endl;
+        for (size_t reason = 1; reason < kRiskRejectCount; ++reason) {
+            uint64_t count = risk->getRejectedCount(static_cast<RiskReject>(reason));
+            if (count > 0) {
+                std::cout << "  " << toString(static_cast<RiskReject>(reason)) << ": " << count
+                          << std::endl;
+            }
+        }
+    }
+
+    // Engines are stopped, so the journals can commit their last group
+    for (size_t shard = 0; shard < journals.size(); ++shard) {
+        journals[shard]->stop();
+        snapshotters[shard]->stop();
+        std::cout << "Journaled through sequence " << journals[shard]->getDurableSequence()
+                  << (journals[shard]->hasFailed() ? " (write failed)" : "") << std::endl;
+    }
+
+    // Engines are stopped, so the tapes can drain and close
+    for (auto& tape : tradeTapes) {
+        tape->stop();
+        std::cout << "Trades recorded: " << tape->getRecordCount();
+        if (tape->hasFailed()) {
+            std::cout << " (write failed, " << tape->getLostCount() << " lost)";
+        }
+        std::cout << std::endl;
+    }
+
+    if (recordLatency) {
+        std::cout << "Pipeline latency:" << std::endl;
+        latency.dump(std::cout);
+    }
+
     std::cout << "Shutdown complete." << std::endl;
 
     return 0;
@@ -0,0 +1,59 @@
+#include "BookDifferential.h"
+#include <random>
+
+namespace {
+
+// Price on the 0.01 grid within spread ticks of 100.00
+Price nearMid(std::mt19937_64& rng, int spread) {
+    std::uniform_int_distribution<int> offset(-spread, spread);
+    return Price::fromRaw(Price::fromDouble(100.00).raw() + offset(rng) * Price::fromDouble(0.01).raw());
+}
+
+} // namespace
+
+std::vector<OrderMessage> generateDifferentialStream(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<uint64_t> quantity(1, 100);
+    std::vector<OrderMessage> events;
+    std::vector<Order> issued;    // Every GTC order sent, live or not
+    events.reserve(count);
+    uint64_t nextId = 1;
+
+    auto pick = [&]() {
+        return issued.empty() ? Order(nextId, OrderSide::Buy, Price(), 0) : issued[rng() % issued.size()];
+    };
+
+    while (events.size() < count) {
+        OrderSide side = rng() % 2 == 0 ? OrderSide::Buy : OrderSide::Sell;
+        unsigned roll = static_cast<unsigned>(rng() % 100);
+
+        if (roll < 50) {
+            // GTC limit order; about half cross and the rest build the book
+            Price price = nearMid(rng, 20);
+            uint64_t id = rng() % 50 == 0 ? pick().getId() : nextId++;
+            if (rng() % 100 == 0) {
+                price = Price::fromRaw(price.raw() + 1);    // Off tick
+            }
+            Order order(id, side, price, quantity(rng));
+            events.push_back(OrderMessage::newOrder(order));
+            issued.push_back(order);
+        } else if (roll < 58) {
+            events.push_back(OrderMessage::newOrder(Order::market(nextId++, side, quantity(rng) * 3)));
+        } else if (roll < 66) {
+            events.push_back(OrderMessage::newOrder(Order(nextId++, side, nearMid(rng, 10), quantity(rng) * 2, 0,
+                                                          OrderType::Limit, TimeInForce::ImmediateOrCancel)));
+        } else if (roll < 72) {
+            events.push_back(OrderMessage::newOrder(Order(nextId++, side, nearMid(rng, 10), quantity(rng) * 2, 0,
+                                                          OrderType::Limit, TimeInForce::FillOrKill)));
+        } else if (roll < 85) {
+            events.push_back(OrderMessage::cancel(pick().getId()));
+        } else {
+            // Same-price reduce or increase, reprice, or cancel-by-zero
+            Order target = pick();
+            Price price = rng() % 2 == 0 ? target.getFixedPrice() : nearMid(rng, 20);
+            uint64_t newQuantity = rng() % 8 == 0 ? 0 : quantity(rng);
+            events.push_back(OrderMessage::modify(target.getId(), price, newQuantity));
+        }
+    }
+    return events;
+}
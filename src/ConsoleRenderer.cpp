@@ -4,9 +4,9 @@
 #include <thread>
 #include <chrono>
 
-ConsoleRenderer::ConsoleRenderer(OrderBook& orderBook, MatchingEngine& engine,
-                                ThreadSafeQueue<Order>& queue)
-    : orderBook_(orderBook), engine_(engine), queue_(queue), running_(true) {}
+ConsoleRenderer::ConsoleRenderer(const MatchingEngine& engine, const OrderRouter& router,
+                                const std::string& symbolName)
+    : engine_(engine), router_(router), symbolName_(symbolName), running_(true) {}
 
 void ConsoleRenderer::run() {
     while (running_) {
@@ -33,10 +33,8 @@ void ConsoleRenderer::render() {
     std::cout << std::endl;
 
     // Get market data
-    auto asks = orderBook_.getTopAsks(10);
-    auto bids = orderBook_.getTopBids(10);
-    auto lastTrade = engine_.getLastTrade();
-    size_t queueSize = queue_.size();
+    BookSnapshot snapshot = engine_.getSnapshot();
+    size_t queueSize = router_.pendingCount();
 
     // Display header
     std::cout << std::setw(15) << "PRICE" << " │ "
@@ -45,16 +43,16 @@ void ConsoleRenderer::render() {
     std::cout << "────────────────┼─────────────────┼───────────" << std::endl;
 
     // Display asks (sellers) in reverse order (highest first for visual effect)
-    std::vector<PriceLevel> reversedAsks(asks.rbegin(), asks.rend());
-    for (const auto& level : reversedAsks) {
-        std::cout << std::setw(15) << std::fixed << std::setprecision(2) << level.price << " │ "
+    for (size_t i = snapshot.askLevels; i-- > 0;) {
+        const LevelSummary& level = snapshot.asks[i];
+        std::cout << std::setw(15) << std::fixed << std::setprecision(2) << level.price.toDouble() << " │ "
                   << std::setw(15) << level.totalQuantity << " │ "
                   << std::setw(10) << "ASK" << std::endl;
     }
 
     // Display spread line
-    if (!asks.empty() && !bids.empty()) {
-        double spread = asks[0].price - bids[0].price;
+    if (snapshot.askLevels > 0 && snapshot.bidLevels > 0) {
+        double spread = (snapshot.asks[0].price - snapshot.bids[0].price).toDouble();
         std::cout << "────────────────┴─────────────────┴───────────" << std::endl;
         std::cout << "           SPREAD: " << std::fixed << std::setprecision(2)
                   << spread << std::endl;
@@ -64,8 +62,9 @@ void ConsoleRenderer::render() {
     }
 
     // Display bids (buyers)
-    for (const auto& level : bids) {
-        std::cout << std::setw(15) << std::fixed << std::setprecision(2) << level.price << " │ "
+    for (size_t i = 0; i < snapshot.bidLevels; ++i) {
+        const LevelSummary& level = snapshot.bids[i];
+        std::cout << std::setw(15) << std::fixed << std::setprecision(2) << level.price.toDouble() << " │ "
                   << std::setw(15) << level.totalQuantity << " │ "
                   << std::setw(10) << "BID" << std::endl;
     }
@@ -77,10 +76,10 @@ void ConsoleRenderer::render() {
     std::cout << "┌────────────────────────────────────────────┐" << std::endl;
     std::cout << "│ LAST TRADE                                 │" << std::endl;
     std::cout << "├────────────────────────────────────────────┤" << std::endl;
-    if (lastTrade.has_value()) {
+    if (snapshot.hasLastTrade) {
         std::cout << "│ Price:    " << std::setw(10) << std::fixed << std::setprecision(2)
-                  << lastTrade->price << "                       │" << std::endl;
-        std::cout << "│ Quantity: " << std::setw(10) << lastTrade->quantity
+                  << snapshot.lastTradePrice.toDouble() << "                       │" << std::endl;
+        std::cout << "│ Quantity: " << std::setw(10) << snapshot.lastTradeQuantity
                   << "                       │" << std::endl;
     } else {
         std::cout << "│ No trades executed yet                     │" << std::endl;
@@ -92,7 +91,13 @@ void ConsoleRenderer::render() {
     std::cout << "┌────────────────────────────────────────────┐" << std::endl;
     std::cout << "│ SYSTEM STATUS                              │" << std::endl;
     std::cout << "├────────────────────────────────────────────┤" << std::endl;
+    std::cout << "│ Symbol: " << std::left << std::setw(34) << symbolName_.substr(0, 34)
+              << std::right << " │" << std::endl;
     std::cout << "│ Pending Orders in Queue: " << std::setw(5) << queueSize
-              << "              │" << std::endl;
+              << "             │" << std::endl;
+    std::cout << "│ Resting Orders:  " << std::setw(12) << snapshot.restingOrders
+              << "             │" << std::endl;
+    std::cout << "│ Trades Executed: " << std::setw(12) << snapshot.tradeCount
+              << "             │" << std::endl;
     std::cout << "└────────────────────────────────────────────┘" << std::endl;
 }
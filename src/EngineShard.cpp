@@ -0,0 +1,82 @@
+#include "EngineShard.h"
+#include "SpscRingBuffer.h"
+#include "ThreadAffinity.h"
+#include "ThreadSafeQueue.h"
+#include <iostream>
+
+EngineShard::EngineShard(const SymbolDirectory& directory, const std::vector<SymbolId>& symbols,
+                         QueueKind queueKind, TradeSink& tradeSink, size_t maxBatchSize)
+    : symbols_(symbols) {
+    if (queueKind == QueueKind::Spsc) {
+        queue_ = std::make_unique<SpscRingBuffer<OrderMessage>>();
+    } else {
+        queue_ = std::make_unique<ThreadSafeQueue<OrderMessage>>();
+    }
+
+    books_.resize(directory.size());
+    engines_.resize(directory.size());
+    std::vector<MatchingEngine*> enginesBySymbol(directory.size(), nullptr);
+
+    for (SymbolId symbol : symbols_) {
+        const SymbolInfo& info = directory.get(symbol);
+        books_[symbol] = std::make_unique<OrderBook>(info.tickConfig, info.orderCapacity);
+        engines_[symbol] = std::make_unique<MatchingEngine>(*books_[symbol]);
+        enginesBySymbol[symbol] = engines_[symbol].get();
+    }
+
+    worker_ = std::make_unique<EngineWorker>(*queue_, enginesBySymbol, tradeSink, maxBatchSize);
+}
+
+EngineShard::~EngineShard() {
+    stop();
+}
+
+OrderBook* EngineShard::getBook(SymbolId symbol) const {
+    return symbol < books_.size() ? books_[symbol].get() : nullptr;
+}
+
+MatchingEngine* EngineShard::getEngine(SymbolId symbol) const {
+    return symbol < engines_.size() ? engines_[symbol].get() : nullptr;
+}
+
+void EngineShard::setMarketDataSink(MarketDataSink* sink) {
+    for (SymbolId symbol : symbols_) {
+        books_[symbol]->setMarketDataSink(sink);
+    }
+}
+
+RecoveryResult EngineShard::recover(const std::string& snapshotPath,
+                                    const std::string& journalPath) {
+    std::vector<MatchingEngine*> enginesBySymbol(engines_.size(), nullptr);
+    for (SymbolId symbol : symbols_) {
+        enginesBySymbol[symbol] = engines_[symbol].get();
+    }
+
+    RecoveryResult result = recoverEngines(snapshotPath, journalPath, enginesBySymbol);
+    if (result.ok) {
+        worker_->resumeFrom(result.snapshotSequence, result.nextOrderId);
+    }
+    return result;
+}
+
+void EngineShard::start(int core) {
+    if (thread_.joinable()) {
+        return;
+    }
+
+    thread_ = std::thread([this, core]() {
+        if (core >= 0 && !pinCurrentThreadToCore(core)) {
+            std::cerr << "Could not pin engine thread to core " << core << std::endl;
+        }
+        worker_->run();
+    });
+}
+
+void EngineShard::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    worker_->stop();
+    thread_.join();
+}
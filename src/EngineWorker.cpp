@@ -1,31 +1,126 @@
 #include "EngineWorker.h"
-#include "Trade.h"
-#include <iostream>
-#include <iomanip>
+#include <chrono>
 
-EngineWorker::EngineWorker(ThreadSafeQueue<Order>& queue, MatchingEngine& engine)
-    : queue_(queue), engine_(engine), running_(true) {}
+EngineWorker::EngineWorker(ConcurrentQueue<OrderMessage>& queue,
+                           const std::vector<MatchingEngine*>& enginesBySymbol,
+                           TradeSink& tradeSink, size_t maxBatchSize)
+    : queue_(queue), engines_(enginesBySymbol), tradeSink_(tradeSink),
+      maxBatchSize_(maxBatchSize > 0 ? maxBatchSize : 1), latency_(nullptr),
+      journal_(nullptr), snapshotter_(nullptr), snapshotInterval_(0), lastSnapshotSequence_(0),
+      nextOrderId_(1) {
+    batch_.reserve(maxBatchSize_);
+}
 
 void EngineWorker::run() {
-    while (running_) {
-        // Get order from queue (blocking)
-        Order order = queue_.pop();
-
-        // Process the order through matching engine
-        auto trades = engine_.processOrder(order);
-
-        // Log executed trades
-        for (const auto& trade : trades) {
-            std::cout << "[TRADE] "
-                      << "BuyOrderID: " << trade.buyOrderId << " "
-                      << "SellOrderID: " << trade.sellOrderId << " "
-                      << "Price: " << std::fixed << std::setprecision(2) << trade.price << " "
-                      << "Quantity: " << trade.quantity
-                      << std::endl;
+    while (true) {
+        // Drain whatever is queued, up to the batch limit (waits while empty)
+        batch_.clear();
+        if (queue_.popBatch(batch_, maxBatchSize_) == 0) {
+            return;
+        }
+
+        // One clock read per batch stamps its fills and its queue wait
+        const auto dequeued = std::chrono::steady_clock::now();
+        const int64_t dequeuedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            dequeued.time_since_epoch()).count();
+        tradeSink_.onBatch(dequeuedNs);
+
+        if (latency_ != nullptr) {
+            for (const auto& message : batch_) {
+                if (message.ingestNs != 0) {
+                    int64_t waitNs = dequeuedNs - message.ingestNs;
+                    latency_->queueWait.record(waitNs > 0 ? static_cast<uint64_t>(waitNs) : 0);
+                }
+            }
+        }
+
+        // Write-ahead: every instruction is sequenced before it can change a book
+        if (journal_ != nullptr) {
+            for (const auto& message : batch_) {
+                journal_->append(message);
+                if (message.type == MessageType::New && message.order.getId() >= nextOrderId_) {
+                    nextOrderId_ = message.order.getId() + 1;
+                }
+            }
+        }
+
+        // Hand each run of same-symbol instructions to that symbol's engine;
+        // fills go straight to the trade sink
+        size_t begin = 0;
+        while (begin < batch_.size()) {
+            SymbolId symbol = batch_[begin].order.getSymbol();
+            size_t end = begin + 1;
+            while (end < batch_.size() && batch_[end].order.getSymbol() == symbol) {
+                end++;
+            }
+
+            if (MatchingEngine* engine = engineFor(symbol)) {
+                engine->processBatch(&batch_[begin], end - begin, tradeSink_);
+            }
+
+            // Results of a run become visible together, when its batch completes
+            if (latency_ != nullptr) {
+                auto completed = std::chrono::steady_clock::now();
+                for (size_t i = begin; i < end; ++i) {
+                    latency_->matching.record(dequeued, completed);
+                }
+            }
+            begin = end;
+        }
+
+        if (snapshotter_ != nullptr &&
+            journal_->getSequence() - lastSnapshotSequence_ >= snapshotInterval_ &&
+            snapshotter_->isIdle()) {
+            takeSnapshot();
         }
     }
 }
 
+void EngineWorker::setPersistence(Journal* journal, Snapshotter* snapshotter,
+                                  uint64_t snapshotInterval) {
+    journal_ = journal;
+    snapshotter_ = journal != nullptr ? snapshotter : nullptr;
+    snapshotInterval_ = snapshotInterval > 0 ? snapshotInterval : 1;
+}
+
+void EngineWorker::resumeFrom(uint64_t snapshotSequence, uint64_t nextOrderId) {
+    lastSnapshotSequence_ = snapshotSequence;
+    nextOrderId_ = nextOrderId;
+}
+
+void EngineWorker::takeSnapshot() {
+    SnapshotData snapshot;
+    snapshot.journalSequence = journal_->getSequence();
+    snapshot.nextOrderId = nextOrderId_;
+
+    // Size the capture once so copying the books does not reallocate
+    size_t restingOrders = 0;
+    for (MatchingEngine* engine : engines_) {
+        if (engine != nullptr) {
+            restingOrders += engine->getOrderBook().getOrderCount();
+        }
+    }
+    snapshot.orders.reserve(restingOrders);
+
+    for (MatchingEngine* engine : engines_) {
+        if (engine == nullptr) {
+            continue;
+        }
+        engine->getOrderBook().forEachOrder([&snapshot](const Order& order) {
+            SnapshotOrderRecord record{};
+            record.orderId = order.getId();
+            record.priceRaw = order.getFixedPrice().raw();
+            record.quantity = order.getQuantity();
+            record.symbol = order.getSymbol();
+            record.side = static_cast<uint8_t>(order.getSide());
+            snapshot.orders.push_back(record);
+        });
+    }
+
+    lastSnapshotSequence_ = snapshot.journalSequence;
+    snapshotter_->submit(std::move(snapshot));
+}
+
 void EngineWorker::stop() {
-    running_ = false;
+    queue_.close();
 }
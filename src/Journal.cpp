@@ -0,0 +1,200 @@
+#include "Journal.h"
+#include "MappedFile.h"
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kJournalMagic[8] = {'L', 'O', 'B', 'J', 'R', 'N', 'L', '\0'};
+constexpr uint32_t kJournalVersion = 1;
+
+struct JournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+bool validHeader(const JournalHeader& header) {
+    return std::memcmp(header.magic, kJournalMagic, sizeof(kJournalMagic)) == 0 &&
+           header.version == kJournalVersion && header.recordSize == sizeof(JournalRecord);
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+Journal::Journal(const std::string& path, size_t ringCapacity)
+    : file_(nullptr), ring_(ringCapacity), running_(false), sequence_(0), durable_(0),
+      failed_(false) {
+    buffer_.reserve(kWriteBufferSize);
+
+    // Continue an existing journal, dropping a torn trailing record
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    if (file != nullptr) {
+        JournalHeader header;
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::rewind(file);
+        if (size < static_cast<long>(sizeof(header)) ||
+            std::fread(&header, sizeof(header), 1, file) != 1 || !validHeader(header)) {
+            std::fclose(file);
+            return;
+        }
+
+        uint64_t complete = (static_cast<uint64_t>(size) - sizeof(header)) / sizeof(JournalRecord);
+        long end = static_cast<long>(sizeof(header) + complete * sizeof(JournalRecord));
+        if (end != size && ::ftruncate(fileno(file), end) != 0) {
+            std::fclose(file);
+            return;
+        }
+        // Continue from the last record's own sequence, not the record count
+        uint64_t last = 0;
+        if (complete > 0) {
+            JournalRecord record;
+            std::fseek(file, end - static_cast<long>(sizeof(JournalRecord)), SEEK_SET);
+            if (std::fread(&record, sizeof(record), 1, file) != 1) {
+                std::fclose(file);
+                return;
+            }
+            last = record.sequence;
+        }
+        std::fseek(file, end, SEEK_SET);
+
+        file_ = file;
+        sequence_ = last;
+        durable_ = last;
+        return;
+    }
+
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return;
+    }
+
+    JournalHeader header;
+    std::memcpy(header.magic, kJournalMagic, sizeof(kJournalMagic));
+    header.version = kJournalVersion;
+    header.recordSize = sizeof(JournalRecord);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1 || std::fflush(file) != 0) {
+        std::fclose(file);
+        return;
+    }
+    file_ = file;
+}
+
+Journal::~Journal() {
+    stop();
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+void Journal::start() {
+    if (file_ == nullptr || running_) {
+        return;
+    }
+    running_ = true;
+    writer_ = std::thread([this]() { writeLoop(); });
+}
+
+void Journal::stop() {
+    running_ = false;
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+uint64_t Journal::append(const OrderMessage& message) {
+    JournalRecord record;
+    record.sequence = ++sequence_;
+    record.event = toOrderEventRecord(message, message.ingestNs != 0 ? message.ingestNs : nowNs());
+    ring_.push(record);
+    return record.sequence;
+}
+
+void Journal::writeLoop() {
+    while (running_) {
+        if (commitGroup() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    // Final commit after stop() so no appended record is lost
+    while (commitGroup() > 0) {
+    }
+}
+
+size_t Journal::commitGroup() {
+    size_t count = 0;
+    uint64_t last = 0;
+
+    while (buffer_.size() + sizeof(JournalRecord) <= kWriteBufferSize) {
+        auto record = ring_.tryPop();
+        if (!record.has_value()) {
+            break;
+        }
+        const char* bytes = reinterpret_cast<const char*>(&*record);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(JournalRecord));
+        last = record->sequence;
+        count++;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    // After a failed write the file's tail is unknown, so nothing later is
+    // written; records are still drained so the engine never waits on them
+    if (!failed_.load(std::memory_order_relaxed)) {
+        if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) == buffer_.size() &&
+            std::fflush(file_) == 0 && ::fdatasync(fileno(file_)) == 0) {
+            durable_.store(last, std::memory_order_release);
+        } else {
+            failed_.store(true, std::memory_order_release);
+        }
+    }
+    buffer_.clear();
+    return count;
+}
+
+bool readJournal(const std::string& path, uint64_t afterSequence,
+                 std::vector<JournalRecord>& records, uint64_t* lastSequence) {
+    if (lastSequence != nullptr) {
+        *lastSequence = 0;
+    }
+    if (::access(path.c_str(), F_OK) != 0) {
+        return true;
+    }
+
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(JournalHeader)) {
+        return false;
+    }
+
+    JournalHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (!validHeader(header)) {
+        return false;
+    }
+
+    // Select by each record's own sequence and reject a journal whose
+    // sequences skip or repeat, rather than trusting record positions
+    const auto* all = reinterpret_cast<const JournalRecord*>(file.data() + sizeof(JournalHeader));
+    uint64_t count = (file.size() - sizeof(JournalHeader)) / sizeof(JournalRecord);
+    for (uint64_t i = 0; i < count; ++i) {
+        if (i > 0 && all[i].sequence != all[i - 1].sequence + 1) {
+            return false;
+        }
+        if (all[i].sequence > afterSequence) {
+            records.push_back(all[i]);
+        }
+    }
+    if (lastSequence != nullptr && count > 0) {
+        *lastSequence = all[count - 1].sequence;
+    }
+    return true;
+}
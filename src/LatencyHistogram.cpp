@@ -0,0 +1,70 @@
+#include "LatencyHistogram.h"
+#include <cmath>
+#include <iomanip>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t samples = count();
+    return samples == 0 ? 0.0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / samples;
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    uint64_t samples = count();
+    if (samples == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(samples)));
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            uint64_t bound = bucketUpperBound(i);
+            return bound < max() ? bound : max();
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    size_t shift = bucket / kSubBuckets - 1;
+    uint64_t sub = bucket % kSubBuckets;
+    uint64_t lower = (kSubBuckets + sub) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::dump(std::ostream& out, const std::string& name) const {
+    out << std::left << std::setw(14) << name << std::right
+        << " count=" << count()
+        << " mean=" << std::fixed << std::setprecision(0) << mean()
+        << " p50=" << percentile(0.50)
+        << " p90=" << percentile(0.90)
+        << " p99=" << percentile(0.99)
+        << " p99.9=" << percentile(0.999)
+        << " max=" << max() << " (ns)" << std::endl;
+}
+
+void PipelineLatency::dump(std::ostream& out) const {
+    queueWait.dump(out, "queue_wait");
+    matching.dump(out, "matching");
+    tradePublish.dump(out, "trade_publish");
+}
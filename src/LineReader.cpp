@@ -0,0 +1,91 @@
+#include "LineReader.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+LineReader::LineReader(int fd, size_t blockSize)
+    : fd_(fd), ownsFd_(false), eof_(false), blockSize_(blockSize > 0 ? blockSize : 1),
+      buffer_(blockSize_), begin_(0), end_(0) {}
+
+LineReader::LineReader(const std::string& path, size_t blockSize)
+    : LineReader(path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY), blockSize) {
+    ownsFd_ = path != "-" && fd_ >= 0;
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (ownsFd_) {
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+}
+
+LineReader::~LineReader() {
+    if (ownsFd_) {
+        ::close(fd_);
+    }
+}
+
+bool LineReader::next(std::string_view& line) {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    size_t scanned = begin_;
+    while (true) {
+        const char* found = static_cast<const char*>(
+            std::memchr(buffer_.data() + scanned, '\n', end_ - scanned));
+        if (found != nullptr) {
+            size_t lineEnd = found - buffer_.data();
+            line = std::string_view(buffer_.data() + begin_, lineEnd - begin_);
+            begin_ = lineEnd + 1;
+            break;
+        }
+
+        // No terminator yet: keep the partial line and read more
+        scanned = end_ - begin_;
+        if (!fill()) {
+            if (begin_ == end_) {
+                return false;
+            }
+            // Last line without a trailing newline
+            line = std::string_view(buffer_.data() + begin_, end_ - begin_);
+            begin_ = end_;
+            break;
+        }
+        scanned += begin_;
+    }
+
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return true;
+}
+
+bool LineReader::fill() {
+    if (eof_) {
+        return false;
+    }
+
+    // Move the partial line to the front, growing only if it fills a block
+    size_t pending = end_ - begin_;
+    if (begin_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, pending);
+        begin_ = 0;
+        end_ = pending;
+    }
+    if (buffer_.size() - end_ < blockSize_ / 2) {
+        buffer_.resize(buffer_.size() + blockSize_);
+    }
+
+    while (true) {
+        ssize_t bytes = ::read(fd_, buffer_.data() + end_, buffer_.size() - end_);
+        if (bytes > 0) {
+            end_ += static_cast<size_t>(bytes);
+            return true;
+        }
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        eof_ = true;
+        return false;
+    }
+}
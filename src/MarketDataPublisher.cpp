@@ -0,0 +1,60 @@
+#include "MarketDataPublisher.h"
+#include <chrono>
+
+MarketDataPublisher::MarketDataPublisher(size_t ringCapacity)
+    : ring_(ringCapacity), running_(false), published_(0) {}
+
+MarketDataPublisher::~MarketDataPublisher() {
+    stop();
+}
+
+void MarketDataPublisher::subscribe(MarketDataSubscriber& subscriber) {
+    subscribers_.push_back(&subscriber);
+}
+
+void MarketDataPublisher::start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread([this]() { publishLoop(); });
+}
+
+void MarketDataPublisher::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void MarketDataPublisher::onEvent(const MarketDataEvent& event) {
+    ring_.push(event);
+}
+
+void MarketDataPublisher::publishLoop() {
+    while (running_) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    // Final drain after stop() so subscribers see every event
+    while (drain() > 0) {
+    }
+}
+
+size_t MarketDataPublisher::drain() {
+    size_t count = 0;
+    uint64_t sequence = published_.load(std::memory_order_relaxed);
+
+    while (auto event = ring_.tryPop()) {
+        event->sequence = ++sequence;
+        for (MarketDataSubscriber* subscriber : subscribers_) {
+            subscriber->deliver(*event);
+        }
+        count++;
+    }
+
+    published_.store(sequence, std::memory_order_relaxed);
+    return count;
+}
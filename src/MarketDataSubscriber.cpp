@@ -0,0 +1,62 @@
+#include "MarketDataSubscriber.h"
+
+MarketDataSubscriber::MarketDataSubscriber(size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1), conflating_(false), conflated_(0),
+      droppedTrades_(0) {}
+
+void MarketDataSubscriber::deliver(const MarketDataEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!conflating_ && queue_.size() < capacity_) {
+        queue_.push_back(event);
+        return;
+    }
+
+    conflating_ = true;
+    if (event.type == MarketDataType::Trade) {
+        droppedTrades_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        conflate(event);
+    }
+}
+
+void MarketDataSubscriber::conflate(const MarketDataEvent& event) {
+    LevelKey key{event.symbol, event.side, event.price.raw()};
+    auto it = pendingIndex_.find(key);
+    if (it == pendingIndex_.end()) {
+        pendingIndex_.emplace(key, pending_.size());
+        pending_.push_back(event);
+        return;
+    }
+
+    pending_[it->second] = event;
+    conflated_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t MarketDataSubscriber::poll(std::vector<MarketDataEvent>& out, size_t maxEvents) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t count = 0;
+    while (!queue_.empty() && count < maxEvents) {
+        out.push_back(queue_.front());
+        queue_.pop_front();
+        count++;
+    }
+
+    // Backlog drained: hand over the latest state of every changed level,
+    // which is newer than anything queued, and resume normal delivery
+    if (queue_.empty() && conflating_ && count + pending_.size() <= maxEvents) {
+        out.insert(out.end(), pending_.begin(), pending_.end());
+        count += pending_.size();
+        pending_.clear();
+        pendingIndex_.clear();
+        conflating_ = false;
+    }
+
+    return count;
+}
+
+bool MarketDataSubscriber::isConflating() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return conflating_;
+}
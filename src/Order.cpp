@@ -1,10 +1,14 @@
 #include "Order.h"
 
-Order::Order(uint64_t id, OrderSide side, double price, uint64_t quantity)
-    : id_(id), side_(side), price_(price), quantity_(quantity),
-      timestamp_(std::chrono::steady_clock::now()) {}
+Order::Order(uint64_t id, OrderSide side, double price, uint64_t quantity, SymbolId symbol)
+    : Order(id, side, Price::fromDouble(price), quantity, symbol) {}
 
-bool Order::operator<(const Order& other) const {
-    // For time priority: earlier timestamp is better
-    return timestamp_ < other.timestamp_;
+Order::Order(uint64_t id, OrderSide side, Price price, uint64_t quantity, SymbolId symbol)
+    : Order(id, side, price, quantity, symbol, OrderType::Limit, TimeInForce::GoodTillCancel) {}
+
+Order::Order(uint64_t id, OrderSide side, Price price, uint64_t quantity, SymbolId symbol,
+             OrderType type, TimeInForce timeInForce)
+    : id_(id), price_(price), quantity_(static_cast<uint32_t>(quantity)), symbol_(symbol),
+      sequence_(0), side_(side), type_(type), timeInForce_(timeInForce), reserved_(0) {
+    assert(quantity <= kMaxQuantity);
 }
@@ -1,136 +1,128 @@
 #include "OrderBook.h"
-#include <algorithm>
 
-void OrderBook::addOrder(const Order& order) {
-    std::lock_guard<std::mutex> lock(mutex_);
+OrderBook::OrderBook(const TickConfig& config, size_t orderCapacity)
+    : config_(config),
+      bids_(config),
+      asks_(config),
+      index_(orderCapacity),
+      nodePool_(orderCapacity),
+      marketData_(nullptr),
+      nextSequence_(0) {}
+
+OrderBook::~OrderBook() {
+    index_.forEach([this](OrderNode* node) { nodePool_.destroy(node); });
+}
 
-    if (order.getSide() == OrderSide::Buy) {
-        auto& level = bids_[order.getPrice()];
-        level.price = order.getPrice();
-        level.orders.push(order);
-        level.totalQuantity += order.getQuantity();
-    } else {
-        auto& level = asks_[order.getPrice()];
-        level.price = order.getPrice();
-        level.orders.push(order);
-        level.totalQuantity += order.getQuantity();
+bool OrderBook::addOrder(const Order& order) {
+    if (!config_.isValid(order.getFixedPrice())) {
+        return false;
     }
-}
 
-std::optional<Order> OrderBook::getBestBid() {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (bids_.empty()) {
-        return std::nullopt;
+    if (index_.find(order.getId()) != nullptr) {
+        return false;
     }
 
-    auto& level = bids_.begin()->second;
-    if (level.orders.empty()) {
-        return std::nullopt;
+    if (order.getSide() == OrderSide::Buy) {
+        insertNode<OrderSide::Buy>(order);
+    } else {
+        insertNode<OrderSide::Sell>(order);
     }
-
-    return level.orders.front();
+    return true;
 }
 
-std::optional<Order> OrderBook::getBestAsk() {
+bool OrderBook::cancelOrder(uint64_t id) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (asks_.empty()) {
-        return std::nullopt;
+    OrderNode* node = index_.find(id);
+    if (node == nullptr) {
+        return false;
     }
 
-    auto& level = asks_.begin()->second;
-    if (level.orders.empty()) {
-        return std::nullopt;
+    if (node->order.getSide() == OrderSide::Buy) {
+        eraseNode<OrderSide::Buy>(node);
+    } else {
+        eraseNode<OrderSide::Sell>(node);
     }
-
-    return level.orders.front();
+    return true;
 }
 
-void OrderBook::removeBidQuantity(uint64_t quantity) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (bids_.empty()) return;
+bool OrderBook::modifyOrder(uint64_t id, uint64_t newQuantity, Price newPrice) {
+    if (newQuantity == 0 || newQuantity > Order::kMaxQuantity || !config_.isValid(newPrice)) {
+        return false;
+    }
 
-    auto it = bids_.begin();
-    auto& level = it->second;
+    std::lock_guard<std::mutex> lock(mutex_);
 
-    if (level.orders.empty()) return;
+    OrderNode* node = index_.find(id);
+    if (node == nullptr) {
+        return false;
+    }
 
-    auto& order = level.orders.front();
-    if (order.getQuantity() <= quantity) {
-        level.totalQuantity -= order.getQuantity();
-        level.orders.pop();
-        if (level.orders.empty()) {
-            bids_.erase(it);
-        }
+    if (node->order.getSide() == OrderSide::Buy) {
+        modifyNode<OrderSide::Buy>(node, newQuantity, newPrice);
     } else {
-        Order updatedOrder = order;
-        updatedOrder.setQuantity(order.getQuantity() - quantity);
-        level.orders.pop();
-        level.orders.push(updatedOrder);
-        level.totalQuantity -= quantity;
+        modifyNode<OrderSide::Sell>(node, newQuantity, newPrice);
     }
+    return true;
 }
 
-void OrderBook::removeAskQuantity(uint64_t quantity) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (asks_.empty()) return;
-
-    auto it = asks_.begin();
-    auto& level = it->second;
-
-    if (level.orders.empty()) return;
+template<OrderSide Side>
+void OrderBook::modifyNode(OrderNode* node, uint64_t newQuantity, Price newPrice) {
+    Order& order = node->order;
+    if (newPrice == order.getFixedPrice() && newQuantity == order.getQuantity()) {
+        return;     // Nothing changes, so nothing is published
+    }
+    if (newPrice == order.getFixedPrice() && newQuantity < order.getQuantity()) {
+        // Quantity reduction keeps queue priority
+        reduceNode<Side>(node, order.getQuantity() - newQuantity);
+        return;
+    }
 
-    auto& order = level.orders.front();
-    if (order.getQuantity() <= quantity) {
-        level.totalQuantity -= order.getQuantity();
-        level.orders.pop();
-        if (level.orders.empty()) {
-            asks_.erase(it);
+    // Price change or size increase loses priority
+    const Price oldPrice = order.getFixedPrice();
+    ladder<Side>().remove(node);
+    order = Order(order.getId(), Side, newPrice, newQuantity, order.getSymbol());
+    order.setSequence(nextSequence_++);
+    ladder<Side>().add(node);
+    if (marketData_ != nullptr) {
+        if (oldPrice != newPrice) {
+            publishLevel<Side>(oldPrice, order.getSymbol(), false);
         }
-    } else {
-        Order updatedOrder = order;
-        updatedOrder.setQuantity(order.getQuantity() - quantity);
-        level.orders.pop();
-        level.orders.push(updatedOrder);
-        level.totalQuantity -= quantity;
+        publishLevel<Side>(newPrice, order.getSymbol(), oldPrice != newPrice);
     }
 }
 
-std::vector<PriceLevel> OrderBook::getTopBids(size_t n) const {
+std::optional<Order> OrderBook::getOrder(uint64_t id) const {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    std::vector<PriceLevel> result;
-    result.reserve(n);
-
-    size_t count = 0;
-    for (const auto& [price, level] : bids_) {
-        if (count >= n) break;
-        if (!level.orders.empty()) {
-            result.push_back(level);
-            count++;
-        }
+    const OrderNode* node = index_.find(id);
+    if (node == nullptr) {
+        return std::nullopt;
     }
-
-    return result;
+    return node->order;
 }
 
-std::vector<PriceLevel> OrderBook::getTopAsks(size_t n) const {
+size_t OrderBook::getOrderCount() const {
     std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
 
-    std::vector<PriceLevel> result;
-    result.reserve(n);
+bool OrderBook::crossesSpread(OrderSide side, Price price) const {
+    std::lock_guard<std::mutex> lock(mutex_);
 
-    size_t count = 0;
-    for (const auto& [price, level] : asks_) {
-        if (count >= n) break;
-        if (!level.orders.empty()) {
-            result.push_back(level);
-            count++;
-        }
+    if (side == OrderSide::Buy) {
+        const PriceLevel* ask = asks_.best();
+        return ask != nullptr && AskLadder::reaches(ask->price, price);
     }
+    const PriceLevel* bid = bids_.best();
+    return bid != nullptr && BidLadder::reaches(bid->price, price);
+}
 
-    return result;
+void OrderBook::fillSnapshot(BookSnapshot& snapshot) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot.bidLevels = static_cast<uint32_t>(bids_.topSummary(snapshot.bids, BookSnapshot::kDepth));
+    snapshot.askLevels = static_cast<uint32_t>(asks_.topSummary(snapshot.asks, BookSnapshot::kDepth));
+    snapshot.restingOrders = index_.size();
 }
@@ -0,0 +1,102 @@
+#include "OrderEventFile.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr char kEventMagic[8] = {'L', 'O', 'B', 'E', 'V', 'N', 'T', '\0'};
+constexpr uint32_t kEventVersion = 1;
+
+} // namespace
+
+OrderEventRecord toOrderEventRecord(const OrderMessage& message, int64_t timestampNs) {
+    const Order& order = message.order;
+
+    OrderEventRecord record{};
+    record.timestampNs = timestampNs;
+    record.orderId = order.getId();
+    record.priceRaw = order.getFixedPrice().raw();
+    record.quantity = order.getQuantity();
+    record.symbol = order.getSymbol();
+    record.type = static_cast<uint8_t>(message.type);
+    record.side = static_cast<uint8_t>(order.getSide());
+    record.orderType = static_cast<uint8_t>(order.getType());
+    record.timeInForce = static_cast<uint8_t>(order.getTimeInForce());
+    return record;
+}
+
+bool toOrderMessage(const OrderEventRecord& record, OrderMessage& message) {
+    // Files are mapped as-is, so check every field before it becomes an enum
+    // or is narrowed into an Order
+    switch (record.type) {
+    case static_cast<uint8_t>(MessageType::Cancel):
+        message = OrderMessage::cancel(record.orderId, record.symbol);
+        return true;
+    case static_cast<uint8_t>(MessageType::Modify):
+        if (record.quantity > Order::kMaxQuantity) {
+            return false;
+        }
+        message = OrderMessage::modify(record.orderId, Price::fromRaw(record.priceRaw),
+                                       record.quantity, record.symbol);
+        return true;
+    case static_cast<uint8_t>(MessageType::New):
+        if (record.side > static_cast<uint8_t>(OrderSide::Sell) ||
+            record.orderType > static_cast<uint8_t>(OrderType::Market) ||
+            record.timeInForce > static_cast<uint8_t>(TimeInForce::FillOrKill) ||
+            record.quantity == 0 || record.quantity > Order::kMaxQuantity) {
+            return false;
+        }
+        message = OrderMessage::newOrder(Order(record.orderId, static_cast<OrderSide>(record.side),
+                                               Price::fromRaw(record.priceRaw), record.quantity,
+                                               record.symbol,
+                                               static_cast<OrderType>(record.orderType),
+                                               static_cast<TimeInForce>(record.timeInForce)));
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool writeOrderEventFile(const std::string& path, const std::vector<OrderEventRecord>& records) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    OrderEventHeader header;
+    std::memcpy(header.magic, kEventMagic, sizeof(kEventMagic));
+    header.version = kEventVersion;
+    header.recordSize = sizeof(OrderEventRecord);
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(records.data(), sizeof(OrderEventRecord), records.size(), file) ==
+                  records.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool MappedOrderEventFile::open(const std::string& path) {
+    close();
+    if (!file_.open(path) || file_.size() < sizeof(OrderEventHeader)) {
+        file_.close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const OrderEventHeader*>(file_.data());
+    size_t payload = file_.size() - sizeof(OrderEventHeader);
+    if (std::memcmp(header->magic, kEventMagic, sizeof(kEventMagic)) != 0 ||
+        header->version != kEventVersion || header->recordSize != sizeof(OrderEventRecord) ||
+        payload % sizeof(OrderEventRecord) != 0) {
+        file_.close();
+        return false;
+    }
+
+    records_ = reinterpret_cast<const OrderEventRecord*>(file_.data() + sizeof(OrderEventHeader));
+    count_ = payload / sizeof(OrderEventRecord);
+    return true;
+}
+
+void MappedOrderEventFile::close() {
+    file_.close();
+    records_ = nullptr;
+    count_ = 0;
+}
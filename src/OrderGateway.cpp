@@ -0,0 +1,590 @@
+#include "OrderGateway.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kListenToken = ~uint64_t(0);
+constexpr int kPollTimeoutMs = 1;
+constexpr int kMaxEvents = 64;
+
+bool fillAddress(const std::string& path, sockaddr_un& address) {
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+} // namespace
+
+OrderGateway::OrderGateway(const SymbolDirectory& symbols, const std::string& socketPath)
+    : symbols_(symbols), socketPath_(socketPath), listenFd_(-1), epollFd_(-1), running_(true),
+      accepted_(0), rejected_(0), connected_(0), decisions_(nullptr), decisionReader_(0),
+      pendingHead_(0), pendingTail_(0), connections_(kMaxConnections),
+      queue_(nullptr), nextSequence_(1), receivedNs_(0) {
+    for (size_t slot = kMaxConnections; slot > 0; --slot) {
+        freeSlots_.push_back(slot - 1);
+    }
+    batch_.reserve(kMaxBatchSize);
+}
+
+OrderGateway::~OrderGateway() {
+    for (size_t slot = 0; slot < connections_.size(); ++slot) {
+        if (connections_[slot].fd >= 0) {
+            ::close(connections_[slot].fd);
+        }
+    }
+    if (epollFd_ >= 0) {
+        ::close(epollFd_);
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(socketPath_.c_str());
+    }
+}
+
+bool OrderGateway::addFillSource(TradeBus& bus) {
+    auto id = bus.ring().addReader(true);
+    if (id == MulticastRing<Trade>::kMaxReaders) {
+        return false;
+    }
+    fillReaders_.push_back(TradeBusReader{&bus.ring(), id});
+    return true;
+}
+
+bool OrderGateway::setRiskDecisions(MulticastRing<RiskDecision>& decisions) {
+    auto id = decisions.addReader(true);
+    if (id == MulticastRing<RiskDecision>::kMaxReaders) {
+        return false;
+    }
+    decisions_ = &decisions;
+    decisionReader_ = id;
+    pending_.resize(kPendingAnswerCapacity);
+    return true;
+}
+
+void OrderGateway::setNextOrderId(uint64_t id) {
+    nextSequence_ = std::max(nextSequence_, (id >> kConnectionBits) + 1);
+}
+
+int connectToGateway(const std::string& socketPath) {
+    sockaddr_un address;
+    if (!fillAddress(socketPath, address)) {
+        return -1;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+#if defined(__linux__)
+
+bool OrderGateway::open() {
+    sockaddr_un address;
+    if (!fillAddress(socketPath_, address)) {
+        error_ = "Invalid socket path: " + socketPath_;
+        return false;
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    // A socket file left behind by an earlier run would make bind fail
+    ::unlink(socketPath_.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, 128) != 0) {
+        error_ = socketPath_ + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    listenFd_ = fd;
+
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = kListenToken;
+    if (epollFd_ < 0 || ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event) != 0) {
+        error_ = std::string("epoll: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void OrderGateway::run(QueueWriter<OrderMessage>& queue) {
+    if (epollFd_ < 0) {
+        return;
+    }
+    queue_ = &queue;
+
+    epoll_event events[kMaxEvents];
+    while (running_) {
+        // The short timeout bounds how long fills wait when no client is active
+        int count = ::epoll_wait(epollFd_, events, kMaxEvents, kPollTimeoutMs);
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u64 == kListenToken) {
+                acceptClients();
+                continue;
+            }
+
+            size_t slot = static_cast<size_t>(events[i].data.u64);
+            if (connections_[slot].fd < 0) {
+                continue;
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readClient(slot)) {
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flushClient(slot);
+            }
+        }
+
+        pushBatch();
+        relayDecisions();
+        relayFills();
+        resumeClients();
+        flushClients();
+    }
+
+    for (size_t slot = 0; slot < connections_.size(); ++slot) {
+        if (connections_[slot].fd >= 0) {
+            closeClient(slot);
+        }
+    }
+    queue_ = nullptr;
+
+    // Engines that are still running must not wait for the gateway
+    for (const auto& reader : fillReaders_) {
+        reader.ring->detach(reader.id);
+    }
+    if (decisions_ != nullptr) {
+        decisions_->detach(decisionReader_);
+    }
+}
+
+void OrderGateway::acceptClients() {
+    while (true) {
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (freeSlots_.empty()) {
+            ::close(fd);
+            continue;
+        }
+
+        size_t slot = freeSlots_.back();
+        freeSlots_.pop_back();
+
+        Connection& connection = connections_[slot];
+        connection.fd = fd;
+        connection.firstOrderId = nextSequence_ << kConnectionBits;
+        connection.input.resize(kReceiveBufferSize);
+        connection.inputSize = 0;
+
+        if (!watchClient(slot, EPOLL_CTL_ADD)) {
+            // A client that is never polled would never be served
+            ::close(fd);
+            connection.fd = -1;
+            freeSlots_.push_back(slot);
+            continue;
+        }
+        connected_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool OrderGateway::readClient(size_t slot) {
+    Connection& connection = connections_[slot];
+
+    while (true) {
+        if (pendingTail_ - pendingHead_ >= kMaxPendingAnswers) {
+            // Leave the rest in the socket until risk catches up
+            pauseClient(slot);
+            return true;
+        }
+        ssize_t bytes = ::read(connection.fd, connection.input.data() + connection.inputSize,
+                               connection.input.size() - connection.inputSize);
+        if (bytes == 0) {
+            closeClient(slot);
+            return false;
+        }
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            closeClient(slot);
+            return false;
+        }
+        connection.inputSize += static_cast<size_t>(bytes);
+        receivedNs_ = steadyNowNs();
+
+        // Decode every complete message in place
+        const char* data = connection.input.data();
+        size_t offset = 0;
+        while (connection.inputSize - offset >= sizeof(WireHeader)) {
+            WireHeader header = readWireMessage<WireHeader>(data + offset);
+            if (connection.inputSize - offset < header.length &&
+                header.length <= connection.input.size()) {
+                break;
+            }
+            if (!handleMessage(slot, data + offset, header.length)) {
+                // Framing is lost; report and drop the client
+                sendReject(slot, 0, RejectReason::Malformed);
+                flushClient(slot);
+                if (connection.fd >= 0) {
+                    closeClient(slot);
+                }
+                return false;
+            }
+            offset += header.length;
+        }
+
+        // Keep a trailing partial message for the next read
+        connection.inputSize -= offset;
+        if (offset > 0 && connection.inputSize > 0) {
+            std::memmove(connection.input.data(), data + offset, connection.inputSize);
+        }
+    }
+}
+
+void OrderGateway::pauseClient(size_t slot) {
+    Connection& connection = connections_[slot];
+    if (connection.paused) {
+        return;
+    }
+    // Removing the socket from the set, rather than just EPOLLIN from its
+    // events, also silences EPOLLHUP and EPOLLERR, which epoll reports
+    // whatever the mask and which would otherwise spin the loop just the same
+    ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    connection.paused = true;
+    paused_.push_back(slot);
+}
+
+void OrderGateway::resumeClients() {
+    if (paused_.empty() || pendingTail_ - pendingHead_ >= kMaxPendingAnswers) {
+        return;
+    }
+    for (size_t slot : paused_) {
+        Connection& connection = connections_[slot];
+        if (!connection.paused) {
+            continue;   // Closed while paused
+        }
+        connection.paused = false;
+        // Level-triggered, so bytes left in the socket are reported at once
+        if (!watchClient(slot, EPOLL_CTL_ADD)) {
+            closeClient(slot);
+        }
+    }
+    paused_.clear();
+}
+
+bool OrderGateway::watchClient(size_t slot, int operation) {
+    const Connection& connection = connections_[slot];
+    epoll_event event{};
+    event.events = EPOLLIN | (connection.waitingWritable ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.u64 = slot;
+    return ::epoll_ctl(epollFd_, operation, connection.fd, &event) == 0;
+}
+
+bool OrderGateway::handleMessage(size_t slot, const char* data, size_t length) {
+    WireType type = static_cast<WireType>(readWireMessage<WireHeader>(data).type);
+    if (length != wireLength(type)) {
+        return false;
+    }
+
+    switch (type) {
+    case WireType::NewOrder:
+        handleNewOrder(slot, readWireMessage<WireNewOrder>(data));
+        return true;
+    case WireType::Cancel:
+        handleCancel(slot, readWireMessage<WireCancel>(data));
+        return true;
+    case WireType::Modify:
+        handleModify(slot, readWireMessage<WireModify>(data));
+        return true;
+    default:
+        return false;   // Gateway-to-client types are not requests
+    }
+}
+
+void OrderGateway::handleNewOrder(size_t slot, const WireNewOrder& request) {
+    if (!symbols_.contains(request.symbol)) {
+        sendReject(slot, request.clientOrderId, RejectReason::UnknownSymbol);
+        return;
+    }
+
+    auto type = static_cast<OrderType>(request.orderType);
+    auto timeInForce = static_cast<TimeInForce>(request.timeInForce);
+    if (request.side > static_cast<uint8_t>(OrderSide::Sell) ||
+        request.orderType > static_cast<uint8_t>(OrderType::Market) ||
+        request.timeInForce > static_cast<uint8_t>(TimeInForce::FillOrKill) ||
+        (type == OrderType::Market && timeInForce == TimeInForce::GoodTillCancel)) {
+        sendReject(slot, request.clientOrderId, RejectReason::InvalidType);
+        return;
+    }
+    if (request.quantity == 0 || request.quantity > Order::kMaxQuantity) {
+        sendReject(slot, request.clientOrderId, RejectReason::InvalidQuantity);
+        return;
+    }
+
+    Price price = Price::fromRaw(request.priceRaw);
+    if (type == OrderType::Limit && !symbols_.get(request.symbol).tickConfig.isValid(price)) {
+        sendReject(slot, request.clientOrderId, RejectReason::InvalidPrice);
+        return;
+    }
+
+    uint64_t orderId = (nextSequence_++ << kConnectionBits) | slot;
+    // Each connection trades as its own account for risk limits
+    enqueue(OrderMessage::newOrder(Order(orderId, static_cast<OrderSide>(request.side), price,
+                                         request.quantity, request.symbol, type, timeInForce),
+                                   static_cast<AccountId>(slot)));
+    answer(slot, request.clientOrderId, orderId);
+}
+
+void OrderGateway::handleCancel(size_t slot, const WireCancel& request) {
+    if (!symbols_.contains(request.symbol)) {
+        sendReject(slot, request.clientOrderId, RejectReason::UnknownSymbol);
+        return;
+    }
+    if (!owns(slot, request.orderId)) {
+        sendReject(slot, request.clientOrderId, RejectReason::UnknownOrder);
+        return;
+    }
+
+    enqueue(OrderMessage::cancel(request.orderId, request.symbol));
+    answer(slot, request.clientOrderId, request.orderId);
+}
+
+void OrderGateway::handleModify(size_t slot, const WireModify& request) {
+    if (!symbols_.contains(request.symbol)) {
+        sendReject(slot, request.clientOrderId, RejectReason::UnknownSymbol);
+        return;
+    }
+    if (!owns(slot, request.orderId)) {
+        sendReject(slot, request.clientOrderId, RejectReason::UnknownOrder);
+        return;
+    }
+
+    if (request.quantity > Order::kMaxQuantity) {
+        sendReject(slot, request.clientOrderId, RejectReason::InvalidQuantity);
+        return;
+    }
+
+    Price price = Price::fromRaw(request.priceRaw);
+    if (request.quantity > 0 && !symbols_.get(request.symbol).tickConfig.isValid(price)) {
+        sendReject(slot, request.clientOrderId, RejectReason::InvalidPrice);
+        return;
+    }
+
+    enqueue(OrderMessage::modify(request.orderId, price, request.quantity, request.symbol));
+    answer(slot, request.clientOrderId, request.orderId);
+}
+
+void OrderGateway::enqueue(const OrderMessage& message) {
+    batch_.push_back(message);
+    batch_.back().ingestNs = receivedNs_;
+    if (batch_.size() == kMaxBatchSize) {
+        pushBatch();
+    }
+}
+
+void OrderGateway::pushBatch() {
+    if (batch_.empty()) {
+        return;
+    }
+    queue_->pushBatch(batch_.data(), batch_.size());
+    accepted_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    batch_.clear();
+}
+
+bool OrderGateway::owns(size_t slot, uint64_t orderId) const {
+    return (orderId & (kMaxConnections - 1)) == slot &&
+           orderId >= connections_[slot].firstOrderId &&
+           (orderId >> kConnectionBits) < nextSequence_;
+}
+
+void OrderGateway::answer(size_t slot, uint64_t clientOrderId, uint64_t orderId) {
+    if (decisions_ == nullptr) {
+        sendAck(slot, clientOrderId, orderId);
+        return;
+    }
+    pending_[pendingTail_++ & (kPendingAnswerCapacity - 1)] = PendingAnswer{slot, clientOrderId, orderId};
+}
+
+void OrderGateway::relayDecisions() {
+    if (decisions_ == nullptr) {
+        return;
+    }
+    decisions_->poll(decisionReader_, [this](const RiskDecision& decision) {
+        const PendingAnswer& request = pending_[pendingHead_++ & (kPendingAnswerCapacity - 1)];
+        if (connections_[request.slot].fd < 0 || !owns(request.slot, request.orderId)) {
+            return;     // Requester disconnected
+        }
+        if (decision.reason == RiskReject::None) {
+            sendAck(request.slot, request.clientOrderId, request.orderId);
+        } else {
+            sendReject(request.slot, request.clientOrderId, RejectReason::RiskLimit, decision.reason);
+        }
+    });
+}
+
+void OrderGateway::relayFills() {
+    bool decided = false;
+    for (const auto& reader : fillReaders_) {
+        reader.ring->poll(reader.id, [this, &decided](const Trade& trade) {
+            // Risk published the decision on an order before forwarding
+            // it, so catching up here puts every Ack ahead of its fills
+            if (!decided) {
+                relayDecisions();
+                decided = true;
+            }
+            const Price price = Price::fromDouble(trade.price);
+            const std::pair<uint64_t, OrderSide> parties[] = {
+                {trade.buyOrderId, OrderSide::Buy}, {trade.sellOrderId, OrderSide::Sell}};
+
+            for (const auto& [orderId, side] : parties) {
+                size_t slot = static_cast<size_t>(orderId & (kMaxConnections - 1));
+                if (connections_[slot].fd < 0 || !owns(slot, orderId)) {
+                    continue;   // Owner disconnected
+                }
+                auto fill = makeWireMessage<WireFill>(WireType::Fill);
+                fill.orderId = orderId;
+                fill.priceRaw = price.raw();
+                fill.quantity = trade.quantity;
+                fill.symbol = trade.symbol;
+                fill.side = static_cast<uint8_t>(side);
+                send(slot, fill);
+            }
+        });
+    }
+}
+
+void OrderGateway::sendAck(size_t slot, uint64_t clientOrderId, uint64_t orderId) {
+    auto ack = makeWireMessage<WireAck>(WireType::Ack);
+    ack.clientOrderId = clientOrderId;
+    ack.orderId = orderId;
+    send(slot, ack);
+}
+
+void OrderGateway::sendReject(size_t slot, uint64_t clientOrderId, RejectReason reason,
+                              RiskReject riskReason) {
+    auto reject = makeWireMessage<WireReject>(WireType::Reject);
+    reject.clientOrderId = clientOrderId;
+    reject.reason = static_cast<uint8_t>(reason);
+    reject.riskReason = static_cast<uint8_t>(riskReason);
+    send(slot, reject);
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T>
+void OrderGateway::send(size_t slot, const T& message) {
+    Connection& connection = connections_[slot];
+    const char* bytes = reinterpret_cast<const char*>(&message);
+    connection.output.insert(connection.output.end(), bytes, bytes + sizeof(T));
+    if (!connection.dirty) {
+        connection.dirty = true;
+        dirty_.push_back(slot);
+    }
+}
+
+void OrderGateway::flushClients() {
+    for (size_t slot : dirty_) {
+        connections_[slot].dirty = false;
+        if (connections_[slot].fd >= 0) {
+            flushClient(slot);
+        }
+    }
+    dirty_.clear();
+}
+
+bool OrderGateway::flushClient(size_t slot) {
+    Connection& connection = connections_[slot];
+
+    while (connection.outputOffset < connection.output.size()) {
+        ssize_t bytes = ::send(connection.fd, connection.output.data() + connection.outputOffset,
+                               connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+        if (bytes > 0) {
+            connection.outputOffset += static_cast<size_t>(bytes);
+        } else if (bytes < 0 && errno == EINTR) {
+            continue;
+        } else if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeClient(slot);
+            return false;
+        }
+    }
+
+    size_t pending = connection.output.size() - connection.outputOffset;
+    if (pending == 0) {
+        connection.output.clear();
+        connection.outputOffset = 0;
+    } else if (pending > kMaxPendingOutput) {
+        // The client stopped reading its reports
+        closeClient(slot);
+        return false;
+    }
+
+    // Ask for EPOLLOUT only while output is backed up
+    bool wantWritable = pending > 0;
+    if (wantWritable != connection.waitingWritable) {
+        connection.waitingWritable = wantWritable;
+        // A paused client is re-registered with the right events on resume
+        if (!connection.paused && !watchClient(slot, EPOLL_CTL_MOD)) {
+            closeClient(slot);
+            return false;
+        }
+    }
+    return true;
+}
+
+void OrderGateway::closeClient(size_t slot) {
+    Connection& connection = connections_[slot];
+    ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connection.fd = -1;
+    connection.inputSize = 0;
+    connection.output.clear();
+    connection.outputOffset = 0;
+    connection.waitingWritable = false;
+    connection.paused = false;
+    freeSlots_.push_back(slot);
+    connected_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+#else
+
+bool OrderGateway::open() {
+    error_ = "The order gateway needs epoll (Linux)";
+    return false;
+}
+
+void OrderGateway::run(QueueWriter<OrderMessage>&) {}
+
+#endif
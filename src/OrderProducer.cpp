@@ -1,33 +1,50 @@
 #include "OrderProducer.h"
+#include "OrderEventFile.h"
+#include "LineReader.h"
 #include <random>
 #include <thread>
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cmath>
 
-OrderProducer::OrderProducer(ThreadSafeQueue<Order>& queue, ProducerMode mode)
-    : queue_(queue), mode_(mode), running_(true), nextOrderId_(1) {}
+OrderProducer::OrderProducer(QueueWriter<OrderMessage>& queue, ProducerMode mode,
+                             const SymbolDirectory& symbols, const ReplayConfig& replay)
+    : queue_(queue), mode_(mode), symbols_(symbols), running_(true), nextOrderId_(1),
+      replay_(replay), replayed_(0), skipped_(0), textParser_(symbols) {}
 
 void OrderProducer::run() {
-    if (mode_ == ProducerMode::Random) {
+    if (mode_ == ProducerMode::Replay) {
+        runReplay();
+    } else if (mode_ == ProducerMode::Stream) {
+        runStream();
+    } else if (mode_ == ProducerMode::Random) {
         // Random mode: generate orders continuously
         while (running_) {
-            Order order = generateRandomOrder();
-            queue_.push(order);
+            OrderMessage message = generateRandomMessage();
+            message.ingestNs = steadyNowNs();
+            queue_.push(message);
 
             // Sleep for a short time to simulate realistic order flow
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     } else {
         // Stdin mode: read orders from standard input
-        std::cout << "Enter orders in format: <BUY|SELL> <price> <quantity>" << std::endl;
+        std::cout << "Enter orders in format: <BUY|SELL> <price|MARKET> <quantity> [id] [symbol] [IOC|FOK]" << std::endl;
+        std::cout << "                        CANCEL <id>" << std::endl;
+        std::cout << "                        MODIFY <id> <price> <quantity>" << std::endl;
         std::cout << "Example: BUY 100.50 1000" << std::endl;
         std::cout << "Type 'quit' to exit" << std::endl;
 
         while (running_) {
-            Order order(0, OrderSide::Buy, 0.0, 0);
-            if (readOrderFromStdin(order)) {
-                queue_.push(order);
+            OrderMessage message = OrderMessage::cancel(0);
+            if (readMessageFromStdin(message)) {
+                if (message.order.getId() != 0) {
+                    message.ingestNs = steadyNowNs();
+                    queue_.push(message);
+                }
             } else {
                 break;
             }
@@ -57,41 +74,145 @@ Order OrderProducer::generateRandomOrder() {
 
     uint64_t orderId = nextOrderId_++;
 
-    return Order(orderId, side, price, quantity);
+    return Order(orderId, side, price, quantity, randomSymbolFor(orderId));
 }
 
-bool OrderProducer::readOrderFromStdin(Order& order) {
+OrderMessage OrderProducer::generateRandomMessage() {
+    static std::mt19937 gen(std::random_device{}());
+
+    // Roughly one message in ten cancels a previously generated order
+    std::uniform_int_distribution<> actionDist(0, 9);
+    uint64_t lastId = nextOrderId_.load() - 1;
+    if (lastId > 0 && actionDist(gen) == 0) {
+        std::uniform_int_distribution<uint64_t> idDist(1, lastId);
+        uint64_t id = idDist(gen);
+        return OrderMessage::cancel(id, randomSymbolFor(id));
+    }
+
+    Order order = generateRandomOrder();
+    return OrderMessage::newOrder(order, static_cast<AccountId>(order.getId() % kRandomAccounts));
+}
+
+bool OrderProducer::readMessageFromStdin(OrderMessage& message) {
     std::string line;
     if (!std::getline(std::cin, line)) {
         return false;
     }
 
-    if (line == "quit" || line == "exit") {
+    switch (textParser_.parse(line, message)) {
+    case ParseStatus::Quit:
         return false;
+    case ParseStatus::Error:
+        std::cerr << textParser_.getError() << std::endl;
+        return true;
+    case ParseStatus::Message:
+        if (message.type == MessageType::New) {
+            std::cout << "Order " << message.order.getId() << " submitted" << std::endl;
+        }
+        return true;
+    case ParseStatus::Blank:
+        break;
     }
+    return true; // Skip blank lines
+}
 
-    std::istringstream iss(line);
-    std::string sideStr;
-    double price;
-    uint64_t quantity;
+void OrderProducer::runReplay() {
+    MappedOrderEventFile file;
+    if (!file.open(replay_.path)) {
+        std::cerr << "Cannot replay order event file: " << replay_.path << std::endl;
+        return;
+    }
 
-    if (!(iss >> sideStr >> price >> quantity)) {
-        std::cerr << "Invalid format. Use: <BUY|SELL> <price> <quantity>" << std::endl;
-        return true; // Continue reading
+    const OrderEventRecord* records = file.records();
+    const size_t count = file.size();
+    if (count == 0) {
+        return;
     }
 
-    OrderSide side;
-    if (sideStr == "BUY" || sideStr == "buy") {
-        side = OrderSide::Buy;
-    } else if (sideStr == "SELL" || sideStr == "sell") {
-        side = OrderSide::Sell;
-    } else {
-        std::cerr << "Invalid side. Use BUY or SELL" << std::endl;
-        return true;
+    const auto start = std::chrono::steady_clock::now();
+    const int64_t firstTimestamp = records[0].timestampNs;
+
+    for (size_t i = 0; i < count && running_; ++i) {
+        const OrderEventRecord& record = records[i];
+
+        if (replay_.recordedPace) {
+            auto due = start + std::chrono::nanoseconds(record.timestampNs - firstTimestamp);
+            // Sleep through long gaps in short steps so stop() is honoured,
+            // then spin for the last stretch
+            while (running_ && due - std::chrono::steady_clock::now() > std::chrono::milliseconds(2)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            while (running_ && std::chrono::steady_clock::now() < due) {
+            }
+        }
+
+        OrderMessage message = OrderMessage::cancel(0);
+        if (!toOrderMessage(record, message)) {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        message.ingestNs = steadyNowNs();
+        queue_.push(message);
+        replayed_.fetch_add(1, std::memory_order_relaxed);
     }
 
-    uint64_t orderId = nextOrderId_++;
-    order = Order(orderId, side, price, quantity);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Replayed " << replayed_.load() << " events in " << seconds << " s";
+    if (skipped_.load() > 0) {
+        std::cout << " (" << skipped_.load() << " invalid records skipped)";
+    }
+    std::cout << std::endl;
+}
+
+void OrderProducer::runStream() {
+    std::string path = replay_.path.empty() ? "-" : replay_.path;
+    LineReader reader(path);
+    if (!reader.isOpen()) {
+        std::cerr << "Cannot read order text: " << path << std::endl;
+        return;
+    }
+
+    std::vector<OrderMessage> batch;
+    batch.reserve(kStreamBatchSize);
+    OrderMessage message = OrderMessage::cancel(0);
+    std::string_view line;
+    uint64_t lineNumber = 0;
+    uint64_t pushed = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    // Lines of one batch arrived together, so they share one ingest stamp
+    auto flush = [&]() {
+        const int64_t ingestNs = steadyNowNs();
+        for (auto& pending : batch) {
+            pending.ingestNs = ingestNs;
+        }
+        queue_.pushBatch(batch.data(), batch.size());
+        pushed += batch.size();
+        replayed_.store(pushed, std::memory_order_relaxed);
+        batch.clear();
+    };
+
+    while (running_ && reader.next(line)) {
+        lineNumber++;
+        ParseStatus status = textParser_.parse(line, message);
+        if (status == ParseStatus::Quit) {
+            break;
+        }
+        if (status == ParseStatus::Error) {
+            std::cerr << path << ":" << lineNumber << ": " << textParser_.getError() << std::endl;
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (status == ParseStatus::Message) {
+            batch.push_back(message);
+            if (batch.size() == kStreamBatchSize) {
+                flush();
+            }
+        }
+    }
+    flush();
 
-    return true;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Streamed " << pushed << " orders from " << lineNumber << " lines in "
+              << seconds << " s" << std::endl;
 }
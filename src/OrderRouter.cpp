@@ -0,0 +1,68 @@
+#include "OrderRouter.h"
+
+OrderRouter::OrderRouter(const SymbolDirectory& directory,
+                         const std::vector<ConcurrentQueue<OrderMessage>*>& shardQueues)
+    : directory_(directory), shardQueues_(shardQueues), rejected_(0) {}
+
+void OrderRouter::push(const OrderMessage& message) {
+    SymbolId symbol = message.order.getSymbol();
+    if (!directory_.contains(symbol) || shardQueues_.empty()) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    shardQueues_[shardFor(symbol, shardQueues_.size())]->push(message);
+}
+
+void OrderRouter::pushBatch(const OrderMessage* messages, size_t count) {
+    size_t begin = 0;
+    while (begin < count) {
+        SymbolId symbol = messages[begin].order.getSymbol();
+        if (!directory_.contains(symbol) || shardQueues_.empty()) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            begin++;
+            continue;
+        }
+
+        size_t shard = shardFor(symbol, shardQueues_.size());
+        size_t end = begin + 1;
+        while (end < count && directory_.contains(messages[end].order.getSymbol()) &&
+               shardFor(messages[end].order.getSymbol(), shardQueues_.size()) == shard) {
+            end++;
+        }
+        shardQueues_[shard]->pushBatch(messages + begin, end - begin);
+        begin = end;
+    }
+}
+
+size_t OrderRouter::tryPushBatch(const OrderMessage* messages, size_t count) {
+    size_t begin = 0;
+    while (begin < count) {
+        SymbolId symbol = messages[begin].order.getSymbol();
+        if (!directory_.contains(symbol) || shardQueues_.empty()) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            begin++;
+            continue;
+        }
+
+        size_t shard = shardFor(symbol, shardQueues_.size());
+        size_t end = begin + 1;
+        while (end < count && directory_.contains(messages[end].order.getSymbol()) &&
+               shardFor(messages[end].order.getSymbol(), shardQueues_.size()) == shard) {
+            end++;
+        }
+        size_t pushed = shardQueues_[shard]->tryPushBatch(messages + begin, end - begin);
+        begin += pushed;
+        if (begin < end) {
+            break;      // Shard queue full
+        }
+    }
+    return begin;
+}
+
+size_t OrderRouter::pendingCount() const {
+    size_t total = 0;
+    for (const auto* queue : shardQueues_) {
+        total += queue->size();
+    }
+    return total;
+}
@@ -0,0 +1,236 @@
+#include "OrderTextParser.h"
+#include <algorithm>
+
+namespace {
+
+bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+// Next separator-delimited column of [pos, end); false if none is left
+bool nextToken(const char*& pos, const char* end, std::string_view& token) {
+    while (pos < end && isSeparator(*pos)) {
+        pos++;
+    }
+    if (pos == end) {
+        return false;
+    }
+    const char* begin = pos;
+    while (pos < end && !isSeparator(*pos)) {
+        pos++;
+    }
+    token = std::string_view(begin, pos - begin);
+    return true;
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Case-insensitive comparison with an upper-case keyword
+bool isKeyword(std::string_view token, std::string_view keyword) {
+    if (token.size() != keyword.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < token.size(); ++i) {
+        char c = token[i];
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        if (c != keyword[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseUnsigned(std::string_view token, uint64_t& value) {
+    if (token.empty()) {
+        return false;
+    }
+    uint64_t result = 0;
+    for (char c : token) {
+        if (!isDigit(c) || result > (UINT64_MAX - 9) / 10) {
+            return false;
+        }
+        result = result * 10 + static_cast<uint64_t>(c - '0');
+    }
+    value = result;
+    return true;
+}
+
+// Decimal price parsed directly into Price raw units
+bool parsePrice(std::string_view token, Price& price) {
+    size_t i = 0;
+    int64_t whole = 0;
+    bool anyDigit = false;
+
+    // Whole units, kept small enough to scale without overflowing
+    for (; i < token.size() && isDigit(token[i]); ++i) {
+        const int digit = token[i] - '0';
+        if (whole > (INT64_MAX / Price::kScale - digit) / 10) {
+            return false;
+        }
+        whole = whole * 10 + digit;
+        anyDigit = true;
+    }
+
+    int64_t fraction = 0;
+    if (i < token.size() && token[i] == '.') {
+        int64_t unit = Price::kScale;
+        for (++i; i < token.size() && isDigit(token[i]); ++i) {
+            if (unit > 1) {
+                unit /= 10;
+                fraction += (token[i] - '0') * unit;
+            } else if (unit == 1) {
+                // Round on the first digit past the fixed-point scale
+                fraction += token[i] >= '5' ? 1 : 0;
+                unit = 0;
+            }
+            anyDigit = true;
+        }
+    }
+
+    if (!anyDigit || i != token.size() || whole > (INT64_MAX - fraction) / Price::kScale) {
+        return false;
+    }
+    price = Price::fromRaw(whole * Price::kScale + fraction);
+    return true;
+}
+
+} // namespace
+
+OrderTextParser::OrderTextParser(const SymbolDirectory& symbols, uint64_t firstOrderId)
+    : symbols_(symbols), nextOrderId_(firstOrderId) {}
+
+ParseStatus OrderTextParser::parse(std::string_view line, OrderMessage& message,
+                                   int64_t& timestampNs) {
+    const char* pos = line.data();
+    const char* end = pos + line.size();
+    std::string_view token;
+
+    if (!nextToken(pos, end, token)) {
+        return ParseStatus::Blank;
+    }
+    if (isKeyword(token, "QUIT") || isKeyword(token, "EXIT")) {
+        return ParseStatus::Quit;
+    }
+
+    // Optional leading arrival timestamp
+    if (isDigit(token[0])) {
+        uint64_t timestamp;
+        if (!parseUnsigned(token, timestamp) || timestamp > INT64_MAX) {
+            return fail("Invalid timestamp: " + std::string(token));
+        }
+        timestampNs = static_cast<int64_t>(timestamp);
+        if (!nextToken(pos, end, token)) {
+            return fail("Missing instruction after timestamp");
+        }
+    }
+
+    uint64_t id;
+    uint64_t quantity;
+    Price price;
+
+    if (isKeyword(token, "CANCEL")) {
+        if (!nextToken(pos, end, token) || !parseUnsigned(token, id)) {
+            return fail("Invalid format. Use: CANCEL <id>");
+        }
+        message = OrderMessage::cancel(id, symbolOf(id));
+        return ParseStatus::Message;
+    }
+
+    if (isKeyword(token, "MODIFY")) {
+        std::string_view priceToken;
+        std::string_view quantityToken;
+        if (!nextToken(pos, end, token) || !parseUnsigned(token, id) ||
+            !nextToken(pos, end, priceToken) || !parsePrice(priceToken, price) ||
+            !nextToken(pos, end, quantityToken) || !parseUnsigned(quantityToken, quantity) ||
+            quantity > Order::kMaxQuantity) {
+            return fail("Invalid format. Use: MODIFY <id> <price> <quantity>");
+        }
+        message = OrderMessage::modify(id, price, quantity, symbolOf(id));
+        return ParseStatus::Message;
+    }
+
+    OrderSide side;
+    if (isKeyword(token, "BUY")) {
+        side = OrderSide::Buy;
+    } else if (isKeyword(token, "SELL")) {
+        side = OrderSide::Sell;
+    } else {
+        return fail("Invalid side. Use BUY or SELL");
+    }
+
+    // Price is a number or MARKET
+    OrderType type = OrderType::Limit;
+    TimeInForce timeInForce = TimeInForce::GoodTillCancel;
+    std::string_view priceToken;
+    std::string_view quantityToken;
+    if (!nextToken(pos, end, priceToken) || !nextToken(pos, end, quantityToken) ||
+        !parseUnsigned(quantityToken, quantity)) {
+        return fail("Invalid format. Use: <BUY|SELL> <price|MARKET> <quantity> [id] [symbol] [IOC|FOK]");
+    }
+    if (quantity > Order::kMaxQuantity) {
+        return fail("Quantity too large: " + std::string(quantityToken));
+    }
+    if (isKeyword(priceToken, "MARKET")) {
+        type = OrderType::Market;
+        timeInForce = TimeInForce::ImmediateOrCancel;
+    } else if (!parsePrice(priceToken, price)) {
+        return fail("Invalid price: " + std::string(priceToken));
+    }
+
+    // Optional id, symbol and time-in-force columns; the first registered
+    // symbol by default
+    SymbolId symbol = 0;
+    bool explicitId = false;
+    while (nextToken(pos, end, token)) {
+        if (isDigit(token[0])) {
+            if (!parseUnsigned(token, id) || id == 0) {
+                return fail("Invalid order id: " + std::string(token));
+            }
+            explicitId = true;
+        } else if (isKeyword(token, "IOC")) {
+            timeInForce = TimeInForce::ImmediateOrCancel;
+        } else if (isKeyword(token, "FOK")) {
+            timeInForce = TimeInForce::FillOrKill;
+        } else if (isKeyword(token, "GTC")) {
+            if (type == OrderType::Market) {
+                return fail("Market orders cannot rest (GTC)");
+            }
+            timeInForce = TimeInForce::GoodTillCancel;
+        } else {
+            auto found = symbols_.find(token);
+            if (!found.has_value()) {
+                return fail("Unknown symbol: " + std::string(token));
+            }
+            symbol = *found;
+        }
+    }
+
+    if (explicitId) {
+        nextOrderId_ = std::max(nextOrderId_, id + 1);
+    } else {
+        id = nextOrderId_++;
+    }
+    message = OrderMessage::newOrder(Order(id, side, price, quantity, symbol, type, timeInForce));
+    rememberSymbol(id, symbol);
+    return ParseStatus::Message;
+}
+
+void OrderTextParser::rememberSymbol(uint64_t id, SymbolId symbol) {
+    // With a single symbol every order belongs to symbol 0
+    if (symbols_.size() <= 1) {
+        return;
+    }
+
+    if (id < kDenseIdLimit) {
+        if (id >= denseSymbols_.size()) {
+            denseSymbols_.resize(std::max<size_t>(id + 1, denseSymbols_.size() * 2), 0);
+        }
+        denseSymbols_[id] = symbol;
+    } else {
+        sparseSymbols_[id] = symbol;
+    }
+}
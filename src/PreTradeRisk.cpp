@@ -0,0 +1,190 @@
+#include "PreTradeRisk.h"
+#include <algorithm>
+#include <cmath>
+
+const char* toString(RiskReject reason) {
+    switch (reason) {
+    case RiskReject::None:
+        return "none";
+    case RiskReject::UnknownAccount:
+        return "unknown_account";
+    case RiskReject::UnknownSymbol:
+        return "unknown_symbol";
+    case RiskReject::OrderTooLarge:
+        return "order_too_large";
+    case RiskReject::InvalidPrice:
+        return "invalid_price";
+    case RiskReject::PriceOutsideCollar:
+        return "price_outside_collar";
+    case RiskReject::OpenQuantityLimit:
+        return "open_quantity_limit";
+    case RiskReject::NotionalLimit:
+        return "notional_limit";
+    case RiskReject::DuplicateOrderId:
+        return "duplicate_order_id";
+    }
+    return "unknown";
+}
+
+PreTradeRisk::PreTradeRisk(const SymbolDirectory& directory, const RiskLimits& limits)
+    : limits_(limits),
+      maxOpenNotional_(static_cast<uint64_t>(std::llround(limits.maxOpenNotional * Price::kScale))),
+      accounts_(limits.accountCount), collars_(directory.size()) {
+    ticks_.reserve(directory.size());
+    for (SymbolId symbol = 0; symbol < directory.size(); ++symbol) {
+        ticks_.push_back(directory.get(symbol).tickConfig);
+    }
+    open_.reserve(1 << 16);
+}
+
+RiskReject PreTradeRisk::check(const OrderMessage& message) {
+    switch (message.type) {
+    case MessageType::New:
+        return checkNew(message);
+    case MessageType::Modify:
+        return checkModify(message);
+    case MessageType::Cancel: {
+        auto order = open_.find(message.order.getId());
+        if (order != open_.end()) {
+            release(order, order->second.quantity);
+        }
+        return RiskReject::None;
+    }
+    }
+    return RiskReject::None;
+}
+
+RiskReject PreTradeRisk::checkNew(const OrderMessage& message) {
+    const Order& order = message.order;
+    const SymbolId symbol = order.getSymbol();
+    if (message.account >= accounts_.size()) {
+        return RiskReject::UnknownAccount;
+    }
+    if (symbol >= ticks_.size()) {
+        return RiskReject::UnknownSymbol;
+    }
+    if (order.getQuantity() > limits_.maxOrderQuantity) {
+        return RiskReject::OrderTooLarge;
+    }
+
+    int64_t priceRaw;
+    if (order.getType() == OrderType::Market) {
+        // Valued at the last trade; nothing to value it at before one
+        priceRaw = collars_[symbol].lastRaw;
+    } else {
+        if (!ticks_[symbol].isValid(order.getFixedPrice())) {
+            return RiskReject::InvalidPrice;
+        }
+        if (!insideCollar(symbol, order.getFixedPrice())) {
+            return RiskReject::PriceOutsideCollar;
+        }
+        priceRaw = order.getFixedPrice().raw();
+    }
+
+    AccountExposure& exposure = accounts_[message.account];
+    const uint64_t notional = static_cast<uint64_t>(std::max<int64_t>(priceRaw, 0)) * order.getQuantity();
+    RiskReject headroom = checkHeadroom(exposure, order.getQuantity(), notional);
+    if (headroom != RiskReject::None) {
+        return headroom;
+    }
+
+    if (!order.canRest()) {
+        return RiskReject::None;
+    }
+    if (!open_.emplace(order.getId(), OpenOrder{message.account, priceRaw, order.getQuantity()}).second) {
+        return RiskReject::DuplicateOrderId;
+    }
+    exposure.openQuantity += order.getQuantity();
+    exposure.openNotional += notional;
+    return RiskReject::None;
+}
+
+RiskReject PreTradeRisk::checkModify(const OrderMessage& message) {
+    auto found = open_.find(message.order.getId());
+    if (found == open_.end()) {
+        return RiskReject::None;
+    }
+    OpenOrder& order = found->second;
+    const uint64_t newQuantity = message.order.getQuantity();
+    if (newQuantity == 0) {
+        release(found, order.quantity);
+        return RiskReject::None;
+    }
+    if (newQuantity > limits_.maxOrderQuantity) {
+        return RiskReject::OrderTooLarge;
+    }
+    const SymbolId symbol = message.order.getSymbol();
+    if (symbol >= ticks_.size()) {
+        return RiskReject::UnknownSymbol;
+    }
+    if (!ticks_[symbol].isValid(message.order.getFixedPrice())) {
+        return RiskReject::InvalidPrice;
+    }
+    if (!insideCollar(symbol, message.order.getFixedPrice())) {
+        return RiskReject::PriceOutsideCollar;
+    }
+
+    // Check the account as if the order were replaced by the amended one
+    AccountExposure& exposure = accounts_[order.account];
+    const uint64_t oldNotional = static_cast<uint64_t>(std::max<int64_t>(order.priceRaw, 0)) * order.quantity;
+    const int64_t newPriceRaw = message.order.getFixedPrice().raw();
+    const uint64_t newNotional = static_cast<uint64_t>(std::max<int64_t>(newPriceRaw, 0)) * newQuantity;
+    AccountExposure without{exposure.openQuantity - order.quantity, exposure.openNotional - oldNotional};
+    RiskReject headroom = checkHeadroom(without, newQuantity, newNotional);
+    if (headroom != RiskReject::None) {
+        return headroom;
+    }
+
+    exposure.openQuantity = without.openQuantity + newQuantity;
+    exposure.openNotional = without.openNotional + newNotional;
+    order.priceRaw = newPriceRaw;
+    order.quantity = newQuantity;
+    return RiskReject::None;
+}
+
+void PreTradeRisk::applyFill(const Trade& trade) {
+    for (uint64_t id : {trade.buyOrderId, trade.sellOrderId}) {
+        auto order = open_.find(id);
+        if (order != open_.end()) {
+            release(order, std::min(trade.quantity, order->second.quantity));
+        }
+    }
+
+    if (trade.symbol < collars_.size()) {
+        Collar& collar = collars_[trade.symbol];
+        collar.lastRaw = Price::fromDouble(trade.price).raw();
+        const int64_t width = std::llround(static_cast<double>(collar.lastRaw) * limits_.priceCollar);
+        collar.low = collar.lastRaw - width;
+        collar.high = collar.lastRaw + width;
+        collar.active = limits_.priceCollar > 0;
+    }
+}
+
+bool PreTradeRisk::insideCollar(SymbolId symbol, Price price) const {
+    if (symbol >= collars_.size() || !collars_[symbol].active) {
+        return true;
+    }
+    const Collar& collar = collars_[symbol];
+    return price.raw() >= collar.low && price.raw() <= collar.high;
+}
+
+RiskReject PreTradeRisk::checkHeadroom(const AccountExposure& exposure, uint64_t quantity,
+                                       uint64_t notional) const {
+    if (exposure.openQuantity + quantity > limits_.maxOpenQuantity) {
+        return RiskReject::OpenQuantityLimit;
+    }
+    if (exposure.openNotional + notional > maxOpenNotional_) {
+        return RiskReject::NotionalLimit;
+    }
+    return RiskReject::None;
+}
+
+void PreTradeRisk::release(std::unordered_map<uint64_t, OpenOrder>::iterator order, uint64_t quantity) {
+    AccountExposure& exposure = accounts_[order->second.account];
+    exposure.openQuantity -= quantity;
+    exposure.openNotional -= static_cast<uint64_t>(std::max<int64_t>(order->second.priceRaw, 0)) * quantity;
+    order->second.quantity -= quantity;
+    if (order->second.quantity == 0) {
+        open_.erase(order);
+    }
+}
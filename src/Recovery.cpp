@@ -0,0 +1,227 @@
+#include "Recovery.h"
+#include "Journal.h"
+#include "OrderEventFile.h"
+#include "TradeSink.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'L', 'O', 'B', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t kSnapshotVersion = 1;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t journalSequence;
+    uint64_t nextOrderId;
+    uint64_t orderCount;
+};
+
+} // namespace
+
+bool writeSnapshot(const std::string& path, const SnapshotData& snapshot) {
+    const std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.recordSize = sizeof(SnapshotOrderRecord);
+    header.journalSequence = snapshot.journalSequence;
+    header.nextOrderId = snapshot.nextOrderId;
+    header.orderCount = snapshot.orders.size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(snapshot.orders.data(), sizeof(SnapshotOrderRecord),
+                          snapshot.orders.size(), file) == snapshot.orders.size() &&
+              std::fflush(file) == 0 && ::fsync(fileno(file)) == 0;
+    ok = std::fclose(file) == 0 && ok;
+
+    // The previous snapshot stays valid until the new one is complete
+    return ok && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool readSnapshot(const std::string& path, SnapshotData& snapshot) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0 &&
+                 header.version == kSnapshotVersion &&
+                 header.recordSize == sizeof(SnapshotOrderRecord);
+
+    if (valid) {
+        snapshot.journalSequence = header.journalSequence;
+        snapshot.nextOrderId = header.nextOrderId;
+        snapshot.orders.resize(header.orderCount);
+        valid = std::fread(snapshot.orders.data(), sizeof(SnapshotOrderRecord), header.orderCount,
+                           file) == header.orderCount;
+    }
+
+    std::fclose(file);
+    return valid;
+}
+
+Snapshotter::Snapshotter(const std::string& path, const Journal* journal)
+    : path_(path), journal_(journal), hasPending_(false), running_(false), busy_(false), written_(0) {}
+
+Snapshotter::~Snapshotter() {
+    stop();
+}
+
+void Snapshotter::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread([this]() { writeLoop(); });
+}
+
+void Snapshotter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    ready_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Snapshotter::submit(SnapshotData&& snapshot) {
+    if (busy_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = std::move(snapshot);
+        hasPending_ = true;
+    }
+    ready_.notify_one();
+}
+
+void Snapshotter::writeLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        ready_.wait(lock, [this]() { return hasPending_ || !running_; });
+        if (!hasPending_) {
+            return;
+        }
+
+        SnapshotData snapshot = std::move(pending_);
+        hasPending_ = false;
+        lock.unlock();
+
+        if (waitForJournal(snapshot.journalSequence) && writeSnapshot(path_, snapshot)) {
+            written_.fetch_add(1, std::memory_order_relaxed);
+        }
+        busy_.store(false, std::memory_order_release);
+
+        lock.lock();
+    }
+}
+
+bool Snapshotter::waitForJournal(uint64_t sequence) {
+    if (journal_ == nullptr) {
+        return true;
+    }
+    while (journal_->getDurableSequence() < sequence) {
+        if (journal_->hasFailed()) {
+            return false;   // The snapshot would cover records that are not stored
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                // The journal is stopped before the snapshotter, so this is final
+                return journal_->getDurableSequence() >= sequence;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return true;
+}
+
+RecoveryResult recoverEngines(const std::string& snapshotPath, const std::string& journalPath,
+                              const std::vector<MatchingEngine*>& enginesBySymbol) {
+    RecoveryResult result;
+    auto engineFor = [&](SymbolId symbol) {
+        return symbol < enginesBySymbol.size() ? enginesBySymbol[symbol] : nullptr;
+    };
+
+    // Latest snapshot, if any
+    if (::access(snapshotPath.c_str(), F_OK) == 0) {
+        SnapshotData snapshot;
+        if (!readSnapshot(snapshotPath, snapshot)) {
+            result.ok = false;
+            result.error = "Cannot read snapshot " + snapshotPath;
+            return result;
+        }
+
+        for (const auto& record : snapshot.orders) {
+            if (record.side > static_cast<uint8_t>(OrderSide::Sell) || record.quantity == 0 ||
+                record.quantity > Order::kMaxQuantity) {
+                result.ok = false;
+                result.error = "Snapshot " + snapshotPath + " holds an invalid order";
+                return result;
+            }
+            MatchingEngine* engine = engineFor(record.symbol);
+            if (engine != nullptr &&
+                engine->getOrderBook().addOrder(Order(record.orderId,
+                                                      static_cast<OrderSide>(record.side),
+                                                      Price::fromRaw(record.priceRaw),
+                                                      record.quantity, record.symbol))) {
+                result.restoredOrders++;
+            }
+        }
+        result.snapshotSequence = snapshot.journalSequence;
+        result.journalSequence = snapshot.journalSequence;
+        result.nextOrderId = snapshot.nextOrderId;
+    }
+
+    // Journal tail written after the snapshot
+    std::vector<JournalRecord> tail;
+    uint64_t lastSequence = 0;
+    if (!readJournal(journalPath, result.snapshotSequence, tail, &lastSequence)) {
+        result.ok = false;
+        result.error = "Cannot read journal " + journalPath;
+        return result;
+    }
+    if (lastSequence < result.snapshotSequence ||
+        (!tail.empty() && tail.front().sequence != result.snapshotSequence + 1)) {
+        result.ok = false;
+        result.error = "Journal " + journalPath + " does not continue snapshot " + snapshotPath;
+        return result;
+    }
+
+    NullTradeSink replayedFills;
+    for (const auto& record : tail) {
+        OrderMessage message = OrderMessage::cancel(0);
+        if (!toOrderMessage(record.event, message)) {
+            result.ok = false;
+            result.error = "Journal " + journalPath + " holds an invalid record at sequence " +
+                           std::to_string(record.sequence);
+            return result;
+        }
+        if (MatchingEngine* engine = engineFor(message.order.getSymbol())) {
+            engine->processMessage(message, replayedFills);
+        }
+        if (message.type == MessageType::New && message.order.getId() >= result.nextOrderId) {
+            result.nextOrderId = message.order.getId() + 1;
+        }
+        result.journalSequence = record.sequence;
+        result.replayedEvents++;
+    }
+
+    return result;
+}
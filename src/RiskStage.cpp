@@ -0,0 +1,126 @@
+#include "RiskStage.h"
+#include "SpscRingBuffer.h"
+#include "ThreadAffinity.h"
+#include "ThreadSafeQueue.h"
+#include <iostream>
+
+RiskStage::RiskStage(const SymbolDirectory& directory, const RiskLimits& limits,
+                     QueueKind queueKind, size_t maxBatchSize)
+    : risk_(directory, limits), downstream_(nullptr), decisions_(nullptr),
+      maxBatchSize_(maxBatchSize > 0 ? maxBatchSize : 1), accepted_(0) {
+    if (queueKind == QueueKind::Spsc) {
+        queue_ = std::make_unique<SpscRingBuffer<OrderMessage>>();
+    } else {
+        queue_ = std::make_unique<ThreadSafeQueue<OrderMessage>>();
+    }
+    for (auto& count : rejected_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    batch_.reserve(maxBatchSize_);
+    forward_.reserve(maxBatchSize_);
+}
+
+RiskStage::~RiskStage() {
+    stop();
+}
+
+bool RiskStage::addFillSource(TradeBus& bus) {
+    auto id = bus.ring().addReader(true);
+    if (id == MulticastRing<Trade>::kMaxReaders) {
+        return false;
+    }
+    fillReaders_.push_back(TradeBusReader{&bus.ring(), id});
+    return true;
+}
+
+uint64_t RiskStage::getRejectedCount() const {
+    uint64_t total = 0;
+    for (const auto& count : rejected_) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void RiskStage::start(QueueWriter<OrderMessage>& downstream, int core) {
+    if (thread_.joinable()) {
+        return;
+    }
+    downstream_ = &downstream;
+
+    thread_ = std::thread([this, core]() {
+        if (core >= 0 && !pinCurrentThreadToCore(core)) {
+            std::cerr << "Could not pin risk thread to core " << core << std::endl;
+        }
+        run();
+    });
+}
+
+void RiskStage::stop() {
+    if (thread_.joinable()) {
+        queue_->close();
+        thread_.join();
+    }
+
+    // Engines that are still running must not wait for this stage
+    for (const auto& reader : fillReaders_) {
+        reader.ring->detach(reader.id);
+    }
+}
+
+void RiskStage::run() {
+    while (true) {
+        batch_.clear();
+        if (queue_->popBatchFor(batch_, maxBatchSize_, kIdleFillPollInterval) == 0) {
+            // Keep draining while input is idle: fill readers gate the
+            // engines, which would stall once a bus is a ring ahead of us
+            if (queue_->isClosed() && queue_->empty()) {
+                return;
+            }
+            drainFills();
+            continue;
+        }
+
+        // Check against exposure that includes every fill reported so far
+        drainFills();
+
+        forward_.clear();
+        for (const auto& message : batch_) {
+            RiskReject reason = risk_.check(message);
+            if (decisions_ != nullptr) {
+                // Published before the batch goes downstream, so a reader
+                // that sees an order's fills can already see its decision
+                decisions_->publish(RiskDecision{message.order.getId(), reason});
+            }
+            if (reason == RiskReject::None) {
+                forward_.push_back(message);
+            } else {
+                rejected_[static_cast<size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (!forward_.empty()) {
+            forwardBatch();
+            accepted_.fetch_add(forward_.size(), std::memory_order_relaxed);
+        }
+    }
+}
+
+void RiskStage::forwardBatch() {
+    size_t sent = 0;
+    while (true) {
+        sent += downstream_->tryPushBatch(forward_.data() + sent, forward_.size() - sent);
+        if (sent == forward_.size()) {
+            return;
+        }
+        // A full shard queue may be an engine waiting on its fill bus for
+        // this thread, so keep reading fills until the queue has room
+        drainFills();
+        std::this_thread::yield();
+    }
+}
+
+void RiskStage::drainFills() {
+    for (const auto& reader : fillReaders_) {
+        reader.ring->poll(reader.id, [this](const Trade& trade) { risk_.applyFill(trade); });
+    }
+}
@@ -0,0 +1,22 @@
+#include "SymbolDirectory.h"
+
+SymbolId SymbolDirectory::add(const std::string& name, const TickConfig& tickConfig,
+                              size_t orderCapacity) {
+    auto it = byName_.find(name);
+    if (it != byName_.end()) {
+        return it->second;
+    }
+
+    SymbolId id = static_cast<SymbolId>(symbols_.size());
+    symbols_.push_back(SymbolInfo{name, tickConfig, orderCapacity});
+    byName_.emplace(symbols_.back().name, id);
+    return id;
+}
+
+std::optional<SymbolId> SymbolDirectory::find(std::string_view name) const {
+    auto it = byName_.find(name);
+    if (it == byName_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
@@ -0,0 +1,183 @@
+#include "TradeTape.h"
+#include "Price.h"
+#include <chrono>
+#include <cstring>
+#include <cinttypes>
+
+namespace {
+
+constexpr char kTapeMagic[8] = {'L', 'O', 'B', 'T', 'A', 'P', 'E', '\0'};
+constexpr uint32_t kTapeVersion = 2;
+
+} // namespace
+
+size_t formatTradeRecord(const TradeRecord& record, char* buffer, size_t size) {
+    int written = std::snprintf(buffer, size,
+                                "[TRADE] Seq: %" PRIu64 " Symbol: %" PRIu32 " BuyOrderID: %" PRIu64
+                                " SellOrderID: %" PRIu64 " Price: %.4f Quantity: %" PRIu64
+                                " TimestampNs: %" PRId64 "\n",
+                                record.sequence, record.symbol, record.buyOrderId, record.sellOrderId,
+                                Price::fromRaw(record.priceRaw).toDouble(), record.quantity,
+                                record.timestampNs);
+    if (written < 0) {
+        return 0;
+    }
+    return static_cast<size_t>(written) < size ? static_cast<size_t>(written) : size - 1;
+}
+
+bool readTradeTape(const std::string& path, std::vector<TradeRecord>& records) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    TapeHeader header;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, kTapeMagic, sizeof(kTapeMagic)) == 0 &&
+                 header.version == kTapeVersion &&
+                 header.recordSize == sizeof(TradeRecord);
+
+    if (valid) {
+        TradeRecord chunk[4096];
+        size_t count;
+        while ((count = std::fread(chunk, sizeof(TradeRecord), 4096, file)) > 0) {
+            records.insert(records.end(), chunk, chunk + count);
+        }
+    }
+
+    std::fclose(file);
+    return valid;
+}
+
+TradeTape::TradeTape(const std::string& path, TapeFormat format, size_t ringCapacity)
+    : file_(std::fopen(path.c_str(), format == TapeFormat::Binary ? "wb" : "w")),
+      format_(format), ring_(ringCapacity), buffered_(0), running_(false), nextSequence_(0),
+      failed_(false), lost_(0), latency_(nullptr), batchNs_(0) {
+    buffer_.reserve(kWriteBufferSize);
+
+    if (file_ == nullptr) {
+        return;
+    }
+
+    // Writes are already batched; stdio buffering would only add a copy
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+
+    if (format_ == TapeFormat::Binary) {
+        TapeHeader header;
+        std::memcpy(header.magic, kTapeMagic, sizeof(kTapeMagic));
+        header.version = kTapeVersion;
+        header.recordSize = sizeof(TradeRecord);
+        if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+            // A tape without a valid header is unreadable; report it as not open
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+}
+
+TradeTape::~TradeTape() {
+    stop();
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+void TradeTape::start() {
+    if (file_ == nullptr || running_) {
+        return;
+    }
+    running_ = true;
+    writer_ = std::thread([this]() { writeLoop(); });
+}
+
+void TradeTape::stop() {
+    running_ = false;
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void TradeTape::onTrade(const Trade& trade) {
+    TradeRecord record;
+    record.sequence = nextSequence_.load(std::memory_order_relaxed);
+    record.buyOrderId = trade.buyOrderId;
+    record.sellOrderId = trade.sellOrderId;
+    record.priceRaw = Price::fromDouble(trade.price).raw();
+    record.quantity = trade.quantity;
+    // The engine stamps each batch once; callers outside an engine worker
+    // that never call onBatch() get the time of receipt
+    record.timestampNs = batchNs_;
+    if (record.timestampNs == 0) {
+        record.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    record.symbol = trade.symbol;
+    record.reserved = 0;
+    nextSequence_.store(record.sequence + 1, std::memory_order_relaxed);
+
+    ring_.push(record);
+}
+
+void TradeTape::writeLoop() {
+    while (running_) {
+        if (drain() == 0) {
+            // Idle: hand what we have to the OS and back off briefly
+            flushBuffer();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Final drain after stop() so no appended trade is lost
+    while (drain() > 0) {
+    }
+    flushBuffer();
+    if (std::fflush(file_) != 0) {
+        failed_.store(true, std::memory_order_release);
+    }
+}
+
+size_t TradeTape::drain() {
+    char line[256];
+    size_t count = 0;
+
+    while (auto record = ring_.tryPop()) {
+        if (latency_ != nullptr) {
+            int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            int64_t waitNs = nowNs - record->timestampNs;
+            latency_->record(waitNs > 0 ? static_cast<uint64_t>(waitNs) : 0);
+        }
+
+        if (format_ == TapeFormat::Binary) {
+            const char* bytes = reinterpret_cast<const char*>(&*record);
+            buffer_.insert(buffer_.end(), bytes, bytes + sizeof(TradeRecord));
+        } else {
+            size_t length = formatTradeRecord(*record, line, sizeof(line));
+            buffer_.insert(buffer_.end(), line, line + length);
+        }
+        buffered_++;
+        count++;
+
+        if (buffer_.size() + sizeof(line) > kWriteBufferSize) {
+            flushBuffer();
+        }
+    }
+
+    return count;
+}
+
+void TradeTape::flushBuffer() {
+    if (buffer_.empty()) {
+        return;
+    }
+
+    if (!failed_.load(std::memory_order_relaxed) &&
+        std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+        failed_.store(true, std::memory_order_release);
+    }
+    if (failed_.load(std::memory_order_relaxed)) {
+        lost_.fetch_add(buffered_, std::memory_order_relaxed);
+    }
+    buffer_.clear();
+    buffered_ = 0;
+}
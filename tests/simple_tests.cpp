@@ -1,9 +1,52 @@
 #include "Order.h"
 #include "OrderBook.h"
 #include "MatchingEngine.h"
+#include "TradeSink.h"
+#include "SpscRingBuffer.h"
+#include "ThreadSafeQueue.h"
+#include "TradeTape.h"
+#include "ObjectPool.h"
+#include "AllocationCounter.h"
+#include "SymbolDirectory.h"
+#include "OrderRouter.h"
+#include "EngineShard.h"
+#include "SeqLock.h"
+#include "MarketDataPublisher.h"
+#include "LatencyHistogram.h"
+#include "OrderEventFile.h"
+#include "OrderTextParser.h"
+#include "OrderProducer.h"
+#include "Journal.h"
+#include "Recovery.h"
+#include "LineReader.h"
+#include "OrderGateway.h"
+#include "LevelBitmap.h"
+#include "MapOrderBook.h"
+#include "BookDifferential.h"
+#include "PreTradeRisk.h"
+#include "RiskStage.h"
+#include "MulticastRing.h"
+#include "TradeBus.h"
+#include "WaitStrategy.h"
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <thread>
+#include <cstdio>
+#include <chrono>
+#include <atomic>
+#include <tuple>
+#include <set>
+#include <random>
+#if defined(__linux__)
+#include <csignal>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#endif
 
 // Simple test framework
 #define ASSERT_EQUAL(expected, actual) \
@@ -231,6 +274,2312 @@ bool test_matching_engine_multiple_levels() {
     return true;
 }
 
+bool test_price_fixed_point_levels() {
+    OrderBook book;
+    book.addOrder(Order(1, OrderSide::Buy, 100.1, 100));
+    book.addOrder(Order(2, OrderSide::Buy, 100.10000001, 200));
+
+    auto bids = book.getTopBids(10);
+    ASSERT_EQUAL(1u, bids.size());
+    ASSERT_EQUAL(300u, bids[0].totalQuantity);
+
+    return true;
+}
+
+bool test_orderbook_rejects_invalid_price() {
+    TickConfig config;
+    config.tickSize = Price::fromDouble(0.05);
+    config.minPrice = Price::fromDouble(90.00);
+    config.maxPrice = Price::fromDouble(110.00);
+    OrderBook book(config);
+
+    ASSERT_FALSE(book.addOrder(Order(1, OrderSide::Buy, 100.02, 100)));
+    ASSERT_FALSE(book.addOrder(Order(2, OrderSide::Sell, 120.00, 100)));
+    ASSERT_TRUE(book.addOrder(Order(3, OrderSide::Sell, 100.05, 100)));
+    ASSERT_FALSE(book.getBestBid().has_value());
+
+    return true;
+}
+
+bool test_orderbook_best_moves_after_level_empties() {
+    OrderBook book;
+    book.addOrder(Order(1, OrderSide::Sell, 100.00, 100));
+    book.addOrder(Order(2, OrderSide::Sell, 104.00, 200));
+
+    book.removeAskQuantity(100);
+    auto bestAsk = book.getBestAsk();
+    ASSERT_TRUE(bestAsk.has_value());
+    ASSERT_EQUAL(2u, bestAsk->getId());
+
+    book.removeAskQuantity(200);
+    ASSERT_FALSE(book.getBestAsk().has_value());
+
+    return true;
+}
+
+bool test_orderbook_cancel_order() {
+    OrderBook book;
+    book.addOrder(Order(1, OrderSide::Buy, 100.00, 100));
+    book.addOrder(Order(2, OrderSide::Buy, 100.00, 200));
+    book.addOrder(Order(3, OrderSide::Buy, 99.00, 300));
+
+    ASSERT_TRUE(book.cancelOrder(1));
+    ASSERT_FALSE(book.cancelOrder(1));
+    ASSERT_EQUAL(2u, book.getOrderCount());
+
+    auto bestBid = book.getBestBid();
+    ASSERT_TRUE(bestBid.has_value());
+    ASSERT_EQUAL(2u, bestBid->getId());
+
+    ASSERT_TRUE(book.cancelOrder(2));
+    bestBid = book.getBestBid();
+    ASSERT_TRUE(bestBid.has_value());
+    ASSERT_EQUAL(3u, bestBid->getId());
+
+    return true;
+}
+
+bool test_orderbook_modify_priority() {
+    OrderBook book;
+    book.addOrder(Order(1, OrderSide::Sell, 101.00, 500));
+    book.addOrder(Order(2, OrderSide::Sell, 101.00, 500));
+
+    // Reduction keeps the front of the queue
+    ASSERT_TRUE(book.modifyOrder(1, 300, Price::fromDouble(101.00)));
+    ASSERT_EQUAL(1u, book.getBestAsk()->getId());
+    ASSERT_EQUAL(800u, book.getTopAsks(1)[0].totalQuantity);
+
+    // Increase moves to the back
+    ASSERT_TRUE(book.modifyOrder(1, 600, Price::fromDouble(101.00)));
+    ASSERT_EQUAL(2u, book.getBestAsk()->getId());
+    ASSERT_EQUAL(1100u, book.getTopAsks(1)[0].totalQuantity);
+
+    // Price change moves the order to its new level
+    ASSERT_TRUE(book.modifyOrder(1, 600, Price::fromDouble(100.50)));
+    ASSERT_EQUAL(1u, book.getBestAsk()->getId());
+    ASSERT_EQUAL(2u, book.getTopAsks(10).size());
+
+    ASSERT_FALSE(book.modifyOrder(42, 100, Price::fromDouble(100.00)));
+
+    // Zero and sizes that do not fit an Order are refused, not truncated
+    ASSERT_FALSE(book.modifyOrder(1, 0, Price::fromDouble(100.50)));
+    ASSERT_FALSE(book.modifyOrder(1, Order::kMaxQuantity + 1, Price::fromDouble(100.50)));
+    ASSERT_EQUAL(600u, book.getOrder(1)->getQuantity());
+
+    return true;
+}
+
+bool test_orderbook_rejects_live_id_before_matching() {
+    OrderBook book;
+    book.addOrder(Order(1, OrderSide::Buy, 100.00, 10));
+    book.addOrder(Order(2, OrderSide::Sell, 101.00, 10));
+
+    // Crosses the resting ask, but id 1 is live: no trade, nothing changes
+    std::vector<Trade> trades;
+    TradeCollector collector(trades);
+    Order duplicate(1, OrderSide::Buy, 101.00, 5);
+    ASSERT_FALSE(book.match(duplicate, collector));
+    ASSERT_TRUE(trades.empty());
+    ASSERT_EQUAL(5u, duplicate.getQuantity());
+    ASSERT_EQUAL(10u, book.getOrder(2)->getQuantity());
+    ASSERT_EQUAL(10u, book.getOrder(1)->getQuantity());
+
+    MapOrderBook reference;
+    reference.addOrder(Order(1, OrderSide::Buy, 100.00, 10));
+    reference.addOrder(Order(2, OrderSide::Sell, 101.00, 10));
+    Order again(1, OrderSide::Buy, 101.00, 5);
+    ASSERT_FALSE(reference.match(again, collector));
+    ASSERT_TRUE(trades.empty());
+
+    return true;
+}
+
+bool test_order_index_many_orders() {
+    OrderBook book;
+    for (uint64_t id = 1; id <= 5000; ++id) {
+        book.addOrder(Order(id, OrderSide::Buy, 90.00 + (id % 50) * 0.01, 10));
+    }
+    for (uint64_t id = 1; id <= 5000; id += 2) {
+        ASSERT_TRUE(book.cancelOrder(id));
+    }
+    ASSERT_EQUAL(2500u, book.getOrderCount());
+    for (uint64_t id = 2; id <= 5000; id += 2) {
+        ASSERT_TRUE(book.getOrder(id).has_value());
+        ASSERT_FALSE(book.getOrder(id - 1).has_value());
+    }
+
+    return true;
+}
+
+bool test_matching_engine_cancel_modify_messages() {
+    OrderBook book;
+    MatchingEngine engine(book);
+
+    engine.processMessage(OrderMessage::newOrder(Order(1, OrderSide::Sell, 101.00, 300)));
+    engine.processMessage(OrderMessage::newOrder(Order(2, OrderSide::Buy, 99.00, 200)));
+
+    // Moving the bid through the ask trades immediately
+    auto trades = engine.processMessage(OrderMessage::modify(2, Price::fromDouble(101.00), 200));
+    ASSERT_EQUAL(1u, trades.size());
+    ASSERT_EQUAL(2u, trades[0].buyOrderId);
+    ASSERT_EQUAL(200u, trades[0].quantity);
+    ASSERT_FALSE(book.getBestBid().has_value());
+
+    engine.processMessage(OrderMessage::cancel(1));
+    ASSERT_FALSE(book.getBestAsk().has_value());
+    ASSERT_EQUAL(0u, book.getOrderCount());
+
+    return true;
+}
+
+bool test_orderbook_match_sweeps_and_rests() {
+    OrderBook book;
+    book.addOrder(Order(1, OrderSide::Sell, 100.00, 300));
+    book.addOrder(Order(2, OrderSide::Sell, 100.00, 200));
+    book.addOrder(Order(3, OrderSide::Sell, 101.00, 400));
+    book.addOrder(Order(4, OrderSide::Sell, 102.00, 100));
+
+    std::vector<Trade> trades;
+    TradeCollector collector(trades);
+    Order bid(5, OrderSide::Buy, 101.00, 1000);
+
+    ASSERT_TRUE(book.match(bid, collector));
+    ASSERT_EQUAL(3u, trades.size());
+    ASSERT_EQUAL(1u, trades[0].sellOrderId);
+    ASSERT_EQUAL(2u, trades[1].sellOrderId);
+    ASSERT_EQUAL(3u, trades[2].sellOrderId);
+    ASSERT_EQUAL(100u, bid.getQuantity());
+
+    // Remainder rests as the best bid, ask side keeps the 102 level
+    ASSERT_EQUAL(5u, book.getBestBid()->getId());
+    ASSERT_EQUAL(100u, book.getBestBid()->getQuantity());
+    ASSERT_EQUAL(4u, book.getBestAsk()->getId());
+
+    return true;
+}
+
+bool test_partial_fill_keeps_time_priority() {
+    OrderBook book;
+    MatchingEngine engine(book);
+    book.addOrder(Order(1, OrderSide::Buy, 100.00, 500));
+    book.addOrder(Order(2, OrderSide::Buy, 100.00, 500));
+
+    engine.processOrder(Order(3, OrderSide::Sell, 100.00, 200));
+    auto trades = engine.processOrder(Order(4, OrderSide::Sell, 100.00, 400));
+
+    // Order 1 was partially filled but stays at the front of the level
+    ASSERT_EQUAL(2u, trades.size());
+    ASSERT_EQUAL(1u, trades[0].buyOrderId);
+    ASSERT_EQUAL(300u, trades[0].quantity);
+    ASSERT_EQUAL(2u, trades[1].buyOrderId);
+    ASSERT_EQUAL(100u, trades[1].quantity);
+
+    return true;
+}
+
+bool test_spsc_ring_buffer_fifo_and_capacity() {
+    SpscRingBuffer<uint64_t> ring(4);
+    ASSERT_EQUAL(4u, ring.capacity());
+    ASSERT_TRUE(ring.empty());
+
+    for (uint64_t i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(ring.tryPush(i));
+    }
+    ASSERT_FALSE(ring.tryPush(5));
+    ASSERT_EQUAL(4u, ring.size());
+
+    ASSERT_EQUAL(1u, ring.pop());
+    ASSERT_TRUE(ring.tryPush(5));
+    for (uint64_t i = 2; i <= 5; ++i) {
+        auto item = ring.tryPop();
+        ASSERT_TRUE(item.has_value());
+        ASSERT_EQUAL(i, *item);
+    }
+    ASSERT_FALSE(ring.tryPop().has_value());
+
+    return true;
+}
+
+bool test_spsc_ring_buffer_cross_thread() {
+    SpscRingBuffer<OrderMessage> ring(1024);
+    const uint64_t count = 200000;
+
+    std::thread producer([&ring, count]() {
+        for (uint64_t id = 1; id <= count; ++id) {
+            ring.push(OrderMessage::cancel(id));
+        }
+    });
+
+    bool ordered = true;
+    for (uint64_t id = 1; id <= count; ++id) {
+        if (ring.pop().order.getId() != id) {
+            ordered = false;
+        }
+    }
+    producer.join();
+
+    ASSERT_TRUE(ordered);
+    ASSERT_TRUE(ring.empty());
+
+    return true;
+}
+
+bool test_queue_pop_batch() {
+    ThreadSafeQueue<uint64_t> locked;
+    SpscRingBuffer<uint64_t> ring(16);
+    for (uint64_t i = 1; i <= 10; ++i) {
+        locked.push(i);
+        ring.push(i);
+    }
+
+    std::vector<uint64_t> out;
+    ASSERT_EQUAL(4u, locked.popBatch(out, 4));
+    ASSERT_EQUAL(6u, locked.popBatch(out, 100));
+    ASSERT_EQUAL(10u, out.size());
+    ASSERT_EQUAL(10u, out.back());
+
+    out.clear();
+    ASSERT_EQUAL(8u, ring.popBatch(out, 8));
+    ASSERT_EQUAL(2u, ring.size());
+    ASSERT_EQUAL(2u, ring.popBatch(out, 8));
+    ASSERT_EQUAL(1u, out.front());
+    ASSERT_EQUAL(10u, out.back());
+
+    return true;
+}
+
+bool test_matching_engine_process_batch() {
+    OrderBook book;
+    MatchingEngine engine(book);
+
+    std::vector<OrderMessage> batch = {
+        OrderMessage::newOrder(Order(1, OrderSide::Sell, 100.00, 300)),
+        OrderMessage::newOrder(Order(2, OrderSide::Sell, 100.50, 300)),
+        OrderMessage::cancel(1),
+        OrderMessage::newOrder(Order(3, OrderSide::Buy, 101.00, 200)),
+        OrderMessage::newOrder(Order(4, OrderSide::Buy, 101.00, 200)),
+    };
+
+    std::vector<Trade> trades;
+    TradeCollector collector(trades);
+    engine.processBatch(batch.data(), batch.size(), collector);
+
+    ASSERT_EQUAL(2u, trades.size());
+    ASSERT_EQUAL(2u, trades[0].sellOrderId);
+    ASSERT_EQUAL(100u, trades[1].quantity);
+    ASSERT_EQUAL(4u, engine.getLastTrade()->buyOrderId);
+    ASSERT_EQUAL(4u, book.getBestBid()->getId());
+
+    return true;
+}
+
+bool test_trade_tape_round_trip() {
+    const std::string path = "test_trade_tape.bin";
+    {
+        TradeTape tape(path, TapeFormat::Binary, 64);
+        ASSERT_TRUE(tape.isOpen());
+        tape.start();
+
+        OrderBook book;
+        MatchingEngine engine(book);
+        for (uint64_t id = 1; id <= 500; ++id) {
+            book.addOrder(Order(id, OrderSide::Sell, 100.00 + (id % 5) * 0.25, 10));
+        }
+        // One batch stamp covers every fill of the sweep
+        tape.onBatch(123456789);
+        engine.processOrder(Order(1000, OrderSide::Buy, 101.00, 5000), tape);
+        tape.stop();
+        ASSERT_EQUAL(500u, tape.getRecordCount());
+    }
+
+    std::vector<TradeRecord> records;
+    ASSERT_TRUE(readTradeTape(path, records));
+    std::remove(path.c_str());
+
+    ASSERT_EQUAL(500u, records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_EQUAL(i, records[i].sequence);
+        ASSERT_EQUAL(1000u, records[i].buyOrderId);
+        ASSERT_EQUAL(10u, records[i].quantity);
+        ASSERT_EQUAL(123456789, records[i].timestampNs);
+    }
+    // Best ask first: the 100.00 level
+    ASSERT_EQUAL(Price::fromDouble(100.00).raw(), records.front().priceRaw);
+    ASSERT_EQUAL(Price::fromDouble(101.00).raw(), records.back().priceRaw);
+
+    return true;
+}
+
+bool test_object_pool_reuses_slots() {
+    ObjectPool<OrderNode> pool(2, 2);
+    OrderNode* a = pool.create(Order(1, OrderSide::Buy, 100.00, 10));
+    OrderNode* b = pool.create(Order(2, OrderSide::Buy, 100.00, 10));
+    ASSERT_EQUAL(2u, pool.capacity());
+
+    pool.destroy(a);
+    OrderNode* c = pool.create(Order(3, OrderSide::Buy, 100.00, 10));
+    ASSERT_TRUE(a == c);
+    ASSERT_EQUAL(3u, c->order.getId());
+
+    // Exhausted pool grows by a chunk
+    OrderNode* d = pool.create(Order(4, OrderSide::Buy, 100.00, 10));
+    ASSERT_EQUAL(4u, pool.capacity());
+    ASSERT_EQUAL(3u, pool.inUse());
+
+    pool.destroy(b);
+    pool.destroy(c);
+    pool.destroy(d);
+    ASSERT_EQUAL(0u, pool.inUse());
+
+    return true;
+}
+
+bool test_steady_state_matching_does_not_allocate() {
+    OrderBook book(TickConfig(), 4096);
+    MatchingEngine engine(book);
+    NullTradeSink sink;
+
+    // One cycle: rest a ladder of orders, amend and cancel some, sweep the rest
+    std::vector<OrderMessage> cycle;
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        cycle.push_back(OrderMessage::newOrder(
+            Order(id, OrderSide::Sell, 100.00 + (id % 20) * 0.01, 10)));
+    }
+    for (uint64_t id = 1; id <= 1000; id += 3) {
+        cycle.push_back(OrderMessage::modify(id, Price::fromDouble(100.50), 5));
+    }
+    for (uint64_t id = 2; id <= 1000; id += 3) {
+        cycle.push_back(OrderMessage::cancel(id));
+    }
+    cycle.push_back(OrderMessage::newOrder(Order(5000, OrderSide::Buy, 101.00, 100000)));
+    cycle.push_back(OrderMessage::cancel(5000));
+
+    engine.processBatch(cycle.data(), cycle.size(), sink);
+    ASSERT_EQUAL(0u, book.getOrderCount());
+
+    uint64_t before = allocationCount();
+    for (int round = 0; round < 10; ++round) {
+        engine.processBatch(cycle.data(), cycle.size(), sink);
+    }
+    uint64_t after = allocationCount();
+
+    ASSERT_EQUAL(before, after);
+    ASSERT_EQUAL(0u, book.getOrderCount());
+
+    return true;
+}
+
+bool test_symbol_directory_lookup() {
+    SymbolDirectory directory;
+    SymbolId aapl = directory.add("AAPL");
+    SymbolId msft = directory.add("MSFT");
+    ASSERT_EQUAL(0u, aapl);
+    ASSERT_EQUAL(1u, msft);
+
+    // Re-adding a known name returns its id
+    ASSERT_EQUAL(aapl, directory.add("AAPL"));
+    ASSERT_EQUAL(2u, directory.size());
+
+    ASSERT_TRUE(directory.find("MSFT").has_value());
+    ASSERT_EQUAL(msft, *directory.find("MSFT"));
+    ASSERT_FALSE(directory.find("GOOG").has_value());
+    ASSERT_EQUAL(std::string("MSFT"), directory.get(msft).name);
+
+    // Names past the small-string buffer are found without allocating, and
+    // stay valid as the directory grows
+    const std::string longName = "INDEX-FUTURE-DEC-2030-WEEKLY-SERIES";
+    SymbolId future = directory.add(longName);
+    for (int i = 0; i < 100; ++i) {
+        directory.add("SYM" + std::to_string(i));
+    }
+    uint64_t before = allocationCount();
+    auto found = directory.find(std::string_view(longName));
+    ASSERT_EQUAL(before, allocationCount());
+    ASSERT_TRUE(found.has_value());
+    ASSERT_EQUAL(future, *found);
+
+    return true;
+}
+
+bool test_order_router_dispatches_by_symbol() {
+    SymbolDirectory directory;
+    directory.add("AAA");
+    directory.add("BBB");
+    directory.add("CCC");
+
+    ThreadSafeQueue<OrderMessage> shard0;
+    ThreadSafeQueue<OrderMessage> shard1;
+    OrderRouter router(directory, {&shard0, &shard1});
+
+    router.push(OrderMessage::newOrder(Order(1, OrderSide::Buy, 100.00, 10, 0)));
+    router.push(OrderMessage::newOrder(Order(2, OrderSide::Buy, 100.00, 10, 1)));
+    router.push(OrderMessage::cancel(3, 2));
+    router.push(OrderMessage::cancel(4, 7));
+
+    ASSERT_EQUAL(2u, shard0.size());
+    ASSERT_EQUAL(1u, shard1.size());
+    ASSERT_EQUAL(3u, router.pendingCount());
+    ASSERT_EQUAL(1u, router.getRejectedCount());
+    ASSERT_EQUAL(2u, shard1.pop().order.getId());
+
+    return true;
+}
+
+bool test_engine_shard_matches_each_symbol_independently() {
+    SymbolDirectory directory;
+    SymbolId aaa = directory.add("AAA", TickConfig(), 1024);
+    SymbolId bbb = directory.add("BBB", TickConfig(), 1024);
+
+    std::vector<Trade> trades;
+    TradeCollector collector(trades);
+    EngineShard shard(directory, {aaa, bbb}, QueueKind::Spsc, collector);
+    OrderRouter router(directory, {&shard.getQueue()});
+    shard.start();
+
+    // Same prices on both symbols: only orders of one symbol may cross
+    router.push(OrderMessage::newOrder(Order(1, OrderSide::Sell, 100.00, 10, aaa)));
+    router.push(OrderMessage::newOrder(Order(2, OrderSide::Buy, 100.00, 10, bbb)));
+    router.push(OrderMessage::newOrder(Order(3, OrderSide::Buy, 100.00, 4, aaa)));
+
+    auto settled = [&]() {
+        auto resting = shard.getBook(aaa)->getOrder(1);
+        return resting && resting->getQuantity() == 6 && shard.getBook(bbb)->getOrderCount() == 1;
+    };
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!settled() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    shard.stop();
+
+    ASSERT_EQUAL(1u, trades.size());
+    ASSERT_EQUAL(aaa, trades[0].symbol);
+    ASSERT_EQUAL(4u, trades[0].quantity);
+    ASSERT_EQUAL(6u, shard.getBook(aaa)->getOrder(1)->getQuantity());
+    ASSERT_EQUAL(1u, shard.getBook(bbb)->getOrderCount());
+    ASSERT_FALSE(shard.getBook(bbb)->getBestAsk().has_value());
+
+    return true;
+}
+
+bool test_engine_publishes_snapshot_after_batch() {
+    OrderBook book;
+    MatchingEngine engine(book);
+    NullTradeSink sink;
+
+    BookSnapshot empty = engine.getSnapshot();
+    ASSERT_EQUAL(0u, empty.bidLevels);
+    ASSERT_FALSE(empty.hasLastTrade);
+
+    std::vector<OrderMessage> batch = {
+        OrderMessage::newOrder(Order(1, OrderSide::Sell, 101.00, 10)),
+        OrderMessage::newOrder(Order(2, OrderSide::Sell, 101.00, 5)),
+        OrderMessage::newOrder(Order(3, OrderSide::Sell, 102.00, 7)),
+        OrderMessage::newOrder(Order(4, OrderSide::Buy, 99.00, 20)),
+        OrderMessage::newOrder(Order(5, OrderSide::Buy, 101.00, 4)),
+    };
+    engine.processBatch(batch.data(), batch.size(), sink);
+
+    BookSnapshot snapshot = engine.getSnapshot();
+    ASSERT_EQUAL(2u, snapshot.askLevels);
+    ASSERT_EQUAL(1u, snapshot.bidLevels);
+    ASSERT_TRUE(snapshot.asks[0].price == Price::fromDouble(101.00));
+    ASSERT_EQUAL(11u, snapshot.asks[0].totalQuantity);
+    ASSERT_EQUAL(2u, snapshot.asks[0].orderCount);
+    ASSERT_TRUE(snapshot.asks[1].price == Price::fromDouble(102.00));
+    ASSERT_TRUE(snapshot.bids[0].price == Price::fromDouble(99.00));
+    ASSERT_TRUE(snapshot.hasLastTrade);
+    ASSERT_TRUE(snapshot.lastTradePrice == Price::fromDouble(101.00));
+    ASSERT_EQUAL(4u, snapshot.lastTradeQuantity);
+    ASSERT_EQUAL(1u, snapshot.tradeCount);
+    ASSERT_EQUAL(5u, snapshot.messagesProcessed);
+    ASSERT_EQUAL(4u, snapshot.restingOrders);
+
+    return true;
+}
+
+bool test_seqlock_readers_never_see_torn_values() {
+    struct Payload {
+        uint64_t values[16];
+    };
+    SeqLock<Payload> lock;
+    std::atomic<bool> done(false);
+
+    std::thread writer([&]() {
+        Payload payload;
+        for (uint64_t i = 1; i <= 200000; ++i) {
+            for (auto& value : payload.values) {
+                value = i;
+            }
+            lock.write(payload);
+        }
+        done = true;
+    });
+
+    bool consistent = true;
+    uint64_t lastSeen = 0;
+    while (!done) {
+        Payload payload = lock.read();
+        for (auto value : payload.values) {
+            consistent = consistent && value == payload.values[0];
+        }
+        consistent = consistent && payload.values[0] >= lastSeen;
+        lastSeen = payload.values[0];
+    }
+    writer.join();
+
+    ASSERT_TRUE(consistent);
+    ASSERT_EQUAL(200000u, lock.read().values[15]);
+    ASSERT_EQUAL(200001u, lock.version());
+
+    return true;
+}
+
+bool test_orderbook_emits_level_and_trade_events() {
+    OrderBook book;
+    MatchingEngine engine(book);
+    std::vector<MarketDataEvent> events;
+    MarketDataCollector collector(events);
+    book.setMarketDataSink(&collector);
+
+    engine.processOrder(Order(1, OrderSide::Sell, 101.00, 10));
+    engine.processOrder(Order(2, OrderSide::Sell, 101.00, 5));
+    engine.processOrder(Order(3, OrderSide::Buy, 101.00, 12));
+
+    ASSERT_EQUAL(6u, events.size());
+    ASSERT_TRUE(events[0].type == MarketDataType::LevelAdd);
+    ASSERT_EQUAL(10u, events[0].quantity);
+    ASSERT_TRUE(events[1].type == MarketDataType::LevelUpdate);
+    ASSERT_EQUAL(15u, events[1].quantity);
+    ASSERT_EQUAL(2u, events[1].orderCount);
+
+    // Sweep: first order fully filled, second partially
+    ASSERT_TRUE(events[2].type == MarketDataType::Trade);
+    ASSERT_EQUAL(10u, events[2].quantity);
+    ASSERT_EQUAL(1u, events[2].sellOrderId);
+    ASSERT_TRUE(events[3].type == MarketDataType::LevelUpdate);
+    ASSERT_EQUAL(5u, events[3].quantity);
+    ASSERT_TRUE(events[4].type == MarketDataType::Trade);
+    ASSERT_EQUAL(2u, events[4].quantity);
+    ASSERT_TRUE(events[5].type == MarketDataType::LevelUpdate);
+    ASSERT_EQUAL(3u, events[5].quantity);
+
+    // A modify that changes nothing publishes nothing
+    events.clear();
+    ASSERT_TRUE(book.modifyOrder(2, 3, Price::fromDouble(101.00)));
+    ASSERT_EQUAL(0u, events.size());
+
+    book.cancelOrder(2);
+    ASSERT_EQUAL(1u, events.size());
+    ASSERT_TRUE(events[0].type == MarketDataType::LevelDelete);
+    ASSERT_TRUE(events[0].side == OrderSide::Sell);
+    ASSERT_TRUE(events[0].price == Price::fromDouble(101.00));
+
+    return true;
+}
+
+bool test_slow_subscriber_gets_conflated_levels() {
+    MarketDataSubscriber subscriber(2);
+    auto level = [](uint64_t sequence, double price, uint64_t quantity) {
+        return MarketDataEvent{sequence, MarketDataType::LevelUpdate, OrderSide::Buy, 0,
+                               Price::fromDouble(price), quantity, 1, 0, 0};
+    };
+
+    subscriber.deliver(level(1, 100.00, 10));
+    subscriber.deliver(level(2, 100.01, 10));
+    // Mailbox full: the rest collapses to the latest state per level
+    subscriber.deliver(level(3, 100.00, 20));
+    subscriber.deliver(MarketDataEvent{4, MarketDataType::Trade, OrderSide::Sell, 0,
+                                       Price::fromDouble(100.01), 5, 0, 1, 2});
+    subscriber.deliver(level(5, 100.01, 5));
+    subscriber.deliver(level(6, 100.00, 30));
+    ASSERT_TRUE(subscriber.isConflating());
+
+    std::vector<MarketDataEvent> events;
+    ASSERT_EQUAL(4u, subscriber.poll(events));
+    ASSERT_EQUAL(1u, events[0].sequence);
+    ASSERT_EQUAL(2u, events[1].sequence);
+    ASSERT_EQUAL(6u, events[2].sequence);
+    ASSERT_EQUAL(30u, events[2].quantity);
+    ASSERT_EQUAL(5u, events[3].sequence);
+    ASSERT_EQUAL(1u, subscriber.getConflatedCount());
+    ASSERT_EQUAL(1u, subscriber.getDroppedTradeCount());
+    ASSERT_FALSE(subscriber.isConflating());
+
+    // Caught up: events flow one by one again
+    subscriber.deliver(level(7, 100.02, 1));
+    events.clear();
+    ASSERT_EQUAL(1u, subscriber.poll(events));
+    ASSERT_EQUAL(7u, events[0].sequence);
+
+    return true;
+}
+
+bool test_market_data_publisher_fans_out() {
+    OrderBook book;
+    MatchingEngine engine(book);
+    MarketDataPublisher publisher;
+    MarketDataSubscriber first;
+    MarketDataSubscriber second;
+    publisher.subscribe(first);
+    publisher.subscribe(second);
+    book.setMarketDataSink(&publisher);
+    publisher.start();
+
+    engine.processOrder(Order(1, OrderSide::Sell, 101.00, 10));
+    engine.processOrder(Order(2, OrderSide::Buy, 101.00, 10));
+    publisher.stop();
+
+    std::vector<MarketDataEvent> a;
+    std::vector<MarketDataEvent> b;
+    ASSERT_EQUAL(3u, first.poll(a));
+    ASSERT_EQUAL(3u, second.poll(b));
+    ASSERT_EQUAL(3u, publisher.getPublishedCount());
+    for (size_t i = 0; i < a.size(); ++i) {
+        ASSERT_EQUAL(i + 1, a[i].sequence);
+        ASSERT_TRUE(a[i].type == b[i].type);
+    }
+    ASSERT_TRUE(a[1].type == MarketDataType::Trade);
+    ASSERT_TRUE(a[2].type == MarketDataType::LevelDelete);
+
+    return true;
+}
+
+bool test_latency_histogram_percentiles() {
+    LatencyHistogram histogram;
+    ASSERT_EQUAL(0u, histogram.percentile(0.5));
+
+    for (uint64_t value = 1; value <= 10000; ++value) {
+        histogram.record(value);
+    }
+    ASSERT_EQUAL(10000u, histogram.count());
+    ASSERT_EQUAL(10000u, histogram.max());
+    ASSERT_DOUBLE_EQUAL(5000.5, histogram.mean(), 1e-9);
+
+    // Log-linear buckets bound the relative error to 1/16
+    uint64_t p50 = histogram.percentile(0.50);
+    uint64_t p99 = histogram.percentile(0.99);
+    ASSERT_TRUE(p50 >= 5000 && p50 <= 5000 + 5000 / 16);
+    ASSERT_TRUE(p99 >= 9900 && p99 <= 9900 + 9900 / 16);
+    ASSERT_EQUAL(10000u, histogram.percentile(1.0));
+
+    // Every value lies inside its bucket
+    for (uint64_t value : {0ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, ~0ull}) {
+        size_t bucket = LatencyHistogram::bucketFor(value);
+        ASSERT_TRUE(bucket < LatencyHistogram::kBucketCount);
+        ASSERT_TRUE(value <= LatencyHistogram::bucketUpperBound(bucket));
+        ASSERT_TRUE(bucket == 0 || value > LatencyHistogram::bucketUpperBound(bucket - 1));
+    }
+
+    histogram.reset();
+    ASSERT_EQUAL(0u, histogram.count());
+
+    return true;
+}
+
+bool test_engine_worker_records_stage_latency() {
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("AAA", TickConfig(), 1024);
+    NullTradeSink sink;
+    PipelineLatency latency;
+
+    EngineShard shard(directory, {symbol}, QueueKind::Mutex, sink);
+    shard.setLatency(&latency);
+    shard.start();
+    for (uint64_t id = 1; id <= 100; ++id) {
+        // Stamped like a producer would; unstamped messages are not timed
+        OrderMessage message = OrderMessage::newOrder(Order(id, OrderSide::Buy, 100.00, 1, symbol));
+        message.ingestNs = steadyNowNs();
+        shard.getQueue().push(message);
+    }
+    shard.getQueue().push(OrderMessage::cancel(1, symbol));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (latency.matching.count() < 101 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    shard.stop();
+
+    ASSERT_EQUAL(100u, latency.queueWait.count());
+    ASSERT_TRUE(latency.matching.count() >= 101);
+    ASSERT_EQUAL(0u, latency.tradePublish.count());
+
+    return true;
+}
+
+bool test_order_text_parser_formats() {
+    SymbolDirectory directory;
+    directory.add("AAA");
+    directory.add("BBB");
+    OrderTextParser parser(directory);
+    OrderMessage message = OrderMessage::cancel(0);
+    int64_t timestamp = -1;
+
+    ASSERT_TRUE(parser.parse("BUY 100.50 10 BBB", message, timestamp) == ParseStatus::Message);
+    ASSERT_TRUE(message.type == MessageType::New);
+    ASSERT_EQUAL(1u, message.order.getId());
+    ASSERT_EQUAL(1u, message.order.getSymbol());
+    ASSERT_EQUAL(-1, timestamp);
+
+    // Cancels are routed to the symbol of the order they refer to
+    ASSERT_TRUE(parser.parse("5000 CANCEL 1", message, timestamp) == ParseStatus::Message);
+    ASSERT_TRUE(message.type == MessageType::Cancel);
+    ASSERT_EQUAL(1u, message.order.getSymbol());
+    ASSERT_EQUAL(5000, timestamp);
+
+    ASSERT_TRUE(parser.parse("", message) == ParseStatus::Blank);
+    ASSERT_TRUE(parser.parse("quit", message) == ParseStatus::Quit);
+    ASSERT_TRUE(parser.parse("HOLD 1 2", message) == ParseStatus::Error);
+    ASSERT_TRUE(parser.parse("SELL 1 2 CCC", message) == ParseStatus::Error);
+    ASSERT_EQUAL(2u, parser.getNextOrderId());
+
+    return true;
+}
+
+bool test_order_event_file_round_trip() {
+    const std::string path = "test_orders.events";
+    std::vector<OrderEventRecord> written = {
+        toOrderEventRecord(OrderMessage::newOrder(Order(1, OrderSide::Sell, 101.25, 10, 2)), 100),
+        toOrderEventRecord(OrderMessage::modify(1, Price::fromDouble(101.50), 8, 2), 250),
+        toOrderEventRecord(OrderMessage::cancel(1, 2), 400),
+    };
+    ASSERT_TRUE(writeOrderEventFile(path, written));
+
+    MappedOrderEventFile file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQUAL(3u, file.size());
+    ASSERT_EQUAL(250, file.records()[1].timestampNs);
+
+    OrderMessage added = OrderMessage::cancel(0);
+    ASSERT_TRUE(toOrderMessage(file.records()[0], added));
+    ASSERT_TRUE(added.type == MessageType::New);
+    ASSERT_TRUE(added.order.getSide() == OrderSide::Sell);
+    ASSERT_TRUE(added.order.getFixedPrice() == Price::fromDouble(101.25));
+    ASSERT_EQUAL(2u, added.order.getSymbol());
+
+    OrderMessage modified = OrderMessage::cancel(0);
+    ASSERT_TRUE(toOrderMessage(file.records()[1], modified));
+    ASSERT_TRUE(modified.type == MessageType::Modify);
+    ASSERT_EQUAL(8u, modified.order.getQuantity());
+    OrderMessage cancelled = OrderMessage::cancel(0);
+    ASSERT_TRUE(toOrderMessage(file.records()[2], cancelled));
+    ASSERT_TRUE(cancelled.type == MessageType::Cancel);
+    file.close();
+
+    // Fields are range-checked rather than cast
+    OrderMessage decoded = OrderMessage::cancel(0);
+    OrderEventRecord bad = written[0];
+    bad.type = 7;
+    ASSERT_FALSE(toOrderMessage(bad, decoded));
+    bad = written[0];
+    bad.side = 2;
+    ASSERT_FALSE(toOrderMessage(bad, decoded));
+    bad = written[0];
+    bad.orderType = 2;
+    ASSERT_FALSE(toOrderMessage(bad, decoded));
+    bad = written[0];
+    bad.timeInForce = 3;
+    ASSERT_FALSE(toOrderMessage(bad, decoded));
+    bad = written[0];
+    bad.quantity = 0;
+    ASSERT_FALSE(toOrderMessage(bad, decoded));
+    bad.quantity = Order::kMaxQuantity + 1;
+    ASSERT_FALSE(toOrderMessage(bad, decoded));
+    bad = written[1];
+    bad.quantity = Order::kMaxQuantity + 1;
+    ASSERT_FALSE(toOrderMessage(bad, decoded));
+    ASSERT_TRUE(decoded.type == MessageType::Cancel && decoded.order.getId() == 0);
+
+    // Files of another format are rejected
+    std::FILE* bogus = std::fopen(path.c_str(), "wb");
+    std::fputs("not an event file at all", bogus);
+    std::fclose(bogus);
+    ASSERT_FALSE(file.open(path));
+    std::remove(path.c_str());
+
+    return true;
+}
+
+bool test_replay_producer_pushes_all_events() {
+    const std::string path = "test_replay.events";
+    std::vector<OrderEventRecord> records;
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        records.push_back(toOrderEventRecord(
+            OrderMessage::newOrder(Order(id, OrderSide::Buy, 100.00, id, 0)), id * 1000));
+    }
+    // Corrupt records are skipped and counted, not replayed
+    OrderEventRecord corrupt = records[500];
+    corrupt.type = 9;
+    records.insert(records.begin() + 500, corrupt);
+    corrupt = records[700];
+    corrupt.quantity = uint64_t(1) << 40;
+    records.insert(records.begin() + 700, corrupt);
+    ASSERT_TRUE(writeOrderEventFile(path, records));
+
+    SymbolDirectory directory;
+    directory.add("SIM");
+    ThreadSafeQueue<OrderMessage> queue;
+    ReplayConfig replay;
+    replay.path = path;
+    replay.recordedPace = true;
+    OrderProducer producer(queue, ProducerMode::Replay, directory, replay);
+
+    auto start = std::chrono::steady_clock::now();
+    producer.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::remove(path.c_str());
+
+    // Recorded pacing spans the 999us between first and last event
+    ASSERT_TRUE(elapsed >= std::chrono::microseconds(999));
+    ASSERT_EQUAL(1000u, producer.getReplayedCount());
+    ASSERT_EQUAL(2u, producer.getSkippedCount());
+    ASSERT_EQUAL(1000u, queue.size());
+    ASSERT_EQUAL(1u, queue.pop().order.getId());
+
+    return true;
+}
+
+bool test_journal_continues_after_reopen() {
+    const std::string path = "test_orders.journal";
+    std::remove(path.c_str());
+    {
+        Journal journal(path);
+        ASSERT_TRUE(journal.isOpen());
+        journal.start();
+        for (uint64_t id = 1; id <= 3; ++id) {
+            ASSERT_EQUAL(id, journal.append(OrderMessage::newOrder(Order(id, OrderSide::Buy, 100.00, id))));
+        }
+        journal.stop();
+        ASSERT_EQUAL(3u, journal.getDurableSequence());
+    }
+
+    // A torn record at the tail is dropped when the journal is reopened
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    std::fputs("torn", file);
+    std::fclose(file);
+    {
+        Journal journal(path);
+        ASSERT_TRUE(journal.isOpen());
+        ASSERT_EQUAL(3u, journal.getSequence());
+        journal.start();
+        ASSERT_EQUAL(4u, journal.append(OrderMessage::cancel(2, 0)));
+        journal.stop();
+    }
+
+    std::vector<JournalRecord> records;
+    ASSERT_TRUE(readJournal(path, 0, records));
+    ASSERT_EQUAL(4u, records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_EQUAL(i + 1, records[i].sequence);
+    }
+    OrderMessage last = OrderMessage::newOrder(Order(0, OrderSide::Buy, 100.00, 1));
+    ASSERT_TRUE(toOrderMessage(records[3].event, last));
+    ASSERT_TRUE(last.type == MessageType::Cancel);
+
+    records.clear();
+    ASSERT_TRUE(readJournal(path, 2, records));
+    ASSERT_EQUAL(2u, records.size());
+    ASSERT_EQUAL(3u, records[0].sequence);
+    std::remove(path.c_str());
+
+    // A missing journal is simply empty
+    records.clear();
+    ASSERT_TRUE(readJournal(path, 0, records));
+    ASSERT_TRUE(records.empty());
+
+    return true;
+}
+
+bool test_recovery_rebuilds_books_from_snapshot_and_journal() {
+    const std::string journalPath = "test_recovery.journal";
+    const std::string snapshotPath = "test_recovery.snapshot";
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+
+    SymbolDirectory directory;
+    SymbolId aaa = directory.add("AAA", TickConfig(), 1024);
+    SymbolId bbb = directory.add("BBB", TickConfig(), 1024);
+
+    // Crossing and resting orders on two symbols, with some cancels
+    std::vector<OrderMessage> messages;
+    for (uint64_t i = 1; i <= 150; ++i) {
+        if (i % 10 == 0) {
+            messages.push_back(OrderMessage::cancel(i - 5, static_cast<SymbolId>((i - 5) % 2)));
+        } else {
+            OrderSide side = i % 3 == 0 ? OrderSide::Sell : OrderSide::Buy;
+            double price = 100.00 + (static_cast<int>(i % 7) - 3) * 0.01;
+            messages.push_back(OrderMessage::newOrder(
+                Order(i, side, price, 10 + i % 5, static_cast<SymbolId>(i % 2))));
+        }
+    }
+
+    NullTradeSink noTrades;
+    EngineShard original(directory, {aaa, bbb}, QueueKind::Spsc, noTrades, 16);
+    Journal journal(journalPath);
+    Snapshotter snapshotter(snapshotPath, &journal);
+    journal.start();
+    snapshotter.start();
+    original.setPersistence(&journal, &snapshotter, 100);
+    original.start();
+    for (const auto& message : messages) {
+        original.getQueue().push(message);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((journal.getDurableSequence() < messages.size() || snapshotter.getWrittenCount() == 0) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    original.stop();
+    journal.stop();
+    snapshotter.stop();
+    ASSERT_EQUAL(1u, snapshotter.getWrittenCount());
+
+    // A fresh shard sees the snapshot plus the journal tail after it
+    EngineShard recovered(directory, {aaa, bbb}, QueueKind::Spsc, noTrades, 16);
+    RecoveryResult result = recovered.recover(snapshotPath, journalPath);
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+
+    ASSERT_TRUE(result.ok);
+    ASSERT_TRUE(result.snapshotSequence >= 100);
+    ASSERT_TRUE(result.replayedEvents > 0);
+    ASSERT_EQUAL(journal.getDurableSequence(), result.journalSequence);
+    ASSERT_EQUAL(150u, result.nextOrderId);
+
+    // Same resting orders in the same priority order
+    for (SymbolId symbol : {aaa, bbb}) {
+        std::vector<Order> expected;
+        std::vector<Order> actual;
+        original.getBook(symbol)->forEachOrder([&](const Order& order) { expected.push_back(order); });
+        recovered.getBook(symbol)->forEachOrder([&](const Order& order) { actual.push_back(order); });
+        ASSERT_TRUE(!expected.empty());
+        ASSERT_EQUAL(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUAL(expected[i].getId(), actual[i].getId());
+            ASSERT_TRUE(expected[i].getFixedPrice() == actual[i].getFixedPrice());
+            ASSERT_EQUAL(expected[i].getQuantity(), actual[i].getQuantity());
+        }
+    }
+
+    return true;
+}
+
+bool test_snapshot_waits_for_durable_journal_and_recovery_checks_sequences() {
+    const std::string journalPath = "test_sequences.journal";
+    const std::string snapshotPath = "test_sequences.snapshot";
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+
+    {
+        // Appended but not yet committed: the writer is not running
+        Journal journal(journalPath);
+        for (uint64_t id = 1; id <= 5; ++id) {
+            journal.append(OrderMessage::newOrder(Order(id, OrderSide::Buy, 100.00, 1)));
+        }
+        Snapshotter snapshotter(snapshotPath, &journal);
+        snapshotter.start();
+        SnapshotData snapshot;
+        snapshot.journalSequence = journal.getSequence();
+        snapshotter.submit(std::move(snapshot));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ASSERT_EQUAL(0u, snapshotter.getWrittenCount());
+
+        // Once the journal commits, the snapshot follows
+        journal.start();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (snapshotter.getWrittenCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQUAL(1u, snapshotter.getWrittenCount());
+        ASSERT_EQUAL(5u, journal.getDurableSequence());
+        journal.stop();
+        snapshotter.stop();
+    }
+
+    // A record that skips sequences makes the journal unreadable
+    JournalRecord stray{};
+    stray.sequence = 9;
+    std::FILE* file = std::fopen(journalPath.c_str(), "ab");
+    std::fwrite(&stray, sizeof(stray), 1, file);
+    std::fclose(file);
+    {
+        Journal journal(journalPath);
+        ASSERT_EQUAL(9u, journal.getSequence());
+    }
+    std::vector<JournalRecord> records;
+    ASSERT_FALSE(readJournal(journalPath, 0, records));
+
+    // A snapshot ahead of the journal is refused rather than replayed around
+    std::remove(journalPath.c_str());
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM", TickConfig(), 1024);
+    NullTradeSink noTrades;
+    EngineShard shard(directory, {symbol}, QueueKind::Mutex, noTrades);
+    RecoveryResult result = shard.recover(snapshotPath, journalPath);
+    std::remove(snapshotPath.c_str());
+    ASSERT_FALSE(result.ok);
+
+    // So is a snapshot order whose quantity would not fit in an Order
+    SnapshotData oversized;
+    oversized.orders.push_back(SnapshotOrderRecord{1, Price::fromDouble(100.00).raw(),
+                                                   Order::kMaxQuantity + 1, symbol, 0, {}});
+    ASSERT_TRUE(writeSnapshot(snapshotPath, oversized));
+    result = shard.recover(snapshotPath, journalPath);
+    std::remove(snapshotPath.c_str());
+    ASSERT_FALSE(result.ok);
+    ASSERT_EQUAL(0u, shard.getBook(symbol)->getOrderCount());
+
+    return true;
+}
+
+#if defined(__linux__)
+// Caps the size of files this process may write, standing in for a full
+// disk, until it goes out of scope
+struct FileSizeLimit {
+    rlimit saved;
+
+    explicit FileSizeLimit(rlim_t bytes) {
+        std::signal(SIGXFSZ, SIG_IGN);
+        ::getrlimit(RLIMIT_FSIZE, &saved);
+        rlimit capped = saved;
+        capped.rlim_cur = bytes;
+        ::setrlimit(RLIMIT_FSIZE, &capped);
+    }
+    ~FileSizeLimit() { restore(); }
+
+    void restore() { ::setrlimit(RLIMIT_FSIZE, &saved); }
+};
+
+bool test_journal_write_failure_is_never_reported_durable() {
+    const std::string journalPath = "test_failing.journal";
+    const std::string snapshotPath = "test_failing.snapshot";
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+
+    {
+        // The header of a new journal does not fit
+        FileSizeLimit limit(8);
+        Journal journal(journalPath);
+        ASSERT_FALSE(journal.isOpen());
+    }
+    std::remove(journalPath.c_str());
+
+    // Room for the header and two records, but not for the group
+    FileSizeLimit limit(16 + 2 * sizeof(JournalRecord));
+    Journal journal(journalPath);
+    ASSERT_TRUE(journal.isOpen());
+    for (uint64_t id = 1; id <= 10; ++id) {
+        journal.append(OrderMessage::newOrder(Order(id, OrderSide::Buy, 100.00, 1)));
+    }
+    Snapshotter snapshotter(snapshotPath, &journal);
+    snapshotter.start();
+    SnapshotData snapshot;
+    snapshot.journalSequence = journal.getSequence();
+    snapshotter.submit(std::move(snapshot));
+
+    journal.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!journal.hasFailed() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    limit.restore();
+    ASSERT_TRUE(journal.hasFailed());
+
+    // Nothing is claimed durable, so no snapshot is written past it
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    journal.stop();
+    snapshotter.stop();
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+    ASSERT_EQUAL(0u, journal.getDurableSequence());
+    ASSERT_EQUAL(0u, snapshotter.getWrittenCount());
+
+    return true;
+}
+
+bool test_trade_tape_write_failure_is_counted() {
+    const std::string path = "test_failing_tape.bin";
+    std::remove(path.c_str());
+
+    uint64_t lost = 0;
+    {
+        // Room for the header and ten records
+        FileSizeLimit limit(sizeof(TapeHeader) + 10 * sizeof(TradeRecord));
+        TradeTape tape(path, TapeFormat::Binary, 64);
+        ASSERT_TRUE(tape.isOpen());
+        tape.start();
+
+        OrderBook book;
+        MatchingEngine engine(book);
+        for (uint64_t id = 1; id <= 500; ++id) {
+            book.addOrder(Order(id, OrderSide::Sell, 100.00, 10));
+        }
+        engine.processOrder(Order(1000, OrderSide::Buy, 100.00, 5000), tape);
+        tape.stop();
+        limit.restore();
+
+        ASSERT_EQUAL(500u, tape.getRecordCount());
+        ASSERT_TRUE(tape.hasFailed());
+        lost = tape.getLostCount();
+    }
+
+    // Every trade is either on the tape or counted as lost
+    std::vector<TradeRecord> records;
+    ASSERT_TRUE(readTradeTape(path, records));
+    std::remove(path.c_str());
+    ASSERT_TRUE(records.size() <= 10);
+    ASSERT_TRUE(records.size() + lost >= 500);
+
+    return true;
+}
+#endif
+
+bool test_ioc_and_market_orders_never_rest() {
+    OrderBook book;
+    MatchingEngine engine(book);
+    book.addOrder(Order(1, OrderSide::Sell, 100.00, 30));
+    book.addOrder(Order(2, OrderSide::Sell, 100.05, 30));
+
+    // IOC takes the first level and drops the rest instead of resting at 100.00
+    Order ioc(3, OrderSide::Buy, Price::fromDouble(100.00), 50, 0, OrderType::Limit,
+              TimeInForce::ImmediateOrCancel);
+    auto trades = engine.processOrder(ioc);
+    ASSERT_EQUAL(1u, trades.size());
+    ASSERT_EQUAL(30u, trades[0].quantity);
+    ASSERT_FALSE(book.getOrder(3).has_value());
+    ASSERT_FALSE(book.getBestBid().has_value());
+
+    // A market order sweeps any price and never rests either
+    trades = engine.processOrder(Order::market(4, OrderSide::Buy, 100));
+    ASSERT_EQUAL(1u, trades.size());
+    ASSERT_DOUBLE_EQUAL(100.05, trades[0].price, 0.0001);
+    ASSERT_EQUAL(0u, book.getOrderCount());
+
+    // Text form: MARKET price, time-in-force column after the symbol
+    SymbolDirectory directory;
+    directory.add("SIM");
+    OrderTextParser parser(directory);
+    OrderMessage message = OrderMessage::cancel(0);
+    ASSERT_TRUE(parser.parse("SELL MARKET 300", message) == ParseStatus::Message);
+    ASSERT_TRUE(message.order.getType() == OrderType::Market);
+    ASSERT_TRUE(parser.parse("BUY 100.00 10 SIM FOK", message) == ParseStatus::Message);
+    ASSERT_TRUE(message.order.getTimeInForce() == TimeInForce::FillOrKill);
+    ASSERT_TRUE(parser.parse("BUY MARKET 10 GTC", message) == ParseStatus::Error);
+
+    return true;
+}
+
+bool test_fill_or_kill_is_all_or_nothing() {
+    OrderBook book;
+    MatchingEngine engine(book);
+    book.addOrder(Order(1, OrderSide::Buy, 100.00, 20));
+    book.addOrder(Order(2, OrderSide::Buy, 99.99, 20));
+    book.addOrder(Order(3, OrderSide::Buy, 99.98, 20));
+
+    // Only 40 is available at 99.99 or better: rejected, book untouched
+    Order tooBig(4, OrderSide::Sell, Price::fromDouble(99.99), 41, 0, OrderType::Limit,
+                 TimeInForce::FillOrKill);
+    ASSERT_TRUE(engine.processOrder(tooBig).empty());
+    ASSERT_EQUAL(3u, book.getOrderCount());
+    ASSERT_EQUAL(20u, book.getOrder(1)->getQuantity());
+    ASSERT_FALSE(book.getBestAsk().has_value());
+
+    // Exactly the available quantity fills across both levels
+    Order exact(5, OrderSide::Sell, Price::fromDouble(99.99), 40, 0, OrderType::Limit,
+                TimeInForce::FillOrKill);
+    ASSERT_EQUAL(2u, engine.processOrder(exact).size());
+    ASSERT_EQUAL(1u, book.getOrderCount());
+
+    // Fill-or-kill market orders only check total depth
+    ASSERT_TRUE(engine.processOrder(Order::market(6, OrderSide::Sell, 21, 0,
+                                                  TimeInForce::FillOrKill)).empty());
+    ASSERT_EQUAL(1u, engine.processOrder(Order::market(7, OrderSide::Sell, 20, 0,
+                                                       TimeInForce::FillOrKill)).size());
+    ASSERT_EQUAL(0u, book.getOrderCount());
+
+    return true;
+}
+
+bool test_text_parser_fixed_point_columns_without_allocating() {
+    SymbolDirectory directory;
+    directory.add("AAA");
+    directory.add("BBB");
+    OrderTextParser parser(directory);
+    OrderMessage message = OrderMessage::cancel(0);
+
+    // CSV columns with an explicit id; the fifth decimal rounds half up
+    ASSERT_TRUE(parser.parse("BUY,100.12345,10,42,BBB,IOC", message) == ParseStatus::Message);
+    ASSERT_EQUAL(1001235, message.order.getFixedPrice().raw());
+    ASSERT_EQUAL(42u, message.order.getId());
+    ASSERT_EQUAL(1u, message.order.getSymbol());
+    ASSERT_TRUE(message.order.getTimeInForce() == TimeInForce::ImmediateOrCancel);
+    ASSERT_EQUAL(43u, parser.getNextOrderId());
+
+    ASSERT_TRUE(parser.parse("sell\t99.99996  5\r", message) == ParseStatus::Message);
+    ASSERT_EQUAL(1000000, message.order.getFixedPrice().raw());
+    ASSERT_EQUAL(43u, message.order.getId());
+    ASSERT_TRUE(parser.parse("cancel 42", message) == ParseStatus::Message);
+    ASSERT_EQUAL(1u, message.order.getSymbol());
+    ASSERT_TRUE(parser.parse("BUY 1.2.3 5", message) == ParseStatus::Error);
+    ASSERT_TRUE(parser.parse("BUY 100 -5", message) == ParseStatus::Error);
+
+    // Prices whose scaled value would overflow int64 are errors, not UB
+    ASSERT_TRUE(parser.parse("BUY 922337203685479 5", message) == ParseStatus::Error);
+    ASSERT_TRUE(parser.parse("BUY 922337203685477.5808 5", message) == ParseStatus::Error);
+    ASSERT_TRUE(parser.parse("BUY 922337203685477.5807 5", message) == ParseStatus::Message);
+    ASSERT_EQUAL(INT64_MAX, message.order.getFixedPrice().raw());
+
+    // Warm up the symbol table, then valid lines parse without heap traffic
+    ASSERT_TRUE(parser.parse("BUY 100.01 1 BBB", message) == ParseStatus::Message);
+    uint64_t before = allocationCount();
+    for (int i = 0; i < 100; ++i) {
+        parser.parse("12345 SELL 100.25 300 7 AAA FOK", message);
+        parser.parse("MODIFY 7 100.50 20", message);
+    }
+    ASSERT_EQUAL(before, allocationCount());
+
+    return true;
+}
+
+bool test_line_reader_handles_straddling_lines() {
+    const std::string path = "test_lines.txt";
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("BUY 100.00 1\r\nSELL 101.00 2\n\nthis line is longer than a block\nlast", file);
+    std::fclose(file);
+
+    // A tiny block forces partial lines, buffer moves and growth
+    LineReader reader(path, 8);
+    ASSERT_TRUE(reader.isOpen());
+    std::vector<std::string> lines;
+    std::string_view line;
+    while (reader.next(line)) {
+        lines.emplace_back(line);
+    }
+    std::remove(path.c_str());
+
+    ASSERT_EQUAL(5u, lines.size());
+    ASSERT_EQUAL(std::string("BUY 100.00 1"), lines[0]);
+    ASSERT_EQUAL(std::string("SELL 101.00 2"), lines[1]);
+    ASSERT_TRUE(lines[2].empty());
+    ASSERT_EQUAL(std::string("this line is longer than a block"), lines[3]);
+    ASSERT_EQUAL(std::string("last"), lines[4]);
+
+    ASSERT_FALSE(LineReader(std::string("no_such_file.txt")).isOpen());
+
+    return true;
+}
+
+bool test_stream_producer_pushes_text_in_batches() {
+    const std::string path = "test_stream.txt";
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    for (int i = 1; i <= 1000; ++i) {
+        std::fprintf(file, "%s,%d.%02d,%d\n", i % 2 ? "BUY" : "SELL", 90 + i % 10, i % 100, i);
+        if (i == 500) {
+            std::fputs("HOLD 1 2\n", file);   // Reported and skipped
+        }
+    }
+    std::fclose(file);
+
+    SymbolDirectory directory;
+    directory.add("SIM");
+    SpscRingBuffer<OrderMessage> queue(4096);
+    ReplayConfig input;
+    input.path = path;
+    OrderProducer producer(queue, ProducerMode::Stream, directory, input);
+    producer.run();
+    std::remove(path.c_str());
+
+    ASSERT_EQUAL(1000u, producer.getReplayedCount());
+    ASSERT_EQUAL(1u, producer.getSkippedCount());
+    ASSERT_EQUAL(1000u, queue.size());
+    OrderMessage first = queue.pop();
+    ASSERT_EQUAL(1u, first.order.getId());
+    ASSERT_EQUAL(910100, first.order.getFixedPrice().raw());
+    ASSERT_EQUAL(1u, first.order.getQuantity());
+
+    return true;
+}
+
+bool test_order_is_compact_and_sequenced_by_the_book() {
+    ASSERT_EQUAL(32u, sizeof(Order));
+    ASSERT_TRUE(sizeof(OrderMessage) <= 48u);
+
+    OrderBook book;
+    ASSERT_TRUE(book.addOrder(Order(1, OrderSide::Buy, 100.00, 10)));
+    ASSERT_TRUE(book.addOrder(Order(2, OrderSide::Buy, 100.00, 10)));
+    auto first = *book.getOrder(1);
+    auto second = *book.getOrder(2);
+    ASSERT_TRUE(first < second);
+
+    // Reducing keeps the sequence, a size increase takes a new one
+    ASSERT_TRUE(book.modifyOrder(1, 5, Price::fromDouble(100.00)));
+    ASSERT_EQUAL(first.getSequence(), book.getOrder(1)->getSequence());
+    ASSERT_TRUE(book.modifyOrder(1, 20, Price::fromDouble(100.00)));
+    ASSERT_TRUE(second < *book.getOrder(1));
+
+    // Priority comparison survives the sequence wrapping
+    Order older(3, OrderSide::Sell, 101.00, 1);
+    Order newer(4, OrderSide::Sell, 101.00, 1);
+    older.setSequence(UINT32_MAX);
+    newer.setSequence(0);
+    ASSERT_TRUE(older < newer);
+    ASSERT_FALSE(newer < older);
+
+    return true;
+}
+
+bool test_ingest_stamps_messages_and_bounds_quantity() {
+    SymbolDirectory directory;
+    directory.add("SIM");
+    OrderTextParser parser(directory);
+    OrderMessage message = OrderMessage::cancel(0);
+
+    ASSERT_TRUE(parser.parse("BUY 100 4294967295", message) == ParseStatus::Message);
+    ASSERT_EQUAL(Order::kMaxQuantity, message.order.getQuantity());
+    ASSERT_EQUAL(0, message.ingestNs);
+    ASSERT_TRUE(parser.parse("BUY 100 4294967296", message) == ParseStatus::Error);
+    ASSERT_TRUE(parser.parse("MODIFY 1 100 4294967296", message) == ParseStatus::Error);
+
+    // The producer stamps each batch as it enters the process
+    const std::string path = "test_ingest_stamp.txt";
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("BUY 100 1\nSELL 101 2\n", file);
+    std::fclose(file);
+    SpscRingBuffer<OrderMessage> queue(16);
+    ReplayConfig input;
+    input.path = path;
+    const int64_t before = steadyNowNs();
+    OrderProducer producer(queue, ProducerMode::Stream, directory, input);
+    producer.run();
+    std::remove(path.c_str());
+
+    ASSERT_EQUAL(2u, queue.size());
+    OrderMessage stamped = queue.pop();
+    ASSERT_TRUE(stamped.ingestNs >= before);
+    ASSERT_TRUE(stamped.ingestNs <= steadyNowNs());
+
+    return true;
+}
+
+// Sink that is not a TradeSink at all; the engine calls it directly
+struct FillListSink {
+    std::vector<Trade> fills;
+
+    void onTrade(const Trade& trade) { fills.push_back(trade); }
+};
+
+bool test_engine_reports_fills_to_templated_sinks() {
+    OrderBook book;
+    MatchingEngine engine(book);
+    NullTradeSink none;
+    engine.processOrder(Order(1, OrderSide::Sell, 100.00, 5), none);
+    engine.processOrder(Order(2, OrderSide::Sell, 100.01, 5), none);
+
+    FillListSink fills;
+    engine.processOrder(Order(3, OrderSide::Buy, 100.01, 7), fills);
+    ASSERT_EQUAL(2u, fills.fills.size());
+    ASSERT_EQUAL(1u, fills.fills[0].sellOrderId);
+    ASSERT_EQUAL(2u, fills.fills[1].quantity);
+
+    // Execution-report callback through a type-erased reference
+    uint64_t reportedQuantity = 0;
+    auto callback = makeTradeCallback([&](const Trade& trade) { reportedQuantity += trade.quantity; });
+    TradeSink& erased = callback;
+    engine.processMessage(OrderMessage::newOrder(Order(4, OrderSide::Buy, 100.01, 10)), erased);
+    ASSERT_EQUAL(3u, reportedQuantity);
+
+    // The engine still tracks the last trade and the trade count
+    ASSERT_EQUAL(3u, engine.getLastTrade()->quantity);
+    ASSERT_EQUAL(3u, engine.getSnapshot().tradeCount);
+
+    return true;
+}
+
+bool test_counting_sink_matching_does_not_allocate() {
+    OrderBook book(TickConfig(), 1024);
+    MatchingEngine engine(book);
+    CountingTradeSink sink;
+
+    std::vector<OrderMessage> cycle;
+    for (uint64_t id = 1; id <= 100; ++id) {
+        cycle.push_back(OrderMessage::newOrder(Order(id, OrderSide::Sell, 100.00, 2)));
+    }
+    cycle.push_back(OrderMessage::newOrder(Order(1000, OrderSide::Buy, 100.00, 200)));
+    engine.processBatch(cycle.data(), cycle.size(), sink);
+
+    uint64_t before = allocationCount();
+    for (int round = 0; round < 10; ++round) {
+        for (const auto& message : cycle) {
+            engine.processMessage(message, sink);
+        }
+    }
+    ASSERT_EQUAL(before, allocationCount());
+    ASSERT_EQUAL(1100u, sink.getCount());
+    ASSERT_EQUAL(2200u, sink.getQuantity());
+
+    return true;
+}
+
+bool test_side_templated_ladders_mirror_each_other() {
+    static_assert(SideTraits<OrderSide::Buy>::kOpposite == OrderSide::Sell, "bid opposite");
+    static_assert(SideTraits<OrderSide::Sell>::kOpposite == OrderSide::Buy, "ask opposite");
+    static_assert(AskLadder::reaches(Price::fromRaw(100), Price::fromRaw(100)), "ask at limit");
+    static_assert(!AskLadder::reaches(Price::fromRaw(101), Price::fromRaw(100)), "ask above limit");
+    static_assert(BidLadder::reaches(Price::fromRaw(101), Price::fromRaw(100)), "bid above limit");
+
+    TickConfig config;
+    std::vector<OrderNode> nodes;
+    nodes.reserve(6);
+    BidLadder bids(config);
+    AskLadder asks(config);
+    const double prices[] = {100.00, 100.05, 99.95};
+    for (uint64_t i = 0; i < 3; ++i) {
+        nodes.emplace_back(Order(i + 1, OrderSide::Buy, prices[i], 10));
+        bids.add(&nodes.back());
+        nodes.emplace_back(Order(i + 11, OrderSide::Sell, prices[i], 10));
+        asks.add(&nodes.back());
+    }
+
+    ASSERT_EQUAL(Price::fromDouble(100.05).raw(), bids.best()->price.raw());
+    ASSERT_EQUAL(Price::fromDouble(99.95).raw(), asks.best()->price.raw());
+    auto bidLevels = bids.top(3);
+    auto askLevels = asks.top(3);
+    ASSERT_EQUAL(3u, bidLevels.size());
+    ASSERT_EQUAL(bidLevels[0].price.raw(), askLevels[2].price.raw());
+    ASSERT_EQUAL(bidLevels[2].price.raw(), askLevels[0].price.raw());
+    ASSERT_EQUAL(20u, asks.availableQuantity(Price::fromDouble(100.00), 100));
+    ASSERT_EQUAL(20u, bids.availableQuantity(Price::fromDouble(100.00), 100));
+
+    bids.remove(&nodes[2]);   // The 100.05 bid
+    ASSERT_EQUAL(Price::fromDouble(100.00).raw(), bids.best()->price.raw());
+
+    return true;
+}
+
+bool test_buy_and_sell_matching_are_symmetric() {
+    // The same scenario with sides swapped and prices mirrored around 100
+    auto run = [](OrderSide aggressor, double sign) {
+        OrderSide resting = aggressor == OrderSide::Buy ? OrderSide::Sell : OrderSide::Buy;
+        OrderBook book;
+        MatchingEngine engine(book);
+        std::vector<Trade> trades;
+        TradeCollector collector(trades);
+        engine.processOrder(Order(1, resting, 100.00 + sign * 0.01, 5), collector);
+        engine.processOrder(Order(2, resting, 100.00 + sign * 0.02, 5), collector);
+        engine.processOrder(Order(3, resting, 100.00 + sign * 0.03, 5), collector);
+        bool crosses = book.crossesSpread(aggressor, Price::fromDouble(100.00 + sign * 0.01));
+        engine.processOrder(Order(4, aggressor, 100.00 + sign * 0.02, 12), collector);
+        return std::make_tuple(trades, crosses, book.getOrderCount(), book.getOrder(4));
+    };
+
+    auto [buyTrades, buyCrosses, buyCount, buyRest] = run(OrderSide::Buy, 1.0);
+    auto [sellTrades, sellCrosses, sellCount, sellRest] = run(OrderSide::Sell, -1.0);
+
+    ASSERT_TRUE(buyCrosses);
+    ASSERT_TRUE(sellCrosses);
+    ASSERT_EQUAL(2u, buyTrades.size());
+    ASSERT_EQUAL(buyTrades.size(), sellTrades.size());
+    for (size_t i = 0; i < buyTrades.size(); ++i) {
+        ASSERT_EQUAL(buyTrades[i].buyOrderId, sellTrades[i].sellOrderId);
+        ASSERT_EQUAL(buyTrades[i].sellOrderId, sellTrades[i].buyOrderId);
+        ASSERT_EQUAL(buyTrades[i].quantity, sellTrades[i].quantity);
+        ASSERT_TRUE(std::fabs((buyTrades[i].price - 100.0) + (sellTrades[i].price - 100.0)) < 1e-9);
+    }
+    ASSERT_EQUAL(2u, buyCount);
+    ASSERT_EQUAL(buyCount, sellCount);
+    ASSERT_EQUAL(2u, buyRest->getQuantity());
+    ASSERT_EQUAL(2u, sellRest->getQuantity());
+
+    return true;
+}
+
+bool test_level_bitmap_matches_ordered_set() {
+    // 300k levels: four layers, so searches cross every layer boundary
+    const size_t size = 300000;
+    LevelBitmap bitmap(size);
+    std::set<size_t> reference;
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<size_t> pick(0, size - 1);
+
+    ASSERT_EQUAL(LevelBitmap::npos, bitmap.findNext(0));
+    ASSERT_EQUAL(LevelBitmap::npos, bitmap.findPrev(size - 1));
+
+    for (int step = 0; step < 20000; ++step) {
+        size_t index = pick(rng);
+        if (step % 3 == 2 && !reference.empty()) {
+            // Remove an occupied index so the bitmap also gets sparse again
+            auto victim = reference.lower_bound(index);
+            if (victim == reference.end()) victim = reference.begin();
+            bitmap.clear(*victim);
+            reference.erase(victim);
+        } else {
+            bitmap.set(index);
+            reference.insert(index);
+        }
+
+        size_t from = pick(rng);
+        auto next = reference.lower_bound(from);
+        ASSERT_EQUAL(next == reference.end() ? LevelBitmap::npos : *next, bitmap.findNext(from));
+        auto after = reference.upper_bound(from);
+        size_t expectedPrev = after == reference.begin() ? LevelBitmap::npos : *std::prev(after);
+        ASSERT_EQUAL(expectedPrev, bitmap.findPrev(from));
+    }
+
+    // Extremes of the band
+    bitmap.set(0);
+    bitmap.set(size - 1);
+    ASSERT_EQUAL(0u, bitmap.findPrev(0));
+    ASSERT_EQUAL(size - 1, bitmap.findNext(size - 1));
+    ASSERT_TRUE(bitmap.test(size - 1));
+
+    return true;
+}
+
+bool test_sparse_wide_band_sweep_skips_gaps() {
+    // 300k ticks of 0.0001 with a handful of asks thousands of ticks apart
+    TickConfig wide;
+    wide.tickSize = Price::fromRaw(1);
+    wide.minPrice = Price::fromRaw(1);
+    wide.maxPrice = Price::fromRaw(300000);
+    OrderBook book(wide, 1024);
+    MatchingEngine engine(book);
+
+    const int64_t prices[] = {100000, 103000, 250000, 299999};
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(book.addOrder(Order(i + 1, OrderSide::Sell, Price::fromRaw(prices[i]), 10)));
+    }
+    ASSERT_TRUE(book.addOrder(Order(10, OrderSide::Buy, Price::fromRaw(1), 10)));
+
+    auto levels = book.getTopAsks(10);
+    ASSERT_EQUAL(4u, levels.size());
+    ASSERT_EQUAL(prices[3], levels[3].price.raw());
+
+    std::vector<Trade> trades;
+    TradeCollector collector(trades);
+    engine.processOrder(Order::market(20, OrderSide::Buy, 35), collector);
+    ASSERT_EQUAL(4u, trades.size());
+    ASSERT_EQUAL(5u, trades[3].quantity);
+    ASSERT_EQUAL(prices[3], book.getBestAsk()->getFixedPrice().raw());
+
+    // Emptying the last ask leaves the side empty; bids are untouched
+    book.removeAskQuantity(5);
+    ASSERT_FALSE(book.getBestAsk().has_value());
+    ASSERT_EQUAL(1, book.getBestBid()->getFixedPrice().raw());
+
+    return true;
+}
+
+bool test_map_book_matches_with_price_time_priority() {
+    MapOrderBook book;
+    BasicMatchingEngine<MapOrderBook> engine(book);
+
+    ASSERT_TRUE(book.addOrder(Order(1, OrderSide::Sell, 100.00, 10)));
+    ASSERT_TRUE(book.addOrder(Order(2, OrderSide::Sell, 100.00, 10)));
+    ASSERT_TRUE(book.addOrder(Order(3, OrderSide::Sell, 100.01, 10)));
+    ASSERT_FALSE(book.addOrder(Order(1, OrderSide::Sell, 100.02, 10)));    // Duplicate id
+
+    // Growing order 1 sends it behind order 2
+    ASSERT_TRUE(book.modifyOrder(1, 15, Price::fromDouble(100.00)));
+
+    auto trades = engine.processOrder(Order(10, OrderSide::Buy, 100.01, 30));
+    ASSERT_EQUAL(3u, trades.size());
+    ASSERT_EQUAL(2u, trades[0].sellOrderId);
+    ASSERT_EQUAL(1u, trades[1].sellOrderId);
+    ASSERT_EQUAL(15u, trades[1].quantity);
+    ASSERT_EQUAL(3u, trades[2].sellOrderId);
+    ASSERT_EQUAL(5u, book.getOrder(3)->getQuantity());
+
+    // FOK against too little liquidity leaves the book untouched
+    trades = engine.processOrder(Order(11, OrderSide::Buy, Price::fromDouble(100.01), 6, 0,
+                                       OrderType::Limit, TimeInForce::FillOrKill));
+    ASSERT_TRUE(trades.empty());
+    ASSERT_EQUAL(1u, book.getOrderCount());
+
+    BookSnapshot snapshot = engine.getSnapshot();
+    ASSERT_EQUAL(1u, snapshot.askLevels);
+    ASSERT_EQUAL(5u, snapshot.asks[0].totalQuantity);
+    ASSERT_EQUAL(0u, snapshot.bidLevels);
+
+    return true;
+}
+
+bool test_differential_order_book_agrees_with_map_book() {
+    for (uint64_t seed : {1u, 2u, 3u}) {
+        std::vector<OrderMessage> events = generateDifferentialStream(5000, seed);
+        OrderBook book(TickConfig(), 8192);
+        MapOrderBook reference;
+        DifferentialResult result = compareBooks(events, book, reference);
+        if (!result.matched) {
+            std::cerr << "  event " << result.mismatchEvent << ": " << result.mismatch << std::endl;
+        }
+        ASSERT_TRUE(result.matched);
+        ASSERT_EQUAL(events.size(), result.eventsCompared);
+        ASSERT_TRUE(result.tradesCompared > 0);
+    }
+    return true;
+}
+
+bool test_pre_trade_risk_limits_and_releases_exposure() {
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM");
+    RiskLimits limits;
+    limits.accountCount = 4;
+    limits.maxOrderQuantity = 100;
+    limits.priceCollar = 0.05;
+    limits.maxOpenQuantity = 150;
+    limits.maxOpenNotional = 1e6;
+    PreTradeRisk risk(directory, limits);
+
+    auto buy = [symbol](uint64_t id, double price, uint64_t quantity, AccountId account) {
+        return OrderMessage::newOrder(Order(id, OrderSide::Buy, price, quantity, symbol), account);
+    };
+
+    ASSERT_TRUE(risk.check(buy(1, 100.00, 10, 4)) == RiskReject::UnknownAccount);
+    ASSERT_TRUE(risk.check(buy(1, 100.00, 101, 0)) == RiskReject::OrderTooLarge);
+
+    // Orders the book would drop are rejected before they count as exposure
+    ASSERT_TRUE(risk.check(buy(1, 100.005, 10, 0)) == RiskReject::InvalidPrice);
+    ASSERT_TRUE(risk.check(buy(1, 1000.01, 10, 0)) == RiskReject::InvalidPrice);
+    ASSERT_TRUE(risk.check(OrderMessage::newOrder(Order(1, OrderSide::Buy, 100.00, 10, symbol + 1), 0)) ==
+                RiskReject::UnknownSymbol);
+    ASSERT_EQUAL(0u, risk.getOpenOrderCount());
+    ASSERT_EQUAL(0u, risk.getExposure(0).openQuantity);
+
+    ASSERT_TRUE(risk.check(buy(1, 100.00, 100, 0)) == RiskReject::None);
+    ASSERT_TRUE(risk.check(buy(1, 100.00, 10, 0)) == RiskReject::DuplicateOrderId);
+    ASSERT_TRUE(risk.check(buy(2, 100.00, 60, 0)) == RiskReject::OpenQuantityLimit);
+    ASSERT_TRUE(risk.check(buy(2, 100.00, 60, 1)) == RiskReject::None);   // Other account
+    ASSERT_EQUAL(100u, risk.getExposure(0).openQuantity);
+    ASSERT_EQUAL(Price::fromDouble(100.00).raw() * 100, static_cast<int64_t>(risk.getExposure(0).openNotional));
+
+    // A fill releases both sides and sets the collar around 100.00
+    risk.applyFill(Trade(1, 99, 100.00, 70, symbol));
+    ASSERT_EQUAL(30u, risk.getExposure(0).openQuantity);
+    ASSERT_TRUE(risk.check(buy(3, 94.00, 10, 0)) == RiskReject::PriceOutsideCollar);
+    ASSERT_TRUE(risk.check(buy(3, 95.00, 100, 0)) == RiskReject::None);
+    ASSERT_EQUAL(130u, risk.getExposure(0).openQuantity);
+
+    // Growing an order is checked as a replacement; cancels release it
+    ASSERT_TRUE(risk.check(OrderMessage::modify(1, Price::fromDouble(100.00), 60, symbol)) ==
+                RiskReject::OpenQuantityLimit);
+    ASSERT_TRUE(risk.check(OrderMessage::modify(1, Price::fromDouble(100.005), 50, symbol)) ==
+                RiskReject::InvalidPrice);
+    ASSERT_TRUE(risk.check(OrderMessage::modify(1, Price::fromDouble(100.00), 50, symbol)) ==
+                RiskReject::None);
+    ASSERT_EQUAL(150u, risk.getExposure(0).openQuantity);
+    ASSERT_TRUE(risk.check(OrderMessage::cancel(3, symbol)) == RiskReject::None);
+    ASSERT_TRUE(risk.check(OrderMessage::modify(1, Price(), 0, symbol)) == RiskReject::None);
+    ASSERT_EQUAL(0u, risk.getExposure(0).openQuantity);
+    ASSERT_EQUAL(0u, risk.getExposure(0).openNotional);
+    ASSERT_EQUAL(1u, risk.getOpenOrderCount());
+
+    // Orders that cannot rest are checked but never held
+    ASSERT_TRUE(risk.check(OrderMessage::newOrder(Order::market(4, OrderSide::Sell, 100, symbol))) ==
+                RiskReject::None);
+    ASSERT_EQUAL(0u, risk.getExposure(0).openQuantity);
+
+    return true;
+}
+
+bool test_risk_stage_forwards_accepted_orders_and_learns_fills() {
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM", TickConfig(), 1024);
+    RiskLimits limits;
+    limits.maxOpenQuantity = 100;
+
+    TradeBus fills;
+    RiskStage risk(directory, limits, QueueKind::Spsc);
+    ASSERT_TRUE(risk.addFillSource(fills));
+    std::vector<Trade> trades;
+    TradeCollector collector(trades);
+    TeeTradeSink tee(collector, fills);
+    EngineShard shard(directory, {symbol}, QueueKind::Spsc, tee);
+    OrderRouter router(directory, {&shard.getQueue()});
+    shard.start();
+    risk.start(router);
+
+    auto waitFor = [](auto condition) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    // Account 0 fills its open quantity; the next order is over the limit
+    risk.getQueue().push(OrderMessage::newOrder(Order(1, OrderSide::Sell, 100.00, 100, symbol), 0));
+    risk.getQueue().push(OrderMessage::newOrder(Order(2, OrderSide::Sell, 100.01, 1, symbol), 0));
+    waitFor([&]() { return risk.getAcceptedCount() + risk.getRejectedCount() == 2; });
+    ASSERT_EQUAL(1u, risk.getRejectedCount(RiskReject::OpenQuantityLimit));
+
+    // Once the resting sell is filled its exposure is released
+    risk.getQueue().push(OrderMessage::newOrder(Order(3, OrderSide::Buy, 100.00, 100, symbol), 1));
+    waitFor([&]() { return shard.getBook(symbol)->getOrderCount() == 0; });
+    risk.getQueue().push(OrderMessage::newOrder(Order(4, OrderSide::Sell, 100.01, 1, symbol), 0));
+    waitFor([&]() { return shard.getBook(symbol)->getOrderCount() == 1; });
+
+    risk.stop();
+    shard.stop();
+
+    ASSERT_EQUAL(1u, trades.size());
+    ASSERT_EQUAL(3u, risk.getAcceptedCount());
+    ASSERT_EQUAL(1u, risk.getRejectedCount());
+    ASSERT_TRUE(shard.getBook(symbol)->getOrder(4).has_value());
+    ASSERT_EQUAL(1u, risk.getRisk().getExposure(0).openQuantity);
+
+    return true;
+}
+
+bool test_risk_stage_drains_fills_while_input_is_idle() {
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM", TickConfig(), 1024);
+
+    for (QueueKind kind : {QueueKind::Spsc, QueueKind::Mutex}) {
+        // Nothing arrives for popBatchFor() before its timeout
+        RiskStage risk(directory, RiskLimits(), kind);
+        std::vector<OrderMessage> batch;
+        ASSERT_EQUAL(0u, risk.getQueue().popBatchFor(batch, 8, std::chrono::microseconds(50)));
+        ASSERT_FALSE(risk.getQueue().isClosed());
+
+        // An engine publishes many rings' worth of fills while the risk
+        // thread is parked on an empty queue; it must not be held back
+        TradeBus fills(16);
+        ASSERT_TRUE(risk.addFillSource(fills));
+        ThreadSafeQueue<OrderMessage> downstream;
+        risk.setWaitStrategy(WaitStrategy::Block);
+        risk.start(downstream);
+
+        std::atomic<bool> published{false};
+        std::thread engine([&]() {
+            for (uint64_t i = 1; i <= 1000; ++i) {
+                fills.onTrade(Trade(i, i + 1000, 100.00, 1, symbol));
+            }
+            published.store(true);
+        });
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!published.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        bool finished = published.load();
+
+        // Detaching the reader releases the engine if it did stall
+        risk.stop();
+        engine.join();
+        ASSERT_TRUE(finished);
+        ASSERT_TRUE(risk.getQueue().isClosed());
+    }
+
+    return true;
+}
+
+bool test_risk_stage_drains_fills_while_downstream_is_full() {
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM", TickConfig(), 1024);
+    const uint64_t kOrders = 1000;
+
+    // A tiny shard queue and fill ring: every order the engine takes fills
+    // the ring, so risk must read fills while it waits to forward more
+    SpscRingBuffer<OrderMessage> downstream(4);
+    TradeBus fills(16);
+    RiskStage risk(directory, RiskLimits(), QueueKind::Spsc);
+    ASSERT_TRUE(risk.addFillSource(fills));
+    risk.start(downstream);
+
+    std::atomic<bool> giveUp{false};
+    std::atomic<uint64_t> matched{0};
+    std::thread engine([&]() {
+        while (matched.load() < kOrders) {
+            auto message = downstream.tryPop();
+            if (!message) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (uint64_t i = 0; i < 8; ++i) {
+                Trade trade(message->order.getId(), 1000000 + i, 100.00, 1, symbol);
+                while (!fills.ring().tryPublish(trade) && !giveUp.load()) {
+                    std::this_thread::yield();
+                }
+            }
+            matched.fetch_add(1);
+        }
+    });
+
+    for (uint64_t id = 1; id <= kOrders; ++id) {
+        risk.getQueue().push(OrderMessage::newOrder(
+            Order(id, OrderSide::Buy, Price::fromDouble(100.00), 1, symbol, OrderType::Limit,
+                  TimeInForce::ImmediateOrCancel),
+            0));
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (matched.load() < kOrders && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool finished = matched.load() == kOrders;
+
+    // Stop publishing if the two threads did stall, so both can finish
+    giveUp.store(true);
+    engine.join();
+    risk.stop();
+    ASSERT_TRUE(finished);
+    ASSERT_EQUAL(kOrders, risk.getAcceptedCount());
+
+    return true;
+}
+
+bool test_multicast_ring_delivers_every_event_to_each_gating_reader() {
+    // Small ring, so the writer is held back by the slower reader many times
+    MulticastRing<Trade> ring(64);
+    auto fast = ring.addReader();
+    auto slow = ring.addReader();
+    const uint64_t count = 20000;
+
+    std::atomic<bool> ordered{true};
+    auto consume = [&](MulticastRing<Trade>::ReaderId reader, bool sleepy, uint64_t& sum) {
+        uint64_t expected = 1;
+        while (expected <= count) {
+            ring.poll(reader, [&](const Trade& trade) {
+                if (trade.buyOrderId != expected) {
+                    ordered = false;
+                }
+                sum += trade.quantity;
+                expected++;
+            }, 16);
+            if (sleepy && (expected - 1) % 1024 == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    };
+
+    uint64_t fastSum = 0;
+    uint64_t slowSum = 0;
+    std::thread fastThread([&]() { consume(fast, false, fastSum); });
+    std::thread slowThread([&]() { consume(slow, true, slowSum); });
+    for (uint64_t id = 1; id <= count; ++id) {
+        ring.publish(Trade(id, 0, 100.0, id));
+    }
+    fastThread.join();
+    slowThread.join();
+
+    ASSERT_TRUE(ordered.load());
+    ASSERT_EQUAL(count * (count + 1) / 2, fastSum);
+    ASSERT_EQUAL(fastSum, slowSum);
+    ASSERT_EQUAL(count, ring.getPublished());
+    ASSERT_EQUAL(0u, ring.getLag(slow));
+
+    return true;
+}
+
+bool test_multicast_ring_laps_non_gating_reader_and_detach_releases_writer() {
+    MulticastRing<Trade> ring(8);
+    auto monitor = ring.addReader(false);
+    auto consumer = ring.addReader(true);
+
+    // The gating reader holds the writer to one ring of unread events
+    for (uint64_t id = 1; id <= 8; ++id) {
+        ASSERT_TRUE(ring.tryPublish(Trade(id, 0, 100.0, 1)));
+    }
+    ASSERT_FALSE(ring.tryPublish(Trade(9, 0, 100.0, 1)));
+
+    // Once it detaches, the writer runs freely and laps the monitor
+    ring.detach(consumer);
+    for (uint64_t id = 9; id <= 20; ++id) {
+        ASSERT_TRUE(ring.tryPublish(Trade(id, 0, 100.0, 1)));
+    }
+
+    std::vector<uint64_t> seen;
+    ring.poll(monitor, [&seen](const Trade& trade) { seen.push_back(trade.buyOrderId); });
+    ASSERT_EQUAL(8u, seen.size());
+    ASSERT_EQUAL(13u, seen.front());
+    ASSERT_EQUAL(20u, seen.back());
+    ASSERT_EQUAL(12u, ring.getDropped(monitor));
+    ASSERT_EQUAL(0u, ring.getLag(monitor));
+
+    return true;
+}
+
+bool test_queue_wait_strategies_deliver_in_order_and_close_ends_consumer() {
+    const uint64_t count = 20000;
+    for (QueueKind kind : {QueueKind::Mutex, QueueKind::Spsc}) {
+        for (WaitStrategy strategy : {WaitStrategy::Block, WaitStrategy::Yield,
+                                      WaitStrategy::SpinThenPark, WaitStrategy::BusySpin}) {
+            std::unique_ptr<ConcurrentQueue<uint64_t>> queue;
+            if (kind == QueueKind::Spsc) {
+                queue = std::make_unique<SpscRingBuffer<uint64_t>>(256);
+            } else {
+                queue = std::make_unique<ThreadSafeQueue<uint64_t>>();
+            }
+            queue->setWaitStrategy(strategy);
+            ASSERT_TRUE(queue->getWaitStrategy() == strategy);
+
+            // The consumer stops only when popBatch reports the queue closed
+            uint64_t received = 0;
+            bool ordered = true;
+            std::thread consumer([&]() {
+                std::vector<uint64_t> batch;
+                while (true) {
+                    batch.clear();
+                    if (queue->popBatch(batch, 64) == 0) {
+                        return;
+                    }
+                    for (uint64_t item : batch) {
+                        ordered = ordered && item == received + 1;
+                        received++;
+                    }
+                }
+            });
+
+            // Pauses let a parking consumer fall asleep and need waking
+            for (uint64_t item = 1; item <= count; ++item) {
+                queue->push(item);
+                if (item % 5000 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+            queue->close();
+            consumer.join();
+
+            ASSERT_EQUAL(count, received);
+            ASSERT_TRUE(ordered);
+        }
+    }
+
+    ASSERT_TRUE(parseWaitStrategy("spin-park") == WaitStrategy::SpinThenPark);
+    ASSERT_TRUE(parseWaitStrategy(toString(WaitStrategy::BusySpin)) == WaitStrategy::BusySpin);
+    ASSERT_FALSE(parseWaitStrategy("sleep").has_value());
+
+    return true;
+}
+
+bool test_engine_shard_stop_drains_queue_without_injecting_orders() {
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM", TickConfig(), 1024);
+
+    for (QueueKind kind : {QueueKind::Mutex, QueueKind::Spsc}) {
+        std::vector<Trade> trades;
+        TradeCollector collector(trades);
+        PipelineLatency latency;
+        EngineShard shard(directory, {symbol}, kind, collector);
+        shard.setLatency(&latency);
+        shard.setWaitStrategy(WaitStrategy::BusySpin);
+        shard.start();
+
+        const uint64_t count = 1000;
+        for (uint64_t id = 1; id <= count; ++id) {
+            OrderSide side = id % 2 == 0 ? OrderSide::Buy : OrderSide::Sell;
+            shard.getQueue().push(OrderMessage::newOrder(Order(id, side, 100.00, 10, symbol)));
+        }
+
+        // No wait before stopping: stop() itself must let the engine finish
+        shard.stop();
+
+        ASSERT_EQUAL(count, latency.matching.count());
+        ASSERT_EQUAL(count / 2, trades.size());
+        ASSERT_EQUAL(0u, shard.getBook(symbol)->getOrderCount());
+    }
+
+    return true;
+}
+
+#if defined(__linux__)
+// Read one gateway message into buffer, waiting up to two seconds. Returns
+// its type, or 0 on timeout or when the gateway closed the connection.
+static uint8_t readGatewayReply(int fd, char* buffer, size_t size) {
+    size_t have = 0;
+    size_t want = sizeof(WireHeader);
+    while (have < want) {
+        pollfd poller{fd, POLLIN, 0};
+        if (::poll(&poller, 1, 2000) <= 0) return 0;
+        ssize_t n = ::recv(fd, buffer + have, want - have, 0);
+        if (n <= 0) return 0;
+        have += static_cast<size_t>(n);
+        if (have == sizeof(WireHeader)) {
+            want = readWireMessage<WireHeader>(buffer).length;
+            if (want < sizeof(WireHeader) || want > size) return 0;
+        }
+    }
+    return readWireMessage<WireHeader>(buffer).type;
+}
+
+static WireNewOrder gatewayOrder(uint64_t clientOrderId, OrderSide side, double price,
+                                 uint64_t quantity, SymbolId symbol) {
+    auto order = makeWireMessage<WireNewOrder>(WireType::NewOrder);
+    order.clientOrderId = clientOrderId;
+    order.priceRaw = Price::fromDouble(price).raw();
+    order.quantity = quantity;
+    order.symbol = symbol;
+    order.side = static_cast<uint8_t>(side);
+    order.orderType = static_cast<uint8_t>(OrderType::Limit);
+    order.timeInForce = static_cast<uint8_t>(TimeInForce::GoodTillCancel);
+    return order;
+}
+
+bool test_gateway_acks_and_reports_fills_to_both_sides() {
+    const std::string path = "test_gateway_fills.sock";
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM");
+    TradeBus fills;
+    OrderGateway gateway(directory, path);
+    ASSERT_TRUE(gateway.open());
+    ASSERT_TRUE(gateway.addFillSource(fills));
+    EngineShard shard(directory, {symbol}, QueueKind::Spsc, fills);
+    OrderRouter router(directory, {&shard.getQueue()});
+    shard.start();
+    std::thread server([&]() { gateway.run(router); });
+
+    int seller = connectToGateway(path);
+    int buyer = connectToGateway(path);
+    ASSERT_TRUE(seller >= 0 && buyer >= 0);
+
+    char reply[64];
+    auto sell = gatewayOrder(11, OrderSide::Sell, 100.00, 10, symbol);
+    ASSERT_EQUAL(sizeof(sell), static_cast<size_t>(::send(seller, &sell, sizeof(sell), 0)));
+    ASSERT_EQUAL(static_cast<int>(WireType::Ack), readGatewayReply(seller, reply, sizeof(reply)));
+    auto sellAck = readWireMessage<WireAck>(reply);
+    ASSERT_EQUAL(11u, sellAck.clientOrderId);
+
+    auto buy = gatewayOrder(22, OrderSide::Buy, 100.00, 4, symbol);
+    ASSERT_EQUAL(sizeof(buy), static_cast<size_t>(::send(buyer, &buy, sizeof(buy), 0)));
+    ASSERT_EQUAL(static_cast<int>(WireType::Ack), readGatewayReply(buyer, reply, sizeof(reply)));
+    auto buyAck = readWireMessage<WireAck>(reply);
+    ASSERT_TRUE(buyAck.orderId != sellAck.orderId);
+
+    // Each side hears about its own order only
+    ASSERT_EQUAL(static_cast<int>(WireType::Fill), readGatewayReply(buyer, reply, sizeof(reply)));
+    auto buyFill = readWireMessage<WireFill>(reply);
+    ASSERT_EQUAL(buyAck.orderId, buyFill.orderId);
+    ASSERT_EQUAL(4u, buyFill.quantity);
+    ASSERT_EQUAL(1000000, buyFill.priceRaw);
+    ASSERT_EQUAL(static_cast<int>(WireType::Fill), readGatewayReply(seller, reply, sizeof(reply)));
+    auto sellFill = readWireMessage<WireFill>(reply);
+    ASSERT_EQUAL(sellAck.orderId, sellFill.orderId);
+    ASSERT_EQUAL(static_cast<uint8_t>(OrderSide::Sell), sellFill.side);
+
+    ::close(seller);
+    ::close(buyer);
+    gateway.stop();
+    server.join();
+    shard.stop();
+
+    ASSERT_EQUAL(2u, gateway.getAcceptedCount());
+    ASSERT_EQUAL(6u, shard.getBook(symbol)->getOrder(sellAck.orderId)->getQuantity());
+
+    return true;
+}
+
+bool test_gateway_rejects_invalid_requests() {
+    const std::string path = "test_gateway_rejects.sock";
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM");
+    OrderGateway gateway(directory, path);
+    ASSERT_TRUE(gateway.open());
+    NullTradeSink noTrades;
+    EngineShard shard(directory, {symbol}, QueueKind::Spsc, noTrades);
+    OrderRouter router(directory, {&shard.getQueue()});
+    shard.start();
+    std::thread server([&]() { gateway.run(router); });
+
+    int owner = connectToGateway(path);
+    int other = connectToGateway(path);
+    ASSERT_TRUE(owner >= 0 && other >= 0);
+    char reply[64];
+
+    auto unknownSymbol = gatewayOrder(1, OrderSide::Buy, 100.00, 5, symbol + 7);
+    ::send(owner, &unknownSymbol, sizeof(unknownSymbol), 0);
+    ASSERT_EQUAL(static_cast<int>(WireType::Reject), readGatewayReply(owner, reply, sizeof(reply)));
+    ASSERT_EQUAL(static_cast<int>(RejectReason::UnknownSymbol),
+                 readWireMessage<WireReject>(reply).reason);
+
+    auto offTick = gatewayOrder(2, OrderSide::Buy, 100.005, 5, symbol);
+    ::send(owner, &offTick, sizeof(offTick), 0);
+    ASSERT_EQUAL(static_cast<int>(WireType::Reject), readGatewayReply(owner, reply, sizeof(reply)));
+    ASSERT_EQUAL(static_cast<int>(RejectReason::InvalidPrice),
+                 readWireMessage<WireReject>(reply).reason);
+
+    // A client may not cancel an order it does not own
+    auto resting = gatewayOrder(3, OrderSide::Buy, 99.00, 5, symbol);
+    ::send(owner, &resting, sizeof(resting), 0);
+    ASSERT_EQUAL(static_cast<int>(WireType::Ack), readGatewayReply(owner, reply, sizeof(reply)));
+    uint64_t orderId = readWireMessage<WireAck>(reply).orderId;
+    auto cancel = makeWireMessage<WireCancel>(WireType::Cancel);
+    cancel.clientOrderId = 4;
+    cancel.orderId = orderId;
+    cancel.symbol = symbol;
+    ::send(other, &cancel, sizeof(cancel), 0);
+    ASSERT_EQUAL(static_cast<int>(WireType::Reject), readGatewayReply(other, reply, sizeof(reply)));
+    ASSERT_EQUAL(static_cast<int>(RejectReason::UnknownOrder),
+                 readWireMessage<WireReject>(reply).reason);
+
+    // A message with a bad length is rejected and the connection closed
+    WireHeader malformed{sizeof(WireHeader), static_cast<uint8_t>(WireType::Cancel), 0};
+    ::send(other, &malformed, sizeof(malformed), 0);
+    ASSERT_EQUAL(static_cast<int>(WireType::Reject), readGatewayReply(other, reply, sizeof(reply)));
+    ASSERT_EQUAL(static_cast<int>(RejectReason::Malformed),
+                 readWireMessage<WireReject>(reply).reason);
+    ASSERT_EQUAL(0, readGatewayReply(other, reply, sizeof(reply)));
+
+    ::close(owner);
+    ::close(other);
+    gateway.stop();
+    server.join();
+    shard.stop();
+
+    ASSERT_EQUAL(1u, gateway.getAcceptedCount());
+    ASSERT_EQUAL(4u, gateway.getRejectedCount());
+    ASSERT_EQUAL(1u, shard.getBook(symbol)->getOrderCount());
+
+    return true;
+}
+
+bool test_gateway_answers_after_risk_decision() {
+    const std::string path = "test_gateway_risk.sock";
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM");
+    RiskLimits limits;
+    limits.maxOrderQuantity = 10;
+    TradeBus fills;
+    MulticastRing<RiskDecision> decisions;
+    RiskStage risk(directory, limits, QueueKind::Spsc);
+    OrderGateway gateway(directory, path);
+    ASSERT_TRUE(gateway.open());
+    ASSERT_TRUE(gateway.addFillSource(fills));
+    ASSERT_TRUE(risk.addFillSource(fills));
+    risk.setDecisionBus(decisions);
+    ASSERT_TRUE(gateway.setRiskDecisions(decisions));
+    EngineShard shard(directory, {symbol}, QueueKind::Spsc, fills);
+    OrderRouter router(directory, {&shard.getQueue()});
+    shard.start();
+    risk.start(router);
+    std::thread server([&]() { gateway.run(risk.getQueue()); });
+
+    int client = connectToGateway(path);
+    ASSERT_TRUE(client >= 0);
+    char reply[64];
+
+    // Refused by risk: a Reject that says why, and nothing reaches the book
+    auto tooLarge = gatewayOrder(1, OrderSide::Sell, 100.00, 50, symbol);
+    ::send(client, &tooLarge, sizeof(tooLarge), 0);
+    ASSERT_EQUAL(static_cast<int>(WireType::Reject), readGatewayReply(client, reply, sizeof(reply)));
+    auto reject = readWireMessage<WireReject>(reply);
+    ASSERT_EQUAL(1u, reject.clientOrderId);
+    ASSERT_EQUAL(static_cast<int>(RejectReason::RiskLimit), reject.reason);
+    ASSERT_EQUAL(static_cast<int>(RiskReject::OrderTooLarge), reject.riskReason);
+
+    // Passed by risk: acked, and the ack comes before the order's fill
+    auto sell = gatewayOrder(2, OrderSide::Sell, 100.00, 5, symbol);
+    auto buy = gatewayOrder(3, OrderSide::Buy, 100.00, 5, symbol);
+    ::send(client, &sell, sizeof(sell), 0);
+    ::send(client, &buy, sizeof(buy), 0);
+    ASSERT_EQUAL(static_cast<int>(WireType::Ack), readGatewayReply(client, reply, sizeof(reply)));
+    ASSERT_EQUAL(2u, readWireMessage<WireAck>(reply).clientOrderId);
+    ASSERT_EQUAL(static_cast<int>(WireType::Ack), readGatewayReply(client, reply, sizeof(reply)));
+    auto buyAck = readWireMessage<WireAck>(reply);
+    ASSERT_EQUAL(3u, buyAck.clientOrderId);
+    ASSERT_EQUAL(static_cast<int>(WireType::Fill), readGatewayReply(client, reply, sizeof(reply)));
+    ASSERT_EQUAL(static_cast<int>(WireType::Fill), readGatewayReply(client, reply, sizeof(reply)));
+
+    ::close(client);
+    gateway.stop();
+    server.join();
+    risk.stop();
+    shard.stop();
+
+    ASSERT_EQUAL(3u, gateway.getAcceptedCount());
+    ASSERT_EQUAL(1u, gateway.getRejectedCount());
+    ASSERT_EQUAL(2u, risk.getAcceptedCount());
+    ASSERT_EQUAL(0u, shard.getBook(symbol)->getOrderCount());
+
+    return true;
+}
+
+// CPU time a thread has used so far
+static int64_t threadCpuNs(std::thread& thread) {
+    clockid_t clock;
+    timespec now{};
+    if (::pthread_getcpuclockid(thread.native_handle(), &clock) != 0 ||
+        ::clock_gettime(clock, &now) != 0) {
+        return 0;
+    }
+    return int64_t(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+bool test_gateway_stops_reading_while_risk_is_behind() {
+    const std::string path = "test_gateway_paused.sock";
+    SymbolDirectory directory;
+    SymbolId symbol = directory.add("SIM");
+    TradeBus fills;
+    MulticastRing<RiskDecision> decisions;
+    RiskStage risk(directory, RiskLimits(), QueueKind::Spsc);
+    OrderGateway gateway(directory, path);
+    ASSERT_TRUE(gateway.open());
+    ASSERT_TRUE(gateway.addFillSource(fills));
+    ASSERT_TRUE(risk.addFillSource(fills));
+    risk.setDecisionBus(decisions);
+    ASSERT_TRUE(gateway.setRiskDecisions(decisions));
+    EngineShard shard(directory, {symbol}, QueueKind::Spsc, fills);
+    OrderRouter router(directory, {&shard.getQueue()});
+    shard.start();
+    std::thread server([&]() { gateway.run(risk.getQueue()); });
+
+    int client = connectToGateway(path);
+    ASSERT_TRUE(client >= 0);
+
+    // More requests than may await a decision; risk is not running yet
+    const uint64_t count = 20000;
+    std::thread sender([&]() {
+        for (uint64_t id = 1; id <= count; ++id) {
+            auto order = gatewayOrder(id, OrderSide::Sell, 100.00, 1, symbol);
+            if (::send(client, &order, sizeof(order), MSG_NOSIGNAL) != sizeof(order)) {
+                return;
+            }
+        }
+    });
+
+    uint64_t forwarded = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uint64_t now = gateway.getAcceptedCount();
+        if (now > 0 && now == forwarded) {
+            break;
+        }
+        forwarded = now;
+    }
+    ASSERT_TRUE(forwarded > 0 && forwarded < count);
+
+    // The unread socket must not keep the gateway busy
+    int64_t cpuBefore = threadCpuNs(server);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    int64_t cpuUsed = threadCpuNs(server) - cpuBefore;
+    ASSERT_TRUE(cpuUsed < 100000000);
+    ASSERT_EQUAL(forwarded, gateway.getAcceptedCount());
+
+    // Once risk catches up the client is read again and every request answered
+    risk.start(router);
+    char reply[64];
+    uint64_t answered = 0;
+    while (answered < count) {
+        uint8_t type = readGatewayReply(client, reply, sizeof(reply));
+        if (type == static_cast<uint8_t>(WireType::Ack) ||
+            type == static_cast<uint8_t>(WireType::Reject)) {
+            answered++;
+        } else if (type == 0) {
+            break;
+        }
+    }
+    sender.join();
+    ::close(client);
+    gateway.stop();
+    server.join();
+    risk.stop();
+    shard.stop();
+
+    ASSERT_EQUAL(count, answered);
+    ASSERT_EQUAL(count, gateway.getAcceptedCount());
+
+    return true;
+}
+#endif
+
 int main() {
     std::cout << "═══════════════════════════════════════" << std::endl;
     std::cout << "   LIMIT ORDER BOOK - TEST SUITE" << std::endl;
@@ -252,6 +2601,72 @@ int main() {
     RUN_TEST(test_matching_engine_partial_match);
     RUN_TEST(test_matching_engine_no_match);
     RUN_TEST(test_matching_engine_multiple_levels);
+    RUN_TEST(test_price_fixed_point_levels);
+    RUN_TEST(test_orderbook_rejects_invalid_price);
+    RUN_TEST(test_orderbook_best_moves_after_level_empties);
+    RUN_TEST(test_orderbook_cancel_order);
+    RUN_TEST(test_orderbook_modify_priority);
+    RUN_TEST(test_orderbook_rejects_live_id_before_matching);
+    RUN_TEST(test_order_index_many_orders);
+    RUN_TEST(test_matching_engine_cancel_modify_messages);
+    RUN_TEST(test_orderbook_match_sweeps_and_rests);
+    RUN_TEST(test_partial_fill_keeps_time_priority);
+    RUN_TEST(test_spsc_ring_buffer_fifo_and_capacity);
+    RUN_TEST(test_spsc_ring_buffer_cross_thread);
+    RUN_TEST(test_queue_pop_batch);
+    RUN_TEST(test_matching_engine_process_batch);
+    RUN_TEST(test_trade_tape_round_trip);
+    RUN_TEST(test_object_pool_reuses_slots);
+    RUN_TEST(test_steady_state_matching_does_not_allocate);
+    RUN_TEST(test_symbol_directory_lookup);
+    RUN_TEST(test_order_router_dispatches_by_symbol);
+    RUN_TEST(test_engine_shard_matches_each_symbol_independently);
+    RUN_TEST(test_engine_publishes_snapshot_after_batch);
+    RUN_TEST(test_seqlock_readers_never_see_torn_values);
+    RUN_TEST(test_orderbook_emits_level_and_trade_events);
+    RUN_TEST(test_slow_subscriber_gets_conflated_levels);
+    RUN_TEST(test_market_data_publisher_fans_out);
+    RUN_TEST(test_latency_histogram_percentiles);
+    RUN_TEST(test_engine_worker_records_stage_latency);
+    RUN_TEST(test_order_text_parser_formats);
+    RUN_TEST(test_order_event_file_round_trip);
+    RUN_TEST(test_replay_producer_pushes_all_events);
+    RUN_TEST(test_journal_continues_after_reopen);
+    RUN_TEST(test_recovery_rebuilds_books_from_snapshot_and_journal);
+    RUN_TEST(test_snapshot_waits_for_durable_journal_and_recovery_checks_sequences);
+#if defined(__linux__)
+    RUN_TEST(test_journal_write_failure_is_never_reported_durable);
+    RUN_TEST(test_trade_tape_write_failure_is_counted);
+#endif
+    RUN_TEST(test_ioc_and_market_orders_never_rest);
+    RUN_TEST(test_fill_or_kill_is_all_or_nothing);
+    RUN_TEST(test_text_parser_fixed_point_columns_without_allocating);
+    RUN_TEST(test_line_reader_handles_straddling_lines);
+    RUN_TEST(test_stream_producer_pushes_text_in_batches);
+    RUN_TEST(test_order_is_compact_and_sequenced_by_the_book);
+    RUN_TEST(test_ingest_stamps_messages_and_bounds_quantity);
+    RUN_TEST(test_engine_reports_fills_to_templated_sinks);
+    RUN_TEST(test_counting_sink_matching_does_not_allocate);
+    RUN_TEST(test_side_templated_ladders_mirror_each_other);
+    RUN_TEST(test_buy_and_sell_matching_are_symmetric);
+    RUN_TEST(test_level_bitmap_matches_ordered_set);
+    RUN_TEST(test_sparse_wide_band_sweep_skips_gaps);
+    RUN_TEST(test_map_book_matches_with_price_time_priority);
+    RUN_TEST(test_differential_order_book_agrees_with_map_book);
+    RUN_TEST(test_pre_trade_risk_limits_and_releases_exposure);
+    RUN_TEST(test_risk_stage_forwards_accepted_orders_and_learns_fills);
+    RUN_TEST(test_risk_stage_drains_fills_while_input_is_idle);
+    RUN_TEST(test_risk_stage_drains_fills_while_downstream_is_full);
+    RUN_TEST(test_multicast_ring_delivers_every_event_to_each_gating_reader);
+    RUN_TEST(test_multicast_ring_laps_non_gating_reader_and_detach_releases_writer);
+    RUN_TEST(test_queue_wait_strategies_deliver_in_order_and_close_ends_consumer);
+    RUN_TEST(test_engine_shard_stop_drains_queue_without_injecting_orders);
+#if defined(__linux__)
+    RUN_TEST(test_gateway_acks_and_reports_fills_to_both_sides);
+    RUN_TEST(test_gateway_rejects_invalid_requests);
+    RUN_TEST(test_gateway_answers_after_risk_decision);
+    RUN_TEST(test_gateway_stops_reading_while_risk_is_behind);
+#endif
 
     std::cout << std::endl;
     std::cout << "═══════════════════════════════════════" << std::endl;
@@ -0,0 +1,231 @@
+#include "GatewayProtocol.h"
+#include "LatencyHistogram.h"
+#include "OrderGateway.h"
+#include "Price.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+// Load generator for the order gateway. Opens several connections, keeps a
+// window of unanswered new orders in flight on each, and measures order
+// throughput and request-to-ack round trip latency.
+
+namespace {
+
+struct ClientConnection {
+    int fd = -1;
+    uint64_t sent = 0;
+    uint64_t answered = 0;
+    std::vector<char> output;
+    size_t outputOffset = 0;
+    std::vector<char> input;
+    size_t inputSize = 0;
+    std::vector<std::chrono::steady_clock::time_point> sentAt;  // By client order id - 1
+};
+
+struct Totals {
+    uint64_t acks = 0;
+    uint64_t rejects = 0;
+    uint64_t fills = 0;
+};
+
+uint64_t parseCount(const std::string& arg, size_t prefix) {
+    try {
+        return std::stoull(arg.substr(prefix));
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+// Decode every complete reply in the connection's input buffer
+void readReplies(ClientConnection& connection, Totals& totals, LatencyHistogram& roundTrip) {
+    while (true) {
+        ssize_t bytes = ::read(connection.fd, connection.input.data() + connection.inputSize,
+                               connection.input.size() - connection.inputSize);
+        if (bytes <= 0) {
+            return;
+        }
+        connection.inputSize += static_cast<size_t>(bytes);
+
+        auto now = std::chrono::steady_clock::now();
+        size_t offset = 0;
+        while (connection.inputSize - offset >= sizeof(WireHeader)) {
+            WireHeader header = readWireMessage<WireHeader>(connection.input.data() + offset);
+            if (connection.inputSize - offset < header.length) {
+                break;
+            }
+            const char* data = connection.input.data() + offset;
+            switch (static_cast<WireType>(header.type)) {
+            case WireType::Ack: {
+                auto ack = readWireMessage<WireAck>(data);
+                roundTrip.record(connection.sentAt[ack.clientOrderId - 1], now);
+                connection.answered++;
+                totals.acks++;
+                break;
+            }
+            case WireType::Reject:
+                connection.answered++;
+                totals.rejects++;
+                break;
+            case WireType::Fill:
+                totals.fills++;
+                break;
+            default:
+                break;
+            }
+            offset += header.length;
+        }
+
+        connection.inputSize -= offset;
+        std::memmove(connection.input.data(), connection.input.data() + offset,
+                     connection.inputSize);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string socketPath;
+    uint64_t connectionCount = 4;
+    uint64_t ordersPerConnection = 100000;
+    uint64_t window = 64;
+    uint64_t symbolCount = 1;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.substr(0, 9) == "--socket=") {
+            socketPath = arg.substr(9);
+        } else if (arg.substr(0, 14) == "--connections=") {
+            connectionCount = parseCount(arg, 14);
+        } else if (arg.substr(0, 9) == "--orders=") {
+            ordersPerConnection = parseCount(arg, 9);
+        } else if (arg.substr(0, 9) == "--window=") {
+            window = parseCount(arg, 9);
+        } else if (arg.substr(0, 10) == "--symbols=") {
+            symbolCount = parseCount(arg, 10);
+        } else if (arg.substr(0, 7) == "--seed=") {
+            seed = parseCount(arg, 7);
+        } else {
+            socketPath.clear();
+            break;
+        }
+    }
+
+    if (socketPath.empty() || connectionCount == 0 || ordersPerConnection == 0 || window == 0 ||
+        symbolCount == 0) {
+        std::cout << "Usage: " << argv[0] << " --socket=<path> [--connections=<n>] [--orders=<n>]"
+                  << " [--window=<n>] [--symbols=<n>] [--seed=<n>]" << std::endl;
+        std::cout << "Sends --orders new orders on each connection with at most --window"
+                  << " unanswered, spread over symbol ids 0..symbols-1" << std::endl;
+        return 1;
+    }
+
+    std::vector<ClientConnection> connections(connectionCount);
+    for (auto& connection : connections) {
+        connection.fd = connectToGateway(socketPath);
+        if (connection.fd < 0) {
+            std::cerr << "Cannot connect to " << socketPath << std::endl;
+            return 1;
+        }
+        ::fcntl(connection.fd, F_SETFL, ::fcntl(connection.fd, F_GETFL) | O_NONBLOCK);
+        connection.input.resize(1 << 16);
+        connection.sentAt.resize(ordersPerConnection);
+    }
+
+    // Orders cluster around 100.00 so both sides cross and fill
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> tickDist(-10, 10);
+    std::uniform_int_distribution<uint64_t> quantityDist(1, 100);
+    std::uniform_int_distribution<uint64_t> symbolDist(0, symbolCount - 1);
+    std::uniform_int_distribution<int> flagDist(0, 9);
+
+    Totals totals;
+    LatencyHistogram roundTrip;
+    const uint64_t totalOrders = connectionCount * ordersPerConnection;
+    std::vector<pollfd> polls(connectionCount);
+    auto start = std::chrono::steady_clock::now();
+
+    while (totals.acks + totals.rejects < totalOrders) {
+        for (size_t i = 0; i < connections.size(); ++i) {
+            ClientConnection& connection = connections[i];
+
+            // Top the window up and write as much as the socket takes
+            auto now = std::chrono::steady_clock::now();
+            while (connection.sent < ordersPerConnection &&
+                   connection.sent - connection.answered < window) {
+                auto order = makeWireMessage<WireNewOrder>(WireType::NewOrder);
+                order.clientOrderId = ++connection.sent;
+                order.priceRaw = Price::fromDouble(100.00).raw() + tickDist(rng) * 100;
+                order.quantity = quantityDist(rng);
+                order.symbol = static_cast<uint32_t>(symbolDist(rng));
+                order.side = static_cast<uint8_t>(flagDist(rng) % 2);
+                order.timeInForce = flagDist(rng) == 0 ? 1 : 0;   // One in ten is IOC
+                connection.sentAt[order.clientOrderId - 1] = now;
+                const char* bytes = reinterpret_cast<const char*>(&order);
+                connection.output.insert(connection.output.end(), bytes, bytes + sizeof(order));
+            }
+            while (connection.outputOffset < connection.output.size()) {
+                ssize_t bytes = ::write(connection.fd, connection.output.data() + connection.outputOffset,
+                                        connection.output.size() - connection.outputOffset);
+                if (bytes <= 0) {
+                    break;
+                }
+                connection.outputOffset += static_cast<size_t>(bytes);
+            }
+            if (connection.outputOffset == connection.output.size()) {
+                connection.output.clear();
+                connection.outputOffset = 0;
+            }
+
+            polls[i].fd = connection.fd;
+            polls[i].events = POLLIN | (connection.output.empty() ? 0 : POLLOUT);
+            polls[i].revents = 0;
+        }
+
+        if (::poll(polls.data(), polls.size(), 1000) < 0) {
+            std::cerr << "poll failed" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < connections.size(); ++i) {
+            if (polls[i].revents & (POLLHUP | POLLERR)) {
+                std::cerr << "Gateway closed the connection" << std::endl;
+                return 1;
+            }
+            if (polls[i].revents & POLLIN) {
+                readReplies(connections[i], totals, roundTrip);
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Give fills of the last orders a moment to arrive
+    auto lingerUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (std::chrono::steady_clock::now() < lingerUntil) {
+        for (auto& connection : connections) {
+            readReplies(connection, totals, roundTrip);
+        }
+        ::usleep(1000);
+    }
+
+    std::cout << "Orders:      " << totalOrders << " on " << connectionCount << " connection(s)"
+              << std::endl;
+    std::cout << "Elapsed:     " << seconds << " s (" << static_cast<uint64_t>(totalOrders / seconds)
+              << " orders/s)" << std::endl;
+    std::cout << "Acks:        " << totals.acks << ", rejects: " << totals.rejects
+              << ", fills: " << totals.fills << std::endl;
+    roundTrip.dump(std::cout, "ack_round_trip");
+
+    for (auto& connection : connections) {
+        ::close(connection.fd);
+    }
+    return 0;
+}
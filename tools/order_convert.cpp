@@ -0,0 +1,94 @@
+#include "LineReader.h"
+#include "OrderEventFile.h"
+#include "OrderTextParser.h"
+#include "SymbolDirectory.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Converts the text order format (as typed in stdin mode, optionally with a
+// leading timestamp in nanoseconds) into a binary event file for
+// --mode=replay. Lines without a timestamp are spaced --interval-ns apart.
+int main(int argc, char* argv[]) {
+    std::string inputPath;
+    std::string outputPath;
+    std::string symbolList = "SIM";
+    int64_t intervalNs = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.substr(0, 10) == "--symbols=") {
+            symbolList = arg.substr(10);
+        } else if (arg.substr(0, 14) == "--interval-ns=") {
+            intervalNs = std::stoll(arg.substr(14));
+        } else if (arg == "--help" || arg == "-h") {
+            inputPath.clear();
+            outputPath.clear();
+            break;
+        } else if (inputPath.empty()) {
+            inputPath = arg;
+        } else {
+            outputPath = arg;
+        }
+    }
+
+    if (inputPath.empty() || outputPath.empty()) {
+        std::cout << "Usage: " << argv[0]
+                  << " <input.txt|-> <output.events> [--symbols=<a,b,...>] [--interval-ns=<n>]"
+                  << std::endl;
+        std::cout << "Line format: [timestamp_ns] <BUY|SELL> <price|MARKET> <quantity> [id] [symbol] [IOC|FOK]"
+                  << " | CANCEL <id> | MODIFY <id> <price> <quantity>" << std::endl;
+        std::cout << "Symbols must be listed in the same order as for limit_order_book" << std::endl;
+        return 1;
+    }
+
+    SymbolDirectory directory;
+    std::istringstream symbols(symbolList);
+    std::string name;
+    while (std::getline(symbols, name, ',')) {
+        if (!name.empty()) {
+            directory.add(name);
+        }
+    }
+
+    LineReader input(inputPath);
+    if (!input.isOpen()) {
+        std::cerr << "Cannot read " << inputPath << std::endl;
+        return 1;
+    }
+
+    OrderTextParser parser(directory);
+    std::vector<OrderEventRecord> records;
+    std::string_view line;
+    size_t lineNumber = 0;
+    int64_t timestampNs = 0;
+
+    while (input.next(line)) {
+        lineNumber++;
+        OrderMessage message = OrderMessage::cancel(0);
+        int64_t lineTimestamp = records.empty() ? 0 : timestampNs + intervalNs;
+
+        ParseStatus status = parser.parse(line, message, lineTimestamp);
+        if (status == ParseStatus::Quit) {
+            break;
+        }
+        if (status == ParseStatus::Error) {
+            std::cerr << inputPath << ":" << lineNumber << ": " << parser.getError() << std::endl;
+            return 1;
+        }
+        if (status == ParseStatus::Message) {
+            timestampNs = lineTimestamp;
+            records.push_back(toOrderEventRecord(message, timestampNs));
+        }
+    }
+
+    if (!writeOrderEventFile(outputPath, records)) {
+        std::cerr << "Cannot write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << records.size() << " events written to " << outputPath << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+#include "TradeTape.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Offline decoder for binary trade tapes written by TradeTape
+int main(int argc, char* argv[]) {
+    if (argc != 2 || std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h") {
+        std::cout << "Usage: " << argv[0] << " <tape-file>" << std::endl;
+        std::cout << "Prints every trade of a binary tape as text" << std::endl;
+        return argc == 2 ? 0 : 1;
+    }
+
+    std::vector<TradeRecord> records;
+    if (!readTradeTape(argv[1], records)) {
+        std::cerr << "Cannot read trade tape: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    char line[256];
+    for (const auto& record : records) {
+        size_t length = formatTradeRecord(record, line, sizeof(line));
+        std::cout.write(line, static_cast<std::streamsize>(length));
+    }
+    std::cout << records.size() << " trades" << std::endl;
+
+    return 0;
+}